@@ -55,6 +55,10 @@ namespace hub::callback {
      * wraps the printer with TimeSlice, `TimeSlice([](auto&p){std::cout << p <<
      * '\n'}, 0, 100, 10)`, then the output will be performed only at
      * p.time()=[0,100/10, 2*100/10, 3*100/10,...100].
+     * The operation is called on the integrated system at the first step boundary
+     * past each slice time. For calls at exactly the slice times, register it with
+     * `RunArgs::add_dense_operation` instead, which interpolates a copy of the system
+     * if the ode iterator provides dense output.
      * @tparam Operation Callable object.
      */
     template <typename Operation, typename Scalar>
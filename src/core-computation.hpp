@@ -30,16 +30,13 @@ License
 #include <numeric>
 #include <type_traits>
 
+#include "cpu-dispatch.hpp"
+#include "interaction/soa-kernel.hpp"
+#include "kahan-array.hpp"
 #include "macros.hpp"
 #include "math.hpp"
 #include "spacehub-concepts.hpp"
 #include "vector/vector3.hpp"
-
-#ifdef __AVX__
-
-#include <x86intrin.h>
-
-#endif
 /**
  * @namespace hub::calc
  * Documentation for hub
@@ -158,12 +155,7 @@ namespace hub::calc {
     template <typename Array, typename... Args>
     void array_add(Array &dst, Args const &...args) {
         size_t const size = dst.size();
-
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = (args[i] + ...);
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = (args[i] + ...); });
     }
 
     CREATE_MEMBER_CHECK(err);
@@ -175,7 +167,13 @@ namespace hub::calc {
 
     template <typename A1, typename A2>
     void array_load_err(A1 &dst, A2 const &src) {
-        if constexpr (HAS_MEMBER(typename A1::value_type, err)) {
+        if constexpr (is_kahan_array_v<A1>) {
+            size_t size = dst.size();
+            auto *err = dst.err_data();
+            for (size_t i = 0; i < size; ++i) {
+                err[i] = src[i];
+            }
+        } else if constexpr (HAS_MEMBER(typename A1::value_type, err)) {
             size_t size = dst.size();
             for (size_t i = 0; i < size; ++i) {
                 dst[i].err = src[i];
@@ -193,7 +191,13 @@ namespace hub::calc {
 
     template <typename A1, typename A2>
     void array_save_err(A1 &dst, A2 const &src) {
-        if constexpr (HAS_MEMBER(typename A2::value_type, err)) {
+        if constexpr (is_kahan_array_v<A2>) {
+            size_t size = dst.size();
+            auto const *err = src.err_data();
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = err[i];
+            }
+        } else if constexpr (HAS_MEMBER(typename A2::value_type, err)) {
             size_t size = dst.size();
             for (size_t i = 0; i < size; ++i) {
                 dst[i] = src[i].err;
@@ -211,7 +215,9 @@ namespace hub::calc {
 
     template <typename A1, typename A2>
     void array_copy_err(A1 &dst, A2 const &src) {
-        if constexpr (HAS_MEMBER(typename A2::value_type, err)) {
+        if constexpr (is_kahan_array_v<A1> && is_kahan_array_v<A2>) {
+            std::copy(src.err_data(), src.err_data() + dst.size(), dst.err_data());
+        } else if constexpr (HAS_MEMBER(typename A2::value_type, err)) {
             size_t size = dst.size();
             for (size_t i = 0; i < size; ++i) {
                 dst[i].err = src[i].err;
@@ -229,7 +235,9 @@ namespace hub::calc {
 
     template <typename A1>
     void array_set_err_zero(A1 &dst) {
-        if constexpr (HAS_MEMBER(typename A1::value_type, err)) {
+        if constexpr (is_kahan_array_v<A1>) {
+            std::fill(dst.err_data(), dst.err_data() + dst.size(), 0);
+        } else if constexpr (HAS_MEMBER(typename A1::value_type, err)) {
             size_t size = dst.size();
             for (size_t i = 0; i < size; ++i) {
                 dst[i].err = 0;
@@ -262,11 +270,7 @@ namespace hub::calc {
 
         // std::transform(a.begin(), a.end(), dst.begin(), [=](auto x) { return scale * x; });
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = a[i] * scale;
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = a[i] * scale; });
     }
 
     template <typename Array1, typename Array2, typename Array3, typename Scalar>
@@ -284,11 +288,7 @@ namespace hub::calc {
         DEBUG_MODE_ASSERT(b.size() == a.size() || dst.size() >= a.size(), "length of the array mismatch!");
         // std::transform(a.begin(), a.end(), dst.begin(), [=](auto x) { return x / scale; });
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = a[i] / scale;
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = a[i] / scale; });
     }
 
     /**
@@ -306,11 +306,7 @@ namespace hub::calc {
     template <typename Array, typename... Args>
     void array_mul(Array &dst, Args const &...args) {
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = (args[i] * ...);
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = (args[i] * ...); });
     }
 
     template <typename Array1, typename Array2, typename Array3>
@@ -318,11 +314,7 @@ namespace hub::calc {
         // DEBUG_MODE_ASSERT(b.size() == a.size() || dst.size() >= a.size(), "length of the array mismatch!");
         // std::transform(a.begin(), a.end(), b.begin(), dst.begin(), [](auto x, auto y) { return x - y; });
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = a[i] - b[i];
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = a[i] - b[i]; });
     }
 
     template <typename Array1, typename Array2, typename Array3, typename Scalar>
@@ -334,11 +326,7 @@ namespace hub::calc {
     void array_div(Array1 &dst, Array2 const &a, Array3 const &b) {
         // DEBUG_MODE_ASSERT(b.size() == a.size() || dst.size() >= a.size(), "length of the array mismatch!");
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = a[i] / b[i];
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = a[i] / b[i]; });
     }
 
     template <typename Array>
@@ -355,67 +343,133 @@ namespace hub::calc {
     template <typename Array1, typename Array2>
     void array_advance(Array1 &var, Array2 const &increment) {
         size_t const size = var.size();
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            var[i] += increment[i];
-        }
+        cpu::for_each_index(size, [&](size_t i) { var[i] += increment[i]; });
     }
 
     template <typename Scalar, typename Array1, typename Array2>
     void array_advance(Array1 &var, Array2 const &increment, Scalar step_size) {
         size_t const size = var.size();
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            var[i] += increment[i] * step_size;
-        }
+        cpu::for_each_index(size, [&](size_t i) { var[i] += increment[i] * step_size; });
     }
 
     template <typename Scalar, typename Array1, typename Array2, typename Array3>
     void array_advance(Array1 &dst, Array2 const &var, Array3 const &increment, Scalar step_size) {
         size_t const size = var.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = var[i] + increment[i] * step_size;
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = var[i] + increment[i] * step_size; });
     }
 
     template <typename Array1, typename Array2>
     void array_retreat(Array1 &var, Array2 const &increment) {
         size_t const size = var.size();
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            var[i] -= increment[i];
-        }
+        cpu::for_each_index(size, [&](size_t i) { var[i] -= increment[i]; });
     }
 
     template <typename Scalar, typename Array1, typename Array2>
     void array_retreat(Array1 &var, Array2 const &increment, Scalar step_size) {
         size_t const size = var.size();
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            var[i] -= increment[i] * step_size;
-        }
+        cpu::for_each_index(size, [&](size_t i) { var[i] -= increment[i] * step_size; });
     }
 
     template <typename Scalar, typename Array1, typename Array2, typename Array3>
     void array_retreat(Array1 &dst, Array2 const &var, Array3 const &increment, Scalar step_size) {
         size_t const size = var.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; i++) {
-            dst[i] = var[i] - increment[i] * step_size;
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = var[i] - increment[i] * step_size; });
+    }
+
+    /*---------------------------------------------------------------------------*\
+         KahanArray overloads
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Set the values and the compensations of a `KahanArray` to 0.
+     */
+    template <typename T>
+    void array_set_zero(KahanArray<T> &array) {
+        std::fill(array.real_data(), array.real_data() + array.size(), T{0});
+        std::fill(array.err_data(), array.err_data() + array.size(), T{0});
+    }
+
+    /**
+     * @brief Element wise addition into a `KahanArray`. As the assignment of a sum to a `Kahan` number, the
+     * compensations are reset.
+     */
+    template <typename T, typename... Args>
+    void array_add(KahanArray<T> &dst, Args const &...args) {
+        size_t const size = dst.size();
+        T *real = dst.real_data();
+        T *err = dst.err_data();
+        cpu::for_each_index(size, [&](size_t i) {
+            real[i] = (static_cast<T>(args[i]) + ...);
+            err[i] = 0;
+        });
+    }
+
+    /**
+     * @brief Element wise scale into a `KahanArray`. As the assignment of a product to a `Kahan` number, the
+     * compensations are reset.
+     */
+    template <typename T, typename Array2, typename Scalar>
+    void array_scale(KahanArray<T> &dst, Array2 const &a, Scalar scale) {
+        size_t const size = dst.size();
+        T *real = dst.real_data();
+        T *err = dst.err_data();
+        cpu::for_each_index(size, [&](size_t i) {
+            real[i] = static_cast<T>(a[i]) * scale;
+            err[i] = 0;
+        });
+    }
+
+    /**
+     * @brief Kahan compensated `var[i] += increment[i]` over the value and compensation streams.
+     */
+    template <typename T, typename Array2>
+    void array_advance(KahanArray<T> &var, Array2 const &increment) {
+        size_t const size = var.size();
+        T *real = var.real_data();
+        T *err = var.err_data();
+        cpu::for_each_index(size, [&](size_t i) {
+            T const add = static_cast<T>(increment[i]) - err[i];
+            T const sum = real[i] + add;
+            err[i] = (sum - real[i]) - add;
+            real[i] = sum;
+        });
+    }
+
+    /**
+     * @brief Kahan compensated `var[i] += increment[i] * step_size` over the value and compensation streams.
+     */
+    template <typename T, typename Array2, typename Scalar>
+    void array_advance(KahanArray<T> &var, Array2 const &increment, Scalar step_size) {
+        size_t const size = var.size();
+        T *real = var.real_data();
+        T *err = var.err_data();
+        cpu::for_each_index(size, [&](size_t i) {
+            T const inc = static_cast<T>(increment[i]) * step_size;
+            T const add = inc - err[i];
+            T const sum = real[i] + add;
+            err[i] = (sum - real[i]) - add;
+            real[i] = sum;
+        });
+    }
+
+    /**
+     * @brief `dst[i] = var[i] + increment[i] * step_size` into a `KahanArray`. As the assignment of a sum to a
+     * `Kahan` number, the compensations are reset.
+     */
+    template <typename T, typename Array2, typename Array3, typename Scalar>
+    void array_advance(KahanArray<T> &dst, Array2 const &var, Array3 const &increment, Scalar step_size) {
+        size_t const size = var.size();
+        T *real = dst.real_data();
+        T *err = dst.err_data();
+        cpu::for_each_index(size, [&](size_t i) {
+            real[i] = static_cast<T>(var[i]) + static_cast<T>(increment[i]) * step_size;
+            err[i] = 0;
+        });
     }
 
     template <typename Array, typename VectorArray1, typename VectorArray2>
     void coord_dot(Array &dst, VectorArray1 const &a, VectorArray2 const &b) {
         size_t const size = dst.size();
-//#pragma omp parallel for
-#pragma GCC ivdep
-        for (size_t i = 0; i < size; ++i) {
-            dst[i] = dot(a[i], b[i]);
-        }
+        cpu::for_each_index(size, [&](size_t i) { dst[i] = dot(a[i], b[i]); });
     }
 
     template <typename Array, typename VectorArray1, typename VectorArray2>
@@ -474,6 +528,10 @@ namespace hub::calc {
 
     CREATE_METHOD_CHECK(index);
 
+    CREATE_METHOD_CHECK(chain_ordered);
+
+    CREATE_METHOD_CHECK(cached_potential);
+
     CREATE_METHOD_CHECK(omega);
 
     CREATE_METHOD_CHECK(bindE);
@@ -492,9 +550,22 @@ namespace hub::calc {
         return potential_eng / norm(particle1.pos - particle2.pos);
     }
 
+    /**
+     * @brief Calculate the newtonian potential energy of a particle system.
+     *
+     * If the system keeps the potential energy evaluated as a by-product of its last force pass and the positions
+     * have not been advanced since (see e.g. `SimpleSystem::potential_cached()`), that value is returned without a
+     * new pair loop.
+     */
     template <CONCEPT_PARTICLES_DATA Particles>
     auto calc_potential_energy(Particles const &particles) -> typename Particles::Scalar {
-        typename Particles::Scalar potential_eng{0};
+        using Scalar = typename Particles::Scalar;
+        if constexpr (HAS_METHOD(Particles, cached_potential)) {
+            if (particles.potential_cached()) {
+                return particles.cached_potential();
+            }
+        }
+        Scalar potential_eng{0};
         size_t const size = particles.number();
         auto const &m = particles.mass();
         auto const &p = particles.pos();
@@ -512,6 +583,35 @@ namespace hub::calc {
                 potential_eng -= m[idx[i]] * m[idx[i + 2]] / norm(dr);
             }
 
+            if constexpr (HAS_METHOD(Particles, chain_ordered)) {
+                using Vector = typename Particles::Vector;
+                auto const &o = particles.chain_ordered();
+                if (o.size() == size) {
+                    if constexpr (std::is_floating_point_v<Scalar>) {
+                        if (size > force::kernel::soa_threshold) {
+                            static thread_local force::kernel::SoAScratch<Scalar> scratch;
+                            scratch.load(o);
+                            return (potential_eng + force::kernel::newtonian_pair_pot(scratch, 3)) * consts::G;
+                        }
+                    }
+                    for (size_t i = 0; i < size; ++i) {
+                        for (size_t j = i + 3; j < size; ++j) {
+                            Vector dr{o.x[j] - o.x[i], o.y[j] - o.y[i], o.z[j] - o.z[i]};
+                            potential_eng -= o.m[i] * o.m[j] / norm(dr);
+                        }
+                    }
+                    return potential_eng * consts::G;
+                }
+            }
+
+            if constexpr (std::is_floating_point_v<Scalar>) {
+                if (size > force::kernel::soa_threshold) {
+                    static thread_local force::kernel::SoAScratch<Scalar> scratch;
+                    scratch.gather(p, m, idx);
+                    return (potential_eng + force::kernel::newtonian_pair_pot(scratch, 3)) * consts::G;
+                }
+            }
+
             for (size_t i = 0; i < size; ++i) {
                 for (size_t j = i + 3; j < size; ++j) {
                     decltype(p[idx[j]]) dr = p[idx[j]] - p[idx[i]];
@@ -519,6 +619,14 @@ namespace hub::calc {
                 }
             }
         } else {
+            if constexpr (std::is_floating_point_v<Scalar>) {
+                if (size > force::kernel::soa_threshold) {
+                    static thread_local force::kernel::SoAScratch<Scalar> scratch;
+                    scratch.gather(p, m);
+                    return force::kernel::newtonian_pair_pot(scratch) * consts::G;
+                }
+            }
+
             for (size_t i = 0; i < size; ++i)
                 for (size_t j = i + 1; j < size; ++j) {
                     decltype(p[i]) dr = p[i] - p[j];
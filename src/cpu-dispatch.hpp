@@ -0,0 +1,169 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file cpu-dispatch.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * Runtime selection of the SIMD code paths.
+ *
+ * With GCC or Clang on x86, and unless `SPACEHUB_NO_CPU_DISPATCH` is defined, the hand-written SoA kernels are
+ * compiled in AVX2 and AVX-512 variants next to the baseline(SSE2) code, whatever the `-m` flags of the build are. The
+ * variant is chosen by `hub::cpu::isa()`, detected once with `__builtin_cpu_supports`. The plain loops of
+ * `hub::cpu::for_each_index` are multiversioned with `target_clones` where the toolchain supports ifunc, so the
+ * loader picks the clone once at startup. One binary then runs on every node of a heterogeneous cluster and takes
+ * the widest path each node has.
+ *
+ * The element-wise loops are cloned with floating point contraction off, since AVX-512F carries its own FMA, so they
+ * give the same results bit for bit on every path. The SIMD pair kernels sum in a different order on each path and
+ * agree to rounding only.
+ *
+ * Without dispatch the kernels fall back to the compile time selection by `__AVX512F__` and `__AVX__`.
+ */
+#if !defined(SPACEHUB_NO_CPU_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define SPACEHUB_CPU_DISPATCH 1
+#endif
+
+#if defined(SPACEHUB_CPU_DISPATCH)
+#define SPACEHUB_TARGET_AVX2 __attribute__((target("avx2")))
+#define SPACEHUB_TARGET_AVX512 __attribute__((target("avx512f")))
+#define SPACEHUB_AVX2_KERNEL 1
+#define SPACEHUB_AVX512_KERNEL 1
+#else
+#define SPACEHUB_TARGET_AVX2
+#define SPACEHUB_TARGET_AVX512
+#if defined(__AVX__)
+#define SPACEHUB_AVX2_KERNEL 1
+#endif
+#if defined(__AVX512F__)
+#define SPACEHUB_AVX512_KERNEL 1
+#endif
+#endif
+
+#if defined(SPACEHUB_CPU_DISPATCH) && defined(__GNUC__) && !defined(__clang__) && defined(__ELF__)
+#define SPACEHUB_MULTIVERSION \
+    __attribute__((target_clones("default", "avx2", "avx512f"), optimize("fp-contract=off")))
+#else
+#define SPACEHUB_MULTIVERSION
+#endif
+
+#if defined(SPACEHUB_AVX2_KERNEL) || defined(SPACEHUB_AVX512_KERNEL)
+#include <immintrin.h>
+#endif
+
+/**
+ * @namespace hub::cpu
+ * Documentation for hub
+ */
+namespace hub::cpu {
+    /**
+     * @brief Instruction set levels of the SIMD code paths, in increasing order.
+     */
+    enum class Isa { SSE2, AVX2, AVX512 };
+
+    /**
+     * @brief Highest instruction set level the kernels may use. Lower it to force a narrower path, e.g. to compare
+     * the paths or to reproduce a run of an older node. It does not affect the `target_clones` loops, which the
+     * loader selects.
+     */
+    inline Isa max_isa{Isa::AVX512};
+
+    /**
+     * @brief Instruction set level supported by the running CPU, detected on the first call.
+     */
+    inline Isa detected_isa() {
+        static Isa const level = [] {
+#if defined(SPACEHUB_CPU_DISPATCH)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+            if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+            return Isa::SSE2;
+#elif defined(SPACEHUB_AVX512_KERNEL)
+            return Isa::AVX512;
+#elif defined(SPACEHUB_AVX2_KERNEL)
+            return Isa::AVX2;
+#else
+            return Isa::SSE2;
+#endif
+        }();
+        return level;
+    }
+
+    /**
+     * @brief Instruction set level used by the kernels, the lower of `detected_isa()` and `max_isa`.
+     */
+    inline Isa isa() { return std::min(detected_isa(), max_isa); }
+
+    /**
+     * @brief Name of an instruction set level.
+     */
+    inline char const *isa_name(Isa level) {
+        switch (level) {
+            case Isa::AVX512:
+                return "AVX-512";
+            case Isa::AVX2:
+                return "AVX2";
+            default:
+                return "SSE2";
+        }
+    }
+
+    /**
+     * @brief Below this trip count `for_each_index` runs the loop inline, since the call into the multiversioned
+     * clone costs more than the wider instructions gain.
+     */
+    inline constexpr size_t multiversion_threshold{64};
+
+    namespace details {
+        template <typename Func>
+        SPACEHUB_MULTIVERSION void multiversion_loop(size_t size, Func &func) {
+#pragma GCC ivdep
+            for (size_t i = 0; i < size; ++i) {
+                func(i);
+            }
+        }
+    }  // namespace details
+
+    /**
+     * @brief Call `func(i)` for i in [0, size). Long loops run in the clone of the widest instruction set of the
+     * running CPU.
+     *
+     * @param[in] size Trip count.
+     * @param[in] func Loop body without dependence between iterations.
+     */
+    template <typename Func>
+    inline void for_each_index(size_t size, Func &&func) {
+        if (size < multiversion_threshold) {
+#pragma GCC ivdep
+            for (size_t i = 0; i < size; ++i) {
+                func(i);
+            }
+        } else {
+            details::multiversion_loop(size, func);
+        }
+    }
+}  // namespace hub::cpu
@@ -27,6 +27,8 @@ License
 #include <array>
 #include <iostream>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "IO.hpp"
 
@@ -62,6 +64,20 @@ namespace hub {
         (..., (args.shrink_to_fit()));
     }
 
+    /**
+     * @brief Permute every array with the same order, i.e. the new args[k] is the old args[order[k]].
+     */
+    template <typename Order, typename... Args>
+    void permute_all(Order const &order, Args &&...args) {
+        auto permute = [&order](auto &array) {
+            auto old = array;
+            for (size_t k = 0; k < order.size(); ++k) {
+                array[k] = old[order[k]];
+            }
+        };
+        (..., permute(args));
+    }
+
 #define spacehub_abort(...)                                                                          \
     do {                                                                                             \
         hub::print(std::cout, __FILE__, ": Line :", __LINE__, " within \"", __FUNCTION__, "\"\r\n"); \
@@ -78,6 +94,24 @@ namespace hub {
 
     class Empty {};
 
+    namespace details {
+        template <size_t Begin, typename Func, size_t... I>
+        inline void static_for_impl(Func &&func, std::index_sequence<I...>) {
+            (func(std::integral_constant<size_t, Begin + I>{}), ...);
+        }
+    }  // namespace details
+
+    /**
+     * @brief Fully unrolled loop `for (i = Begin; i < End; ++i) func(i)`, with i passed as
+     * `std::integral_constant<size_t, i>`.
+     */
+    template <size_t Begin, size_t End, typename Func>
+    inline void static_for(Func &&func) {
+        if constexpr (Begin < End) {
+            details::static_for_impl<Begin>(func, std::make_index_sequence<End - Begin>{});
+        }
+    }
+
     template <typename T>
     struct raw_type {
        private:
@@ -103,6 +137,15 @@ namespace hub {
 
 #define PACK(...) std::forward_as_tuple(__VA_ARGS__)
 
+/** @brief Force inlining of the small per-element bodies called in the vectorized kernels. */
+#if defined(__GNUC__) || defined(__clang__)
+#define SPACEHUB_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define SPACEHUB_FORCE_INLINE __forceinline
+#else
+#define SPACEHUB_FORCE_INLINE inline
+#endif
+
 #ifdef DEBUG
 #define DEBUG_MODE(BLOCK) BLOCK
 #else
@@ -182,6 +225,19 @@ namespace hub {
     /** The getter interface of member `MEMBER` in name of `NAME`.*/                 \
     inline typename TYPE::value_type const &NAME(size_t i) const noexcept { return MEMBER[i]; };
 
+#define SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(BASE, TYPE, NAME, INVALIDATE)                                    \
+    using BASE::NAME;                                                                                          \
+    /** The setter interface of `BASE::NAME`, runs `INVALIDATE` first as the caller may change the array.*/    \
+    inline TYPE &NAME() noexcept {                                                                             \
+        INVALIDATE;                                                                                            \
+        return BASE::NAME();                                                                                   \
+    };                                                                                                         \
+    /** The setter interface of `BASE::NAME`, runs `INVALIDATE` first as the caller may change the element.*/  \
+    inline typename TYPE::value_type &NAME(size_t i) noexcept {                                                \
+        INVALIDATE;                                                                                            \
+        return BASE::NAME(i);                                                                                  \
+    };
+
 #define SPACEHUB_ARRAY_READ_ACCESSOR(TYPE, NAME, MEMBER)             \
     /** The getter interface of member `MEMBER` in name of `NAME`.*/ \
     inline TYPE const &NAME() const noexcept { return MEMBER; };     \
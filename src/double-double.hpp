@@ -0,0 +1,759 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file double-double.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+/**
+ * @namespace hub::dd
+ * Double-double arithmetic. The math functions live next to the type and are found by argument dependent lookup, so
+ * they never shadow the double overloads in `hub`.
+ */
+namespace hub::dd {
+    /** Double-double number
+     *
+     *  An unevaluated sum hi + lo of two doubles with |lo| <= ulp(hi)/2, about 106 bits of significand. The
+     *  arithmetic is built on the error-free transformations two_sum and two_prod(a single FMA if the target has
+     *  one, Dekker's split otherwise), so it costs a few double operations, allocates nothing and keeps the
+     *  exponent range of double. See details in [QD library](https://www.davidhbailey.com/dhbsoftware/).
+     *
+     *  Unlike `Kahan`, which only compensates the accumulation of the state, every operation and every math
+     *  function(sqrt, exp, log, pow, the trigonometric and hyperbolic functions and their inverses) is evaluated
+     *  to double-double precision, so it is the `Scalar` of the particle system, not only the `StateScalar`.
+     */
+    struct DoubleDouble {
+       public:
+        double hi, lo;
+
+        /**
+         * Default constructor
+         */
+        DoubleDouble() = default;
+
+        /**
+         * Single parameter constructor.
+         * @param h Scalar
+         */
+        constexpr DoubleDouble(double h) : hi(h), lo(0) {}
+
+        /**
+         * Construct from an already normalized pair |l| <= ulp(h)/2.
+         */
+        constexpr DoubleDouble(double h, double l) : hi(h), lo(l) {}
+
+        /**
+         * Conversion operator. Round to the nearest double.
+         */
+        explicit constexpr operator double() const { return hi; }
+
+        /**
+         * Opposite operator.
+         */
+        friend constexpr DoubleDouble operator-(DoubleDouble const &a) { return DoubleDouble(-a.hi, -a.lo); }
+
+        friend constexpr DoubleDouble operator+(DoubleDouble const &a) { return a; }
+
+        friend inline DoubleDouble operator+(DoubleDouble const &a, DoubleDouble const &b);
+
+        friend inline DoubleDouble operator+(DoubleDouble const &a, double b);
+
+        friend inline DoubleDouble operator+(double a, DoubleDouble const &b) { return b + a; }
+
+        friend inline DoubleDouble operator-(DoubleDouble const &a, DoubleDouble const &b) { return a + (-b); }
+
+        friend inline DoubleDouble operator-(DoubleDouble const &a, double b) { return a + (-b); }
+
+        friend inline DoubleDouble operator-(double a, DoubleDouble const &b) { return (-b) + a; }
+
+        friend inline DoubleDouble operator*(DoubleDouble const &a, DoubleDouble const &b);
+
+        friend inline DoubleDouble operator*(DoubleDouble const &a, double b);
+
+        friend inline DoubleDouble operator*(double a, DoubleDouble const &b) { return b * a; }
+
+        friend inline DoubleDouble operator/(DoubleDouble const &a, DoubleDouble const &b);
+
+        friend inline DoubleDouble operator/(DoubleDouble const &a, double b);
+
+        friend inline DoubleDouble operator/(double a, DoubleDouble const &b) { return DoubleDouble(a) / b; }
+
+        template <typename U>
+        friend inline DoubleDouble &operator+=(DoubleDouble &lhs, U const &rhs) {
+            return lhs = lhs + rhs;
+        }
+
+        template <typename U>
+        friend inline DoubleDouble &operator-=(DoubleDouble &lhs, U const &rhs) {
+            return lhs = lhs - rhs;
+        }
+
+        template <typename U>
+        friend inline DoubleDouble &operator*=(DoubleDouble &lhs, U const &rhs) {
+            return lhs = lhs * rhs;
+        }
+
+        template <typename U>
+        friend inline DoubleDouble &operator/=(DoubleDouble &lhs, U const &rhs) {
+            return lhs = lhs / rhs;
+        }
+
+        friend constexpr bool operator==(DoubleDouble const &a, DoubleDouble const &b) {
+            return a.hi == b.hi && a.lo == b.lo;
+        }
+
+        friend constexpr bool operator!=(DoubleDouble const &a, DoubleDouble const &b) { return !(a == b); }
+
+        friend constexpr bool operator<(DoubleDouble const &a, DoubleDouble const &b) {
+            return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+        }
+
+        friend constexpr bool operator>(DoubleDouble const &a, DoubleDouble const &b) { return b < a; }
+
+        friend constexpr bool operator<=(DoubleDouble const &a, DoubleDouble const &b) {
+            return a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+        }
+
+        friend constexpr bool operator>=(DoubleDouble const &a, DoubleDouble const &b) { return b <= a; }
+
+        friend constexpr bool operator==(DoubleDouble const &a, double b) { return a.hi == b && a.lo == 0; }
+
+        friend constexpr bool operator==(double a, DoubleDouble const &b) { return b == a; }
+
+        friend constexpr bool operator!=(DoubleDouble const &a, double b) { return !(a == b); }
+
+        friend constexpr bool operator!=(double a, DoubleDouble const &b) { return !(b == a); }
+
+        friend constexpr bool operator<(DoubleDouble const &a, double b) {
+            return a.hi < b || (a.hi == b && a.lo < 0);
+        }
+
+        friend constexpr bool operator<(double a, DoubleDouble const &b) {
+            return a < b.hi || (a == b.hi && b.lo > 0);
+        }
+
+        friend constexpr bool operator>(DoubleDouble const &a, double b) { return b < a; }
+
+        friend constexpr bool operator>(double a, DoubleDouble const &b) { return b < a; }
+
+        friend constexpr bool operator<=(DoubleDouble const &a, double b) {
+            return a.hi < b || (a.hi == b && a.lo <= 0);
+        }
+
+        friend constexpr bool operator<=(double a, DoubleDouble const &b) {
+            return a < b.hi || (a == b.hi && b.lo >= 0);
+        }
+
+        friend constexpr bool operator>=(DoubleDouble const &a, double b) { return b <= a; }
+
+        friend constexpr bool operator>=(double a, DoubleDouble const &b) { return b <= a; }
+
+        /**
+         * Decimal representation in scientific notation with `digits` significant digits.
+         */
+        [[nodiscard]] std::string to_string(int digits = std::numeric_limits<double>::digits10 * 2) const;
+
+        /**
+         * Parse a decimal number, e.g. "3.14159265358979323846264338327950288e+00".
+         */
+        static DoubleDouble from_string(std::string const &str);
+
+        /**
+         * Output stream. Precisions beyond double are written digit by digit from the full value.
+         */
+        friend std::ostream &operator<<(std::ostream &output, DoubleDouble const &v) {
+            auto const precision = static_cast<int>(output.precision());
+            if (precision <= std::numeric_limits<double>::max_digits10 || !std::isfinite(v.hi)) {
+                output << v.hi;
+            } else {
+                output << v.to_string(precision + 1);
+            }
+            return output;
+        }
+
+        /**
+         * Input stream
+         */
+        friend std::istream &operator>>(std::istream &input, DoubleDouble &v) {
+            std::string str;
+            if (input >> str) {
+                v = from_string(str);
+            }
+            return input;
+        }
+    };
+
+    namespace details {
+        /**
+         * Error-free sum of two doubles, assuming |a| >= |b|.
+         */
+        inline DoubleDouble quick_two_sum(double a, double b) {
+            double s = a + b;
+            return DoubleDouble(s, b - (s - a));
+        }
+
+        /**
+         * Error-free sum of two doubles.
+         */
+        inline DoubleDouble two_sum(double a, double b) {
+            double s = a + b;
+            double bb = s - a;
+            return DoubleDouble(s, (a - (s - bb)) + (b - bb));
+        }
+
+        /**
+         * Error-free product of two doubles.
+         */
+        inline DoubleDouble two_prod(double a, double b) {
+            double p = a * b;
+#if defined(__FMA__) || defined(FP_FAST_FMA)
+            return DoubleDouble(p, std::fma(a, b, -p));
+#else
+            constexpr double splitter = 134217729.0;  // 2^27 + 1
+            double t = splitter * a;
+            double a_hi = t - (t - a);
+            double a_lo = a - a_hi;
+            t = splitter * b;
+            double b_hi = t - (t - b);
+            double b_lo = b - b_hi;
+            return DoubleDouble(p, ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo);
+#endif
+        }
+
+        inline constexpr DoubleDouble pi{3.141592653589793116e+00, 1.224646799147353207e-16};
+        inline constexpr DoubleDouble two_pi{6.283185307179586232e+00, 2.449293598294706414e-16};
+        inline constexpr DoubleDouble half_pi{1.570796326794896558e+00, 6.123233995736766036e-17};
+        inline constexpr DoubleDouble ln2{6.931471805599452862e-01, 2.319046813846299558e-17};
+        inline constexpr DoubleDouble ln10{2.302585092994045901e+00, -2.170756223382249351e-16};
+        inline constexpr double eps{4.93038065763132e-32};  // 2^-104
+    }  // namespace details
+
+    /*---------------------------------------------------------------------------*\
+         Arithmetic Implementation
+    \*---------------------------------------------------------------------------*/
+    inline DoubleDouble operator+(DoubleDouble const &a, DoubleDouble const &b) {
+        DoubleDouble s = details::two_sum(a.hi, b.hi);
+        DoubleDouble t = details::two_sum(a.lo, b.lo);
+        s.lo += t.hi;
+        s = details::quick_two_sum(s.hi, s.lo);
+        s.lo += t.lo;
+        return details::quick_two_sum(s.hi, s.lo);
+    }
+
+    inline DoubleDouble operator+(DoubleDouble const &a, double b) {
+        DoubleDouble s = details::two_sum(a.hi, b);
+        return details::quick_two_sum(s.hi, s.lo + a.lo);
+    }
+
+    inline DoubleDouble operator*(DoubleDouble const &a, DoubleDouble const &b) {
+        DoubleDouble p = details::two_prod(a.hi, b.hi);
+        return details::quick_two_sum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+    }
+
+    inline DoubleDouble operator*(DoubleDouble const &a, double b) {
+        DoubleDouble p = details::two_prod(a.hi, b);
+        return details::quick_two_sum(p.hi, p.lo + a.lo * b);
+    }
+
+    inline DoubleDouble operator/(DoubleDouble const &a, DoubleDouble const &b) {
+        double q1 = a.hi / b.hi;
+        DoubleDouble r = a - b * q1;
+        double q2 = r.hi / b.hi;
+        r = r - b * q2;
+        double q3 = r.hi / b.hi;
+        return details::quick_two_sum(q1, q2) + q3;
+    }
+
+    inline DoubleDouble operator/(DoubleDouble const &a, double b) {
+        double q1 = a.hi / b;
+        DoubleDouble p = details::two_prod(q1, b);
+        DoubleDouble s = details::two_sum(a.hi, -p.hi);
+        s.lo = s.lo - p.lo + a.lo;
+        double q2 = (s.hi + s.lo) / b;
+        return details::quick_two_sum(q1, q2);
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Math functions
+    \*---------------------------------------------------------------------------*/
+    inline bool isnan(DoubleDouble const &a) { return std::isnan(a.hi) || std::isnan(a.lo); }
+
+    inline bool isinf(DoubleDouble const &a) { return std::isinf(a.hi); }
+
+    inline bool isfinite(DoubleDouble const &a) { return std::isfinite(a.hi); }
+
+    inline bool signbit(DoubleDouble const &a) { return std::signbit(a.hi); }
+
+    inline DoubleDouble fabs(DoubleDouble const &a) { return a.hi < 0 ? -a : a; }
+
+    inline DoubleDouble abs(DoubleDouble const &a) { return fabs(a); }
+
+    inline DoubleDouble copysign(DoubleDouble const &a, DoubleDouble const &b) {
+        return std::signbit(a.hi) != std::signbit(b.hi) ? -a : a;
+    }
+
+    inline DoubleDouble ldexp(DoubleDouble const &a, int exp) {
+        return DoubleDouble(std::ldexp(a.hi, exp), std::ldexp(a.lo, exp));
+    }
+
+    inline DoubleDouble frexp(DoubleDouble const &a, int *exp) {
+        double hi = std::frexp(a.hi, exp);
+        return DoubleDouble(hi, std::ldexp(a.lo, -*exp));
+    }
+
+    inline DoubleDouble floor(DoubleDouble const &a) {
+        double hi = std::floor(a.hi);
+        if (hi == a.hi) {
+            return details::quick_two_sum(hi, std::floor(a.lo));
+        }
+        return DoubleDouble(hi);
+    }
+
+    inline DoubleDouble ceil(DoubleDouble const &a) {
+        double hi = std::ceil(a.hi);
+        if (hi == a.hi) {
+            return details::quick_two_sum(hi, std::ceil(a.lo));
+        }
+        return DoubleDouble(hi);
+    }
+
+    inline DoubleDouble trunc(DoubleDouble const &a) { return a.hi >= 0 ? floor(a) : ceil(a); }
+
+    inline DoubleDouble round(DoubleDouble const &a) { return a.hi >= 0 ? floor(a + 0.5) : ceil(a - 0.5); }
+
+    inline DoubleDouble fmod(DoubleDouble const &a, DoubleDouble const &b) { return a - b * trunc(a / b); }
+
+    inline DoubleDouble remainder(DoubleDouble const &a, DoubleDouble const &b) { return a - b * round(a / b); }
+
+    inline DoubleDouble modf(DoubleDouble const &a, DoubleDouble *int_part) {
+        *int_part = trunc(a);
+        return a - *int_part;
+    }
+
+    inline DoubleDouble sqr(DoubleDouble const &a) {
+        DoubleDouble p = details::two_prod(a.hi, a.hi);
+        return details::quick_two_sum(p.hi, p.lo + (2.0 * a.hi * a.lo + a.lo * a.lo));
+    }
+
+    /**
+     * Karp's trick: one Newton step on the double precision estimate x ~ 1/sqrt(a).
+     */
+    inline DoubleDouble sqrt(DoubleDouble const &a) {
+        if (a.hi <= 0) {
+            return a.hi == 0 ? DoubleDouble(0.0) : DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+        }
+        if (std::isinf(a.hi)) {
+            return a;
+        }
+        double x = 1.0 / std::sqrt(a.hi);
+        double ax = a.hi * x;
+        return details::two_sum(ax, (a - details::two_prod(ax, ax)).hi * (x * 0.5));
+    }
+
+    inline DoubleDouble cbrt(DoubleDouble const &a) {
+        if (a.hi == 0 || !std::isfinite(a.hi)) {
+            return a;
+        }
+        DoubleDouble y{std::cbrt(a.hi)};
+        return y - (y * sqr(y) - a) / (3.0 * sqr(y));
+    }
+
+    inline DoubleDouble hypot(DoubleDouble const &a, DoubleDouble const &b) { return sqrt(sqr(a) + sqr(b)); }
+
+    template <typename Int, typename = std::enable_if_t<std::is_integral_v<Int>>>
+    inline DoubleDouble pow(DoubleDouble const &a, Int n) {
+        if (n == 0) {
+            return DoubleDouble(1.0);
+        }
+        DoubleDouble r = a;
+        DoubleDouble s{1.0};
+        auto k = n < 0 ? -static_cast<long long>(n) : static_cast<long long>(n);
+        if (k > 1) {
+            while (k > 0) {
+                if (k & 1) {
+                    s = s * r;
+                }
+                k >>= 1;
+                if (k > 0) {
+                    r = sqr(r);
+                }
+            }
+        } else {
+            s = r;
+        }
+        return n < 0 ? 1.0 / s : s;
+    }
+
+    inline DoubleDouble exp(DoubleDouble const &a) {
+        constexpr int halvings = 10;
+        if (a.hi > 709.79) {
+            return DoubleDouble(std::numeric_limits<double>::infinity());
+        }
+        if (a.hi < -745.14) {
+            return DoubleDouble(0.0);
+        }
+        if (a.hi == 0) {
+            return DoubleDouble(1.0);
+        }
+        double k = std::floor(a.hi / details::ln2.hi + 0.5);
+        // exp(a) = 2^k * (1 + expm1(r * 2^-halvings))^(2^halvings)
+        DoubleDouble r = ldexp(a - details::ln2 * k, -halvings);
+        DoubleDouble p = sqr(r);
+        DoubleDouble s = r + ldexp(p, -1);
+        DoubleDouble term = ldexp(p, -1);
+        for (int i = 3; std::fabs(term.hi) > details::eps * 1e-3 * std::fabs(s.hi); ++i) {
+            term = term * r / static_cast<double>(i);
+            s = s + term;
+        }
+        for (int i = 0; i < halvings; ++i) {
+            s = ldexp(s, 1) + sqr(s);
+        }
+        return ldexp(s + 1.0, static_cast<int>(k));
+    }
+
+    /**
+     * One Newton step x + a*exp(-x) - 1 on the double precision logarithm.
+     */
+    inline DoubleDouble log(DoubleDouble const &a) {
+        if (a.hi <= 0) {
+            return a.hi == 0 ? DoubleDouble(-std::numeric_limits<double>::infinity())
+                             : DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+        }
+        if (a == 1.0) {
+            return DoubleDouble(0.0);
+        }
+        DoubleDouble x{std::log(a.hi)};
+        return x + a * exp(-x) - 1.0;
+    }
+
+    inline DoubleDouble log10(DoubleDouble const &a) { return log(a) / details::ln10; }
+
+    inline DoubleDouble log2(DoubleDouble const &a) { return log(a) / details::ln2; }
+
+    inline DoubleDouble pow(DoubleDouble const &a, DoubleDouble const &b) {
+        if (b == floor(b) && std::fabs(b.hi) < 2147483648.0) {
+            return pow(a, static_cast<int>(b.hi));
+        }
+        return exp(b * log(a));
+    }
+
+    inline DoubleDouble pow(DoubleDouble const &a, double b) { return pow(a, DoubleDouble(b)); }
+
+    inline DoubleDouble pow(double a, DoubleDouble const &b) { return pow(DoubleDouble(a), b); }
+
+    namespace details {
+        /**
+         * sin(a) and cos(a) for |a| <= pi/4.
+         */
+        inline void sincos_taylor(DoubleDouble const &a, DoubleDouble &sin_a, DoubleDouble &cos_a) {
+            if (a.hi == 0) {
+                sin_a = DoubleDouble(0.0), cos_a = DoubleDouble(1.0);
+                return;
+            }
+            DoubleDouble const x2 = -sqr(a);
+            DoubleDouble s = a;
+            DoubleDouble term = a;
+            for (int i = 2; std::fabs(term.hi) > eps * 1e-3 * std::fabs(a.hi); i += 2) {
+                term = term * x2 / static_cast<double>(i * (i + 1));
+                s = s + term;
+            }
+            sin_a = s;
+            cos_a = sqrt(1.0 - sqr(s));
+        }
+
+        /**
+         * sin(a) and cos(a), reduced to |t| <= pi/4 around the nearest multiple of pi/2.
+         */
+        inline void sincos(DoubleDouble const &a, DoubleDouble &sin_a, DoubleDouble &cos_a) {
+            if (!std::isfinite(a.hi)) {
+                sin_a = cos_a = DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+                return;
+            }
+            DoubleDouble r = a - two_pi * round(a / two_pi);
+            double j = std::floor(r.hi / half_pi.hi + 0.5);
+            DoubleDouble t = r - half_pi * j;
+            DoubleDouble s, c;
+            sincos_taylor(t, s, c);
+            switch (static_cast<int>(j)) {
+                case 0:
+                    sin_a = s, cos_a = c;
+                    break;
+                case 1:
+                    sin_a = c, cos_a = -s;
+                    break;
+                case -1:
+                    sin_a = -c, cos_a = s;
+                    break;
+                default:
+                    sin_a = -s, cos_a = -c;
+                    break;
+            }
+        }
+    }  // namespace details
+
+    inline DoubleDouble sin(DoubleDouble const &a) {
+        DoubleDouble s, c;
+        details::sincos(a, s, c);
+        return s;
+    }
+
+    inline DoubleDouble cos(DoubleDouble const &a) {
+        DoubleDouble s, c;
+        details::sincos(a, s, c);
+        return c;
+    }
+
+    inline DoubleDouble tan(DoubleDouble const &a) {
+        DoubleDouble s, c;
+        details::sincos(a, s, c);
+        return s / c;
+    }
+
+    /**
+     * One Newton step on the double precision angle of the normalized point (x, y).
+     */
+    inline DoubleDouble atan2(DoubleDouble const &y, DoubleDouble const &x) {
+        if (x.hi == 0) {
+            if (y.hi == 0) {
+                return DoubleDouble(std::atan2(y.hi, x.hi));
+            }
+            return y.hi > 0 ? details::half_pi : -details::half_pi;
+        }
+        if (y.hi == 0) {
+            return x.hi > 0 ? DoubleDouble(0.0) : (std::signbit(y.hi) ? -details::pi : details::pi);
+        }
+        DoubleDouble const r = sqrt(sqr(x) + sqr(y));
+        DoubleDouble const xx = x / r;
+        DoubleDouble const yy = y / r;
+        DoubleDouble z{std::atan2(y.hi, x.hi)};
+        DoubleDouble sin_z, cos_z;
+        details::sincos(z, sin_z, cos_z);
+        if (std::fabs(xx.hi) > std::fabs(yy.hi)) {
+            return z + (yy - sin_z) / cos_z;
+        } else {
+            return z - (xx - cos_z) / sin_z;
+        }
+    }
+
+    inline DoubleDouble atan(DoubleDouble const &a) { return atan2(a, DoubleDouble(1.0)); }
+
+    inline DoubleDouble asin(DoubleDouble const &a) {
+        if (std::fabs(a.hi) > 1) {
+            return DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+        }
+        return atan2(a, sqrt((1.0 - a) * (1.0 + a)));
+    }
+
+    inline DoubleDouble acos(DoubleDouble const &a) {
+        if (std::fabs(a.hi) > 1) {
+            return DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+        }
+        return atan2(sqrt((1.0 - a) * (1.0 + a)), a);
+    }
+
+    inline DoubleDouble sinh(DoubleDouble const &a) {
+        if (std::fabs(a.hi) > 0.05) {
+            DoubleDouble e = exp(a);
+            return ldexp(e - 1.0 / e, -1);
+        }
+        DoubleDouble const x2 = sqr(a);
+        DoubleDouble s = a;
+        DoubleDouble term = a;
+        for (int i = 2; std::fabs(term.hi) > details::eps * 1e-3 * std::fabs(a.hi); i += 2) {
+            term = term * x2 / static_cast<double>(i * (i + 1));
+            s = s + term;
+        }
+        return s;
+    }
+
+    inline DoubleDouble cosh(DoubleDouble const &a) {
+        DoubleDouble e = exp(a);
+        return ldexp(e + 1.0 / e, -1);
+    }
+
+    inline DoubleDouble tanh(DoubleDouble const &a) {
+        if (std::fabs(a.hi) > 40) {
+            return DoubleDouble(a.hi > 0 ? 1.0 : -1.0);
+        }
+        return sinh(a) / cosh(a);
+    }
+
+    inline DoubleDouble asinh(DoubleDouble const &a) {
+        DoubleDouble const x = fabs(a);
+        DoubleDouble const r = log(x + sqrt(sqr(x) + 1.0));
+        return a.hi < 0 ? -r : r;
+    }
+
+    inline DoubleDouble acosh(DoubleDouble const &a) {
+        if (a.hi < 1) {
+            return DoubleDouble(std::numeric_limits<double>::quiet_NaN());
+        }
+        return log(a + sqrt(sqr(a) - 1.0));
+    }
+
+    inline DoubleDouble atanh(DoubleDouble const &a) {
+        if (std::fabs(a.hi) >= 1) {
+            return DoubleDouble(std::fabs(a.hi) == 1 ? std::copysign(std::numeric_limits<double>::infinity(), a.hi)
+                                                      : std::numeric_limits<double>::quiet_NaN());
+        }
+        return ldexp(log((1.0 + a) / (1.0 - a)), -1);
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Decimal conversion Implementation
+    \*---------------------------------------------------------------------------*/
+    inline std::string DoubleDouble::to_string(int digits) const {
+        if (!std::isfinite(hi)) {
+            return std::to_string(hi);
+        }
+        digits = std::max(digits, 1);
+        if (hi == 0) {
+            return std::string(std::signbit(hi) ? "-0" : "0") + (digits > 1 ? "." + std::string(digits - 1, '0') : "") +
+                   "e+00";
+        }
+        DoubleDouble r = fabs(*this);
+        int e = static_cast<int>(std::floor(std::log10(r.hi)));
+        r = e >= 0 ? r / pow(DoubleDouble(10.0), e) : r * pow(DoubleDouble(10.0), -e);
+        if (r >= 10.0) {
+            r = r / 10.0, ++e;
+        } else if (r < 1.0) {
+            r = r * 10.0, --e;
+        }
+
+        std::string d(static_cast<size_t>(digits) + 1, '0');
+        for (auto &c : d) {
+            int digit = static_cast<int>(std::floor(r.hi));
+            digit = digit < 0 ? 0 : (digit > 9 ? 9 : digit);
+            c = static_cast<char>('0' + digit);
+            r = (r - static_cast<double>(digit)) * 10.0;
+        }
+        // round the extra digit away and propagate the carry
+        bool carry = d.back() >= '5';
+        d.pop_back();
+        for (auto it = d.rbegin(); carry && it != d.rend(); ++it) {
+            carry = *it == '9';
+            *it = carry ? '0' : static_cast<char>(*it + 1);
+        }
+        if (carry) {
+            d.insert(d.begin(), '1'), d.pop_back(), ++e;
+        }
+
+        std::string str = hi < 0 ? "-" : "";
+        str += d[0];
+        if (digits > 1) {
+            str += '.';
+            str.append(d, 1, std::string::npos);
+        }
+        std::string exp = std::to_string(e < 0 ? -e : e);
+        str += e < 0 ? "e-" : "e+";
+        str += exp.size() < 2 ? "0" + exp : exp;
+        return str;
+    }
+
+    inline DoubleDouble DoubleDouble::from_string(std::string const &str) {
+        DoubleDouble r{0.0};
+        size_t pos = 0;
+        bool negative = false;
+        if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+            negative = str[pos++] == '-';
+        }
+        int scale = 0;
+        bool has_digit = false;
+        bool after_point = false;
+        for (; pos < str.size(); ++pos) {
+            char c = str[pos];
+            if (c >= '0' && c <= '9') {
+                r = r * 10.0 + static_cast<double>(c - '0');
+                scale -= after_point ? 1 : 0;
+                has_digit = true;
+            } else if (c == '.' && !after_point) {
+                after_point = true;
+            } else {
+                break;
+            }
+        }
+        if (!has_digit) {
+            return DoubleDouble(std::strtod(str.c_str(), nullptr));
+        }
+        if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')) {
+            scale += std::stoi(str.substr(pos + 1));
+        }
+        if (scale > 0) {
+            r = r * pow(DoubleDouble(10.0), scale);
+        } else if (scale < 0) {
+            r = r / pow(DoubleDouble(10.0), -scale);
+        }
+        return negative ? -r : r;
+    }
+}  // namespace hub::dd
+
+namespace hub {
+    using dd_real = dd::DoubleDouble;
+}  // namespace hub
+
+namespace std {
+    template <>
+    class numeric_limits<hub::dd::DoubleDouble> : public numeric_limits<double> {
+       public:
+        static constexpr int digits = 2 * numeric_limits<double>::digits;
+        static constexpr int digits10 = 31;
+        static constexpr int max_digits10 = 33;
+
+        static constexpr hub::dd::DoubleDouble epsilon() noexcept {
+            return hub::dd::DoubleDouble(hub::dd::details::eps);
+        }
+
+        static constexpr hub::dd::DoubleDouble round_error() noexcept { return hub::dd::DoubleDouble(0.5); }
+
+        static constexpr hub::dd::DoubleDouble min() noexcept {
+            return hub::dd::DoubleDouble(2.0041683600089728e-292);
+        }
+
+        static constexpr hub::dd::DoubleDouble max() noexcept {
+            return hub::dd::DoubleDouble(1.79769313486231570815e+308, 9.97920154767359795037e+291);
+        }
+
+        static constexpr hub::dd::DoubleDouble lowest() noexcept { return -max(); }
+
+        static constexpr hub::dd::DoubleDouble infinity() noexcept {
+            return hub::dd::DoubleDouble(numeric_limits<double>::infinity());
+        }
+
+        static constexpr hub::dd::DoubleDouble quiet_NaN() noexcept {
+            return hub::dd::DoubleDouble(numeric_limits<double>::quiet_NaN());
+        }
+
+        static constexpr hub::dd::DoubleDouble signaling_NaN() noexcept {
+            return hub::dd::DoubleDouble(numeric_limits<double>::signaling_NaN());
+        }
+
+        static constexpr hub::dd::DoubleDouble denorm_min() noexcept { return min(); }
+    };
+}  // namespace std
@@ -24,6 +24,7 @@ License
  */
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
@@ -130,6 +131,47 @@ namespace hub::integrator {
         template <typename Tab1, typename Tab2>
         static void transform_b2g(Tab1 const &B, Tab2 &G);
 
+        /**
+         * @brief Update the G table at a stage from the derivatives at the start and at the stage(equation 4), and
+         * the B table from the change of G(equation 5).
+         *
+         * @param[in,out] G G table.
+         * @param[in,out] B B table.
+         * @param[out] dg Change of G at the stage.
+         * @param[in] y_init Derivatives at the start of the step.
+         * @param[in] y_now Derivatives at the stage.
+         * @param[in] stage Index of the stage.
+         * @param[in] size Number of the derivatives.
+         */
+        template <typename Tab, typename Array, typename T>
+        static void update_b_table(Tab &G, Tab &B, Array &dg, T const *y_init, T const *y_now, size_t stage,
+                                   size_t size);
+
+        /**
+         * @brief Predict the B table of the next step from the B table of the last step(equation 13), corrected by
+         * the difference between the last B table and its prediction, and update the G table.
+         *
+         * @param[in,out] B B table.
+         * @param[in,out] old_B Prediction of the B table.
+         * @param[out] G G table.
+         * @param[out] tmp Scratch array.
+         * @param[in] step_ratio Ratio of the next step size to the last.
+         */
+        template <typename Tab, typename Array, typename Scalar>
+        static void predict(Tab &B, Tab &old_B, Tab &G, Array &tmp, Scalar step_ratio);
+
+        /**
+         * @brief Permute the components of the tables carried over to the next step, the new component k is the old
+         * component order[k].
+         *
+         * @param[in] order Order of the components.
+         * @param[in,out] B B table.
+         * @param[in,out] old_B Prediction of the B table.
+         * @param[in,out] G G table.
+         */
+        template <typename Tab>
+        static void permute(std::vector<size_t> const &order, Tab &B, Tab &old_B, Tab &G);
+
        private:
         static constexpr double h_[8] = {0.0562625605369221464656521910318, 0.180240691736892364987579942780,
                                          0.352624717113169637373907769648,  0.547153626330555383001448554766,
@@ -238,6 +280,7 @@ namespace hub::integrator {
 
         static constexpr size_t order{15};
         static constexpr size_t final_point{7};
+        static constexpr bool second_order{false};
 
         GaussRadau();
 
@@ -266,21 +309,213 @@ namespace hub::integrator {
         template <typename ParticleSys>
         void integrate(ParticleSys &particles, Scalar step_size);
 
+        /**
+         * @brief Permute the particles in the tables carried over to the next step, after the particle system
+         * reordered its storage(see `system::SimpleSystem::reorder_delta`).
+         *
+         * @param[in] particles Particle system in the new order.
+         * @param[in] order Particle k is particle order[k] of the last step.
+         */
+        template <typename ParticleSys>
+        void permute(ParticleSys const &particles, std::vector<size_t> const &order);
+
+        /**
+         * @brief Keep the B table, the initial state and the initial derivatives of the step for `interpolate`. Call
+         * it after `correct` and before `predict` of an accepted step.
+         *
+         * @param[in] step_size Step size of the step.
+         */
+        void save_step(Scalar step_size);
+
+        /**
+         * @brief Evaluate the polynomial of the B table of the saved step at a fraction of the step, the same way as
+         * `integrate_to` does at the Radau nodes, and load the state into the particle system.
+         *
+         * @param[out] particles Particle system to load the state into.
+         * @param[in] fraction Fraction of the saved step, in [0, 1].
+         */
+        template <typename ParticleSys>
+        void interpolate(ParticleSys &particles, Scalar fraction);
+
+        /**
+         * @brief Evaluate one component of the polynomial of the saved step.
+         *
+         * @param[in] i Index of the component in the state array.
+         * @param[in] fraction Fraction of the saved step.
+         * @param[out] derivative Derivative of the component with respect to the fraction.
+         * @return The component at the fraction.
+         */
+        StateScalar interpolate_component(size_t i, Scalar fraction, Scalar &derivative) const;
+
+        SPACEHUB_READ_ACCESSOR(StateScalarArray, saved_y0, step_y0_);
+
        private:
-        void update_b_table(ScalarArray const &y_init, ScalarArray const &y_now, size_t stage);
+        /**
+         * @brief Advance the state `y0` by the expansion to a fraction of the step, into `tmp_state_`.
+         */
+        void advance(IterTable const &b, ScalarArray const &dydh0, StateScalarArray const &y0, Scalar step_size,
+                     Scalar fraction);
+
+        /**
+         * @brief Increment h * (dydh0 * s + b0 * s^2 / 2 + ... + b6 * s^8 / 8) of the i-th component.
+         */
+        static Scalar increment(IterTable const &b, size_t i, Scalar dydh0, Scalar step_size, Scalar s);
+
+        IterTable b_;
+        IterTable g_;
+        IterTable old_b_;
+
+        ScalarArray dydh0_{0};
+        ScalarArray dydh_{0};
+        ScalarArray tmp_array_{0};
+        ScalarArray dg_array_{0};
+        StateScalarArray tmp_state_{0};
+        StateScalarArray input_{0};
+        size_t var_num_{0};
+
+        IterTable step_b_;
+        ScalarArray step_dydh0_{0};
+        StateScalarArray step_y0_{0};
+        Scalar step_h_{0};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class GaussRadau2nd Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * Gauss Radau stepping method in the second order form of IAS15, see details in https://arxiv.org/abs/1409.4779 .
+     *
+     * Only the accelerations are expanded in the B table; the positions and the velocities are the first and second
+     * integrals of the expansion. The B and G tables hold the 3N accelerations instead of the whole state(time,
+     * positions, velocities and auxiliary velocities) of `GaussRadau`, which takes less than half of the memory and
+     * of the arithmetic per predictor-corrector iteration.
+     *
+     * The particle system must be integrated in the physical time, with the positions and the velocities in the
+     * state array, e.g. `SimpleSystem` and `ChainSystem`. Regularized systems are not supported.
+     *
+     * @tparam TypeSystem
+     */
+    template <typename TypeSystem>
+    class GaussRadau2nd {
+       public:
+        SPACEHUB_USING_TYPE_SYSTEM_OF(TypeSystem);
+
+        using IterTable = std::array<ScalarArray, 7>;
+
+        static constexpr size_t order{15};
+        static constexpr size_t final_point{7};
+        static constexpr bool second_order{true};
+
+        GaussRadau2nd();
+
+        SPACEHUB_READ_ACCESSOR(IterTable, b, b_);
+
+        SPACEHUB_READ_ACCESSOR(ScalarArray, dy_h, acc_);  // accelerations at the last stage
+
+        SPACEHUB_READ_ACCESSOR(StateScalarArray, y_h, input_);
+
+        SPACEHUB_READ_ACCESSOR(ScalarArray, diff_b6, dg_array_);  // after correct
+
+        SPACEHUB_READ_ACCESSOR(StateScalarArray, saved_y0, step_y0_);
+
+        template <typename ParticleSys>
+        void correct(ParticleSys &particles, Scalar step_size);
+
+        void predict(Scalar step_ratio);
+
+        template <typename ParticleSys>
+        void integrate_to(ParticleSys &particles, Scalar step_size, size_t stage);
+
+        template <typename ParticleSys>
+        void evaluate(ParticleSys &particles, Scalar step_size);
+
+        template <typename ParticleSys>
+        void integrate(ParticleSys &particles, Scalar step_size);
+
+        /**
+         * @brief Permute the particles in the tables carried over to the next step, after the particle system
+         * reordered its storage(see `system::SimpleSystem::reorder_delta`).
+         *
+         * @param[in] particles Particle system in the new order.
+         * @param[in] order Particle k is particle order[k] of the last step.
+         */
+        template <typename ParticleSys>
+        void permute(ParticleSys const &particles, std::vector<size_t> const &order);
+
+        /**
+         * @brief Keep the B table, the initial state and the initial derivatives of the step for `interpolate`. Call
+         * it after `correct` and before `predict` of an accepted step.
+         *
+         * @param[in] step_size Step size of the step.
+         */
+        void save_step(Scalar step_size);
+
+        /**
+         * @brief Evaluate the expansion of the saved step at a fraction of the step and load the state into the
+         * particle system.
+         *
+         * @param[out] particles Particle system to load the state into.
+         * @param[in] fraction Fraction of the saved step, in [0, 1].
+         */
+        template <typename ParticleSys>
+        void interpolate(ParticleSys &particles, Scalar fraction);
+
+        /**
+         * @brief Evaluate one component of the state of the saved step.
+         *
+         * @param[in] i Index of the component in the state array.
+         * @param[in] fraction Fraction of the saved step.
+         * @param[out] derivative Derivative of the component with respect to the fraction.
+         * @return The component at the fraction.
+         */
+        StateScalar interpolate_component(size_t i, Scalar fraction, Scalar &derivative) const;
 
        private:
+        template <typename ParticleSys>
+        void check_particle_size(ParticleSys const &particles);
+
+        /**
+         * @brief Advance the state `y0` by the expansion to a fraction of the step, into `tmp_state_`.
+         */
+        void advance(IterTable const &b, ScalarArray const &dydh0, StateScalarArray const &y0, Scalar step_size,
+                     Scalar fraction);
+
+        /**
+         * @brief Velocity increment h * (a0 * s + b0 * s^2 / 2 + ... + b6 * s^8 / 8) of the j-th component.
+         */
+        static Scalar vel_increment(IterTable const &b, size_t j, Scalar a0, Scalar step_size, Scalar s);
+
+        /**
+         * @brief Position increment h * s * v0 + h^2 * (a0 * s^2 / 2 + b0 * s^3 / 6 + ... + b6 * s^9 / 72) of the j-th
+         * component.
+         */
+        static Scalar pos_increment(IterTable const &b, size_t j, Scalar v0, Scalar a0, Scalar step_size, Scalar s);
+
         IterTable b_;
         IterTable g_;
         IterTable old_b_;
 
         ScalarArray dydh0_{0};
         ScalarArray dydh_{0};
+        ScalarArray acc_{0};
         ScalarArray tmp_array_{0};
         ScalarArray dg_array_{0};
         StateScalarArray tmp_state_{0};
         StateScalarArray input_{0};
         size_t var_num_{0};
+        size_t acc_num_{0};
+        size_t time_offset_{0};
+        size_t pos_offset_{0};
+        size_t vel_offset_{0};
+        size_t auxi_vel_offset_{0};
+        bool auxi_vel_{false};
+
+        IterTable step_b_;
+        ScalarArray step_dydh0_{0};
+        StateScalarArray step_y0_{0};
+        Scalar step_h_{0};
+
+        CREATE_STATIC_MEMBER_CHECK(regu_type);
     };
 
     /*---------------------------------------------------------------------------*\
@@ -307,6 +542,111 @@ namespace hub::integrator {
         }
     }
 
+    template <typename Tab, typename Array, typename T>
+    void Radau::update_b_table(Tab &G, Tab &B, Array &dg, T const *y_init, T const *y_now, size_t stage, size_t size) {
+        switch (stage) {
+            case 0:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[0][i];
+                    G[0][i] = (y_now[i] - y_init[i]) * Radau::rs(0, 0);
+                    dg[i] = G[0][i] - tmp;
+                }
+                break;
+            case 1:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[1][i];
+                    G[1][i] = (y_now[i] - y_init[i]) * Radau::rs(1, 0) - G[0][i] * Radau::rs(1, 1);
+                    dg[i] = G[1][i] - tmp;
+                }
+                break;
+            case 2:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[2][i];
+                    G[2][i] = (y_now[i] - y_init[i]) * Radau::rs(2, 0) - G[0][i] * Radau::rs(2, 1) -
+                               G[1][i] * Radau::rs(2, 2);
+                    dg[i] = G[2][i] - tmp;
+                }
+                break;
+            case 3:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[3][i];
+                    G[3][i] = (y_now[i] - y_init[i]) * Radau::rs(3, 0) - G[0][i] * Radau::rs(3, 1) -
+                               G[1][i] * Radau::rs(3, 2) - G[2][i] * Radau::rs(3, 3);
+                    dg[i] = G[3][i] - tmp;
+                }
+                break;
+            case 4:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[4][i];
+                    G[4][i] = (y_now[i] - y_init[i]) * Radau::rs(4, 0) - G[0][i] * Radau::rs(4, 1) -
+                               G[1][i] * Radau::rs(4, 2) - G[2][i] * Radau::rs(4, 3) - G[3][i] * Radau::rs(4, 4);
+                    dg[i] = G[4][i] - tmp;
+                }
+                break;
+            case 5:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[5][i];
+                    G[5][i] = (y_now[i] - y_init[i]) * Radau::rs(5, 0) - G[0][i] * Radau::rs(5, 1) -
+                               G[1][i] * Radau::rs(5, 2) - G[2][i] * Radau::rs(5, 3) - G[3][i] * Radau::rs(5, 4) -
+                               G[4][i] * Radau::rs(5, 5);
+                    dg[i] = G[5][i] - tmp;
+                }
+                break;
+            case 6:
+#pragma GCC ivdep
+                for (size_t i = 0; i < size; ++i) {
+                    auto tmp = G[6][i];
+                    G[6][i] = (y_now[i] - y_init[i]) * Radau::rs(6, 0) - G[0][i] * Radau::rs(6, 1) -
+                               G[1][i] * Radau::rs(6, 2) - G[2][i] * Radau::rs(6, 3) - G[3][i] * Radau::rs(6, 4) -
+                               G[4][i] * Radau::rs(6, 5) - G[5][i] * Radau::rs(6, 6);
+                    dg[i] = G[6][i] - tmp;
+                }
+                break;
+
+            default:
+                break;
+        }
+        for (size_t i = 0; i <= stage; ++i) {
+            calc::array_advance(B[i], dg, Radau::g2b(stage, i));
+        }
+    }
+
+    template <typename Tab, typename Array, typename Scalar>
+    void Radau::predict(Tab &B, Tab &old_B, Tab &G, Array &tmp, Scalar step_ratio) {
+        std::array<Scalar, 7> Q;
+        Q[0] = step_ratio;
+        Q[1] = Q[0] * Q[0];
+        Q[2] = Q[1] * Q[0];
+        Q[3] = Q[1] * Q[1];
+        Q[4] = Q[2] * Q[1];
+        Q[5] = Q[2] * Q[2];
+        Q[6] = Q[3] * Q[2];
+
+        for (size_t i = 0; i < 7; ++i) {
+            calc::array_sub(tmp, B[i], old_B[i]);
+            calc::array_scale(old_B[i], B[6], est_b(6, i));
+            for (size_t j = 6; j > i; --j) {
+                calc::array_advance(old_B[i], B[j - 1], est_b(j - 1, i));
+            }
+            calc::array_scale(old_B[i], old_B[i], Q[i]);
+            calc::array_add(B[i], old_B[i], tmp);
+        }
+        transform_b2g(B, G);
+    }
+
+    template <typename Tab>
+    void Radau::permute(const std::vector<size_t> &order, Tab &B, Tab &old_B, Tab &G) {
+        for (size_t i = 0; i < 7; ++i) {
+            permute_all(order, B[i], old_B[i], G[i]);
+        }
+    }
+
     /*---------------------------------------------------------------------------*\
          Class Radau Implementation
     \*---------------------------------------------------------------------------*/
@@ -355,34 +695,65 @@ namespace hub::integrator {
     template <typename TypeSystem>
     template <typename ParticleSys>
     void GaussRadau<TypeSystem>::integrate_to(ParticleSys &particles, Scalar step_size, size_t stage) {
-        tmp_state_ = input_;
-        auto h_n = Radau::h(stage);
+        advance(b_, dydh0_, input_, step_size, Radau::h(stage));
+        particles.read_from_scalar_array(tmp_state_);
+    }
 
-        /*calc::array_scale(tmp_array_, b_[6], 7.0 * h_n / 8.0);
-        for (size_t i = 6; i > 0; --i) {
-            calc::array_scale_add(tmp_array_, tmp_array_, b_[i-1], static_cast<double>(i) * h_n / static_cast<double>(i
-        + 1));
-        }
-        calc::array_advance(tmp_array_, dydh0_);
-        calc::array_advance(tmp_state_, tmp_array_, step_size * h_n);*/
+    template <typename TypeSystem>
+    inline auto GaussRadau<TypeSystem>::increment(IterTable const &b, size_t i, Scalar dydh0, Scalar step_size,
+                                                  Scalar s) -> Scalar {
+        return ((((((((b[6][i] * (7.0 * s / 8.0)) + b[5][i]) * (6.0 * s / 7.0) + b[4][i]) * (5.0 * s / 6.0) +
+                    b[3][i]) *
+                       (4.0 * s / 5.0) +
+                   b[2][i]) *
+                      (3.0 * s / 4.0) +
+                  b[1][i]) *
+                     (2.0 * s / 3.0) +
+                 b[0][i]) *
+                    (1.0 * s / 2.0) +
+                dydh0) *
+               (s * step_size);
+    }
+
+    template <typename TypeSystem>
+    void GaussRadau<TypeSystem>::advance(IterTable const &b, ScalarArray const &dydh0, StateScalarArray const &y0,
+                                         Scalar step_size, Scalar fraction) {
+        tmp_state_ = y0;
 #pragma GCC ivdep
         for (size_t i = 0; i < var_num_; ++i) {
-            tmp_state_[i] +=
-                ((((((((b_[6][i] * (7.0 * h_n / 8.0)) + b_[5][i]) * (6.0 * h_n / 7.0) + b_[4][i]) * (5.0 * h_n / 6.0) +
-                     b_[3][i]) *
-                        (4.0 * h_n / 5.0) +
-                    b_[2][i]) *
-                       (3.0 * h_n / 4.0) +
-                   b_[1][i]) *
-                      (2.0 * h_n / 3.0) +
-                  b_[0][i]) *
-                     (1.0 * h_n / 2.0) +
-                 dydh0_[i]) *
-                (h_n * step_size);
+            tmp_state_[i] += increment(b, i, dydh0[i], step_size, fraction);
         }
+    }
+
+    template <typename TypeSystem>
+    void GaussRadau<TypeSystem>::save_step(Scalar step_size) {
+        step_b_ = b_;
+        step_dydh0_ = dydh0_;
+        step_y0_ = input_;
+        step_h_ = step_size;
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau<TypeSystem>::interpolate(ParticleSys &particles, Scalar fraction) {
+        advance(step_b_, step_dydh0_, step_y0_, step_h_, fraction);
         particles.read_from_scalar_array(tmp_state_);
     }
 
+    template <typename TypeSystem>
+    auto GaussRadau<TypeSystem>::interpolate_component(size_t i, Scalar fraction, Scalar &derivative) const
+        -> StateScalar {
+        auto const &b = step_b_;
+        Scalar d = b[6][i];
+        for (size_t k = 6; k > 0; --k) {
+            d = d * fraction + b[k - 1][i];
+        }
+        derivative = (d * fraction + step_dydh0_[i]) * step_h_;
+        StateScalar y = step_y0_[i];
+        y += increment(b, i, step_dydh0_[i], step_h_, fraction);
+        return y;
+    }
+
     template <typename TypeSystem>
     template <typename ParticleSys>
     void GaussRadau<TypeSystem>::evaluate(ParticleSys &particles, Scalar step_size) {
@@ -395,126 +766,255 @@ namespace hub::integrator {
     }
 
     template <typename TypeSystem>
-    void GaussRadau<TypeSystem>::update_b_table(const ScalarArray &y_init, const ScalarArray &y_now, size_t stage) {
-        /*calc::array_scale_sub(tmp_array_, y_now, y_init, Radau::rs(stage, 0));
-        for (size_t j = 0; j < stage; ++j) {
-            calc::array_advance(tmp_array_, g_[j], -Radau::rs(stage, j + 1));
+    template <typename ParticleSys>
+    void GaussRadau<TypeSystem>::correct(ParticleSys &particles, Scalar step_size) {
+        particles.write_to_scalar_array(input_);
+        check_particle_size(input_.size());
+        particles.evaluate_general_derivative(dydh0_);
+
+        for (size_t i = 0; i < final_point; ++i) {
+            integrate_to(particles, step_size, i);
+            particles.evaluate_general_derivative(dydh_);
+            Radau::update_b_table(g_, b_, dg_array_, dydh0_.data(), dydh_.data(), i, var_num_);
+            particles.read_from_scalar_array(input_);
         }
-        calc::array_sub(dg_array_, tmp_array_, g_[stage]);
+    }
 
-        std::swap(g_[stage], tmp_array_);
+    template <typename TypeSystem>
+    void GaussRadau<TypeSystem>::predict(Scalar step_ratio) {
+        Radau::predict(b_, old_b_, g_, tmp_array_, step_ratio);
+    }
 
-        for (size_t i = 0; i <= stage; ++i) {
-            calc::array_advance(b_[i], dg_array_, Radau::g2b(stage, i));
-        }*/
-        switch (stage) {
-            case 0:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[0][i];
-                    g_[0][i] = (y_now[i] - y_init[i]) * Radau::rs(0, 0);
-                    dg_array_[i] = g_[0][i] - tmp;
-                }
-                break;
-            case 1:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[1][i];
-                    g_[1][i] = (y_now[i] - y_init[i]) * Radau::rs(1, 0) - g_[0][i] * Radau::rs(1, 1);
-                    dg_array_[i] = g_[1][i] - tmp;
-                }
-                break;
-            case 2:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[2][i];
-                    g_[2][i] = (y_now[i] - y_init[i]) * Radau::rs(2, 0) - g_[0][i] * Radau::rs(2, 1) -
-                               g_[1][i] * Radau::rs(2, 2);
-                    dg_array_[i] = g_[2][i] - tmp;
-                }
-                break;
-            case 3:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[3][i];
-                    g_[3][i] = (y_now[i] - y_init[i]) * Radau::rs(3, 0) - g_[0][i] * Radau::rs(3, 1) -
-                               g_[1][i] * Radau::rs(3, 2) - g_[2][i] * Radau::rs(3, 3);
-                    dg_array_[i] = g_[3][i] - tmp;
-                }
-                break;
-            case 4:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[4][i];
-                    g_[4][i] = (y_now[i] - y_init[i]) * Radau::rs(4, 0) - g_[0][i] * Radau::rs(4, 1) -
-                               g_[1][i] * Radau::rs(4, 2) - g_[2][i] * Radau::rs(4, 3) - g_[3][i] * Radau::rs(4, 4);
-                    dg_array_[i] = g_[4][i] - tmp;
-                }
-                break;
-            case 5:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[5][i];
-                    g_[5][i] = (y_now[i] - y_init[i]) * Radau::rs(5, 0) - g_[0][i] * Radau::rs(5, 1) -
-                               g_[1][i] * Radau::rs(5, 2) - g_[2][i] * Radau::rs(5, 3) - g_[3][i] * Radau::rs(5, 4) -
-                               g_[4][i] * Radau::rs(5, 5);
-                    dg_array_[i] = g_[5][i] - tmp;
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau<TypeSystem>::permute(const ParticleSys &particles, const std::vector<size_t> &order) {
+        if (var_num_ != particles.variable_number()) {
+            return;
+        }
+        std::vector<size_t> var_order(var_num_);
+        for (size_t i = 0; i < var_num_; ++i) {
+            var_order[i] = i;
+        }
+        auto permute_block = [&](size_t offset) {
+            for (size_t k = 0; k < order.size(); ++k) {
+                for (size_t d = 0; d < 3; ++d) {
+                    var_order[offset + 3 * k + d] = offset + 3 * order[k] + d;
                 }
-                break;
-            case 6:
-#pragma GCC ivdep
-                for (size_t i = 0; i < var_num_; ++i) {
-                    auto tmp = g_[6][i];
-                    g_[6][i] = (y_now[i] - y_init[i]) * Radau::rs(6, 0) - g_[0][i] * Radau::rs(6, 1) -
-                               g_[1][i] * Radau::rs(6, 2) - g_[2][i] * Radau::rs(6, 3) - g_[3][i] * Radau::rs(6, 4) -
-                               g_[4][i] * Radau::rs(6, 5) - g_[5][i] * Radau::rs(6, 6);
-                    dg_array_[i] = g_[6][i] - tmp;
+            }
+        };
+        permute_block(particles.pos_offset());
+        permute_block(particles.vel_offset());
+        if constexpr (ParticleSys::ext_vel_dep) {
+            permute_block(particles.auxi_vel_offset());
+        }
+        Radau::permute(var_order, b_, old_b_, g_);
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Class GaussRadau2nd Implementation
+    \*---------------------------------------------------------------------------*/
+
+    template <typename TypeSystem>
+    GaussRadau2nd<TypeSystem>::GaussRadau2nd() {
+        auto init_iter_tab = [](auto &tab) {
+            for (auto &t : tab) {
+                t.resize(0);
+            }
+        };
+        init_iter_tab(b_);
+        init_iter_tab(old_b_);
+        init_iter_tab(g_);
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::check_particle_size(ParticleSys const &particles) {
+        if (var_num_ != input_.size()) {
+            var_num_ = input_.size();
+            acc_num_ = particles.number() * 3;
+            time_offset_ = particles.time_offset();
+            pos_offset_ = particles.pos_offset();
+            vel_offset_ = particles.vel_offset();
+            auxi_vel_offset_ = particles.auxi_vel_offset();
+            auxi_vel_ = ParticleSys::ext_vel_dep;
+
+            resize_all(var_num_, dydh0_, dydh_, tmp_state_);
+            resize_all(acc_num_, acc_, dg_array_, tmp_array_);
+            calc::set_arrays_zero(dydh0_, dydh_, tmp_state_, acc_, dg_array_, tmp_array_);
+
+            auto set_iter_tab_0 = [](auto &tab, size_t num) {
+                for (auto &t : tab) {
+                    t.resize(num);
+                    calc::array_set_zero(t);
                 }
-                break;
+            };
 
-            default:
-                break;
+            set_iter_tab_0(b_, acc_num_);
+            set_iter_tab_0(old_b_, acc_num_);
+            set_iter_tab_0(g_, acc_num_);
         }
-        for (size_t i = 0; i <= stage; ++i) {
-            calc::array_advance(b_[i], dg_array_, Radau::g2b(stage, i));
+    }
+
+    template <typename TypeSystem>
+    inline auto GaussRadau2nd<TypeSystem>::vel_increment(IterTable const &b, size_t j, Scalar a0, Scalar step_size,
+                                                         Scalar s) -> Scalar {
+        return ((((((((b[6][j] * (7.0 * s / 8.0)) + b[5][j]) * (6.0 * s / 7.0) + b[4][j]) * (5.0 * s / 6.0) +
+                    b[3][j]) *
+                       (4.0 * s / 5.0) +
+                   b[2][j]) *
+                      (3.0 * s / 4.0) +
+                  b[1][j]) *
+                     (2.0 * s / 3.0) +
+                 b[0][j]) *
+                    (1.0 * s / 2.0) +
+                a0) *
+               (s * step_size);
+    }
+
+    template <typename TypeSystem>
+    inline auto GaussRadau2nd<TypeSystem>::pos_increment(IterTable const &b, size_t j, Scalar v0, Scalar a0,
+                                                         Scalar step_size, Scalar s) -> Scalar {
+        return (((((((((b[6][j] * (7.0 * s / 9.0)) + b[5][j]) * (6.0 * s / 8.0) + b[4][j]) * (5.0 * s / 7.0) +
+                      b[3][j]) *
+                         (4.0 * s / 6.0) +
+                     b[2][j]) *
+                        (3.0 * s / 5.0) +
+                    b[1][j]) *
+                       (2.0 * s / 4.0) +
+                   b[0][j]) *
+                      (1.0 * s / 3.0) +
+                  a0) *
+                     (s * step_size / 2.0) +
+                 v0) *
+               (s * step_size);
+    }
+
+    template <typename TypeSystem>
+    void GaussRadau2nd<TypeSystem>::advance(IterTable const &b, ScalarArray const &dydh0, StateScalarArray const &y0,
+                                            Scalar step_size, Scalar fraction) {
+        tmp_state_ = y0;
+        tmp_state_[time_offset_] += dydh0[time_offset_] * (fraction * step_size);
+        size_t const pos = pos_offset_;
+        size_t const vel = vel_offset_;
+        size_t const aux = auxi_vel_offset_;
+#pragma GCC ivdep
+        for (size_t j = 0; j < acc_num_; ++j) {
+            Scalar const a0 = dydh0[vel + j];
+            Scalar const v0 = static_cast<Scalar>(y0[vel + j]);
+            Scalar const dv = vel_increment(b, j, a0, step_size, fraction);
+            tmp_state_[pos + j] += pos_increment(b, j, v0, a0, step_size, fraction);
+            tmp_state_[vel + j] += dv;
+            if (auxi_vel_) {
+                tmp_state_[aux + j] += dv;
+            }
         }
     }
 
     template <typename TypeSystem>
     template <typename ParticleSys>
-    void GaussRadau<TypeSystem>::correct(ParticleSys &particles, Scalar step_size) {
+    void GaussRadau2nd<TypeSystem>::integrate(ParticleSys &particles, Scalar step_size) {
+        correct(particles, step_size);
+        evaluate(particles, step_size);
+        predict(static_cast<Scalar>(1.0));
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::integrate_to(ParticleSys &particles, Scalar step_size, size_t stage) {
+        advance(b_, dydh0_, input_, step_size, Radau::h(stage));
+        particles.read_from_scalar_array(tmp_state_);
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::evaluate(ParticleSys &particles, Scalar step_size) {
+        advance(b_, dydh0_, input_, step_size, 1.0);
+        particles.read_from_scalar_array(tmp_state_);
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::correct(ParticleSys &particles, Scalar step_size) {
+        static_assert(!HAS_STATIC_MEMBER(ParticleSys, regu_type),
+                      "The second order Gauss-Radau integrator does not work with regularized systems!");
         particles.write_to_scalar_array(input_);
-        check_particle_size(input_.size());
+        check_particle_size(particles);
         particles.evaluate_general_derivative(dydh0_);
 
         for (size_t i = 0; i < final_point; ++i) {
             integrate_to(particles, step_size, i);
             particles.evaluate_general_derivative(dydh_);
-            update_b_table(dydh0_, dydh_, i);
+            Radau::update_b_table(g_, b_, dg_array_, dydh0_.data() + vel_offset_, dydh_.data() + vel_offset_, i,
+                                  acc_num_);
             particles.read_from_scalar_array(input_);
         }
+        std::copy_n(dydh_.begin() + vel_offset_, acc_num_, acc_.begin());
     }
 
     template <typename TypeSystem>
-    void GaussRadau<TypeSystem>::predict(Scalar step_ratio) {
-        std::array<Scalar, final_point> Q;
-        Q[0] = step_ratio;
-        Q[1] = Q[0] * Q[0];
-        Q[2] = Q[1] * Q[0];
-        Q[3] = Q[1] * Q[1];
-        Q[4] = Q[2] * Q[1];
-        Q[5] = Q[2] * Q[2];
-        Q[6] = Q[3] * Q[2];
+    void GaussRadau2nd<TypeSystem>::predict(Scalar step_ratio) {
+        Radau::predict(b_, old_b_, g_, tmp_array_, step_ratio);
+    }
 
-        for (size_t i = 0; i < final_point; ++i) {
-            calc::array_sub(tmp_array_, b_[i], old_b_[i]);
-            calc::array_scale(old_b_[i], b_[6], Radau::est_b(6, i));
-            for (size_t j = 6; j > i; --j) {
-                calc::array_advance(old_b_[i], b_[j - 1], Radau::est_b(j - 1, i));
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::permute(const ParticleSys &particles, const std::vector<size_t> &order) {
+        if (acc_num_ != particles.number() * 3) {
+            return;
+        }
+        std::vector<size_t> acc_order(acc_num_);
+        for (size_t k = 0; k < order.size(); ++k) {
+            for (size_t d = 0; d < 3; ++d) {
+                acc_order[3 * k + d] = 3 * order[k] + d;
+            }
+        }
+        Radau::permute(acc_order, b_, old_b_, g_);
+    }
+
+    template <typename TypeSystem>
+    void GaussRadau2nd<TypeSystem>::save_step(Scalar step_size) {
+        step_b_ = b_;
+        step_dydh0_ = dydh0_;
+        step_y0_ = input_;
+        step_h_ = step_size;
+    }
+
+    template <typename TypeSystem>
+    template <typename ParticleSys>
+    void GaussRadau2nd<TypeSystem>::interpolate(ParticleSys &particles, Scalar fraction) {
+        advance(step_b_, step_dydh0_, step_y0_, step_h_, fraction);
+        particles.read_from_scalar_array(tmp_state_);
+    }
+
+    template <typename TypeSystem>
+    auto GaussRadau2nd<TypeSystem>::interpolate_component(size_t i, Scalar fraction, Scalar &derivative) const
+        -> StateScalar {
+        auto const &b = step_b_;
+        Scalar const h = step_h_;
+        StateScalar y = step_y0_[i];
+        if (i < pos_offset_) {
+            derivative = step_dydh0_[i] * h;
+            y += step_dydh0_[i] * (fraction * h);
+            return y;
+        }
+        bool const is_pos = i < vel_offset_;
+        size_t const j = is_pos                                  ? i - pos_offset_
+                         : (auxi_vel_ && i >= auxi_vel_offset_) ? i - auxi_vel_offset_
+                                                                 : i - vel_offset_;
+        Scalar const a0 = step_dydh0_[vel_offset_ + j];
+        Scalar const dv = vel_increment(b, j, a0, h, fraction);
+        if (is_pos) {
+            Scalar const v0 = static_cast<Scalar>(step_y0_[vel_offset_ + j]);
+            derivative = (v0 + dv) * h;
+            y += pos_increment(b, j, v0, a0, h, fraction);
+        } else {
+            Scalar a = b[6][j];
+            for (size_t k = 6; k > 0; --k) {
+                a = a * fraction + b[k - 1][j];
             }
-            calc::array_scale(old_b_[i], old_b_[i], Q[i]);
-            calc::array_add(b_[i], old_b_[i], tmp_array_);
+            derivative = (a * fraction + a0) * h;
+            y += dv;
         }
-        Radau::transform_b2g(b_, g_);
+        return y;
     }
 }  // namespace hub::integrator
@@ -24,17 +24,23 @@ License
  */
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <tuple>
 
 #include "../dev-tools.hpp"
 #include "../spacehub-concepts.hpp"
+#include "central-field.hpp"
 namespace hub::force {
-    class AlphaDisk {
+    class AlphaDisk : public CentralField<AlphaDisk> {
        public:
-        constexpr static bool vel_dependent{true};
         // Type members
-        template <typename Particles>
-        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+        struct Context;
+
+        static Context central_context();
+
+        template <typename Vector, typename Scalar>
+        SPACEHUB_FORCE_INLINE static Vector central_force(CentralSample<Vector, Scalar> const &s, Context const &ctx);
 
         static double Q;
         static double alpha;
@@ -42,105 +48,146 @@ namespace hub::force {
         static int force;
 
         template <typename Vec>
-        static auto local_Omega_H(Vec &r, double M) {
-            auto M_dot = lambda * 0.22 * (M / 1e7) / (2 * consts::pi);
-            auto R = sqrt(r.x * r.x + r.y * r.y);
-            auto Omega = sqrt(M / (R * R * R));
-            auto H = pow(Q / 2 / alpha * M_dot / M / Omega, 1.0 / 3) * R;
-            return std::tuple(Omega, H);
+        static auto local_Omega_H(Vec const &r, double M) {
+            return local_Omega_H(r, M, central_context());
         }
 
         template <typename Vec>
-        static double disk_rho(Vec &r, double M, double H) {
-            auto R = sqrt(r.x * r.x + r.y * r.y);
-            auto rho0 = M / (2 * Q * consts::pi * R * R * R);
-            return rho0 * exp(-(r.z * r.z) / (2 * H * H)) * 1000;
+        static double disk_rho(Vec const &r, double M, double H) {
+            return disk_rho(r, M, H, central_context());
         }
 
         template <typename Vec>
-        static Vec disk_v(Vec &r, double M) {
+        SPACEHUB_FORCE_INLINE static Vec disk_v(Vec const &r, double M) {
             auto rr = sqrt(r.x * r.x + r.y * r.y);
             auto v = sqrt(M / rr);
             return Vec{-v * r.y / rr, v * r.x / rr, 0};
         }
-    };
 
-    template <typename Particles>
-    void AlphaDisk::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
-        auto const &v = particles.vel();
-        auto const &m = particles.mass();
-        auto const &r = particles.radius();
-
-        auto I_sup = [](double M, double logR) { return (0.5 * log(1 - 1 / M / M) + logR) / M / M; };
-        auto I_sub = [](double M) { return (0.5 * log((1 + M) / (1 - M)) - M) / M / M; };
-        auto dIdM_sup = [](double M, double logR) {
-            return (-2 * logR + 1 / (M * M - 1) - log(1 - 1 / M / M)) / M / M / M;
-        };
-        auto dIdM_sub = [](double M) {
-            return (M * M * M + (1 - M * M) * log((1 + M) / (1 - M)) - 2 * M) / (M * M * M * (M * M - 1));
+       private:
+        /**
+         * @brief Cubic that connects the subsonic and supersonic branches of the dynamical friction integral
+         * around Mach 1.
+         */
+        struct MachConnect {
+            double eps, x1, x2, y1, y2, a, b;
+
+            inline double operator()(double M) const {
+                double t = (M - x1) / (x2 - x1);
+                return (1 - t) * y1 + y2 * t + (1 - t) * t * (t * b + (1 - t) * a);
+            }
         };
 
-        constexpr double logR = 3.0;
-        const double eps = 1 / std::exp(2.0 * logR / 3.0);
-        const double x1 = 1 - eps;
-        const double x2 = 1 + eps;
-        const double y1 = I_sub(x1);
-        const double y2 = I_sup(x2, logR);
-        const double k1 = dIdM_sub(x1);
-        const double k2 = dIdM_sup(x2, logR);
-        const double a = k1 * (x2 - x1) - (y2 - y1);
-        const double b = -k2 * (x2 - x1) + (y2 - y1);
-
-        auto tt = [&](double M) { return (M - x1) / (x2 - x1); };
-
-        auto connect = [&](double M) {
-            double t = tt(M);
-            return (1 - t) * y1 + y2 * t + (1 - t) * t * (t * b + (1 - t) * a);
-        };
+        constexpr static double logR{3.0};
 
-        for (size_t i = 1; i < num; ++i) {
-            auto dr = p[i] - p[0];
-            auto dv = v[i] - v[0];
-            auto [Omega, H] = local_Omega_H(dr, m[0]);
-            auto v_disk = disk_v(dr, m[0]);
-            auto v_rel = dv - v_disk;
-            auto rho = disk_rho(dr, m[0], H);
-            auto rd = r[i];
-            auto v2 = dot(v_rel, v_rel);
-            auto vabs = sqrt(v2);
-            auto cs = Omega * H;
-            auto Mach = vabs / cs;
-
-            double I = 0;
-
-            double f = 0;
-
-            if (force >= 0) {
-                if (Mach > 1 + eps) {
-                    I = (0.5 * log(1 - 1 / (Mach * Mach)) + logR) / (Mach * Mach);
-                } else if ((0.1 < Mach) && (Mach < 1 - eps)) {
-                    I = (0.5 * log((1 + Mach) / (1 - Mach)) - Mach) / (Mach * Mach);
-                } else if (Mach < 0.1) {
-                    I = Mach / 3.0;
-                } else {
-                    I = connect(Mach);
-                }
-            }
+        static MachConnect const &mach_connect();
 
-            if (force == 1) {
-                f = I * 4 * consts::pi * consts::G * consts::G * m[i] * m[i] / (cs * cs) * rho;
-            } else if (force == -1) {
-                f = 4 * consts::pi * rd * rd * rho * v2;
-            } else {
-                double df = I * 4 * consts::pi * consts::G * consts::G * m[i] * m[i] / (cs * cs) * rho;
-                double aeo = 4 * consts::pi * rd * rd * rho * v2;
-                f = df + aeo;
-            }
-            acceleration[i] -= f * v_rel / vabs / m[i];
-            acceleration[0] += f * v_rel / vabs / m[0];
-        }
+        template <typename Vec>
+        SPACEHUB_FORCE_INLINE static auto local_Omega_H(Vec const &r, double M, Context const &ctx);
+
+        template <typename Vec>
+        SPACEHUB_FORCE_INLINE static double disk_rho(Vec const &r, double M, double H, Context const &ctx);
+
+        template <typename Scalar>
+        SPACEHUB_FORCE_INLINE static Scalar friction_integral(Scalar Mach, MachConnect const &connect);
+    };
+
+    /**
+     * @brief Snapshot of the disk parameters and of the Mach-1 connection, taken once per force evaluation. The
+     * `force` switch is folded into the weights of the two drag terms.
+     */
+    struct AlphaDisk::Context {
+        MachConnect connect;
+        double Q;
+        double alpha;
+        double lambda;
+        double df_weight;
+        double aeo_weight;
+    };
+
+    inline AlphaDisk::MachConnect const &AlphaDisk::mach_connect() {
+        static const MachConnect connect = [] {
+            auto I_sup = [](double M, double logR) { return (0.5 * log(1 - 1 / M / M) + logR) / M / M; };
+            auto I_sub = [](double M) { return (0.5 * log((1 + M) / (1 - M)) - M) / M / M; };
+            auto dIdM_sup = [](double M, double logR) {
+                return (-2 * logR + 1 / (M * M - 1) - log(1 - 1 / M / M)) / M / M / M;
+            };
+            auto dIdM_sub = [](double M) {
+                return (M * M * M + (1 - M * M) * log((1 + M) / (1 - M)) - 2 * M) / (M * M * M * (M * M - 1));
+            };
+
+            const double eps = 1 / std::exp(2.0 * logR / 3.0);
+            const double x1 = 1 - eps;
+            const double x2 = 1 + eps;
+            const double y1 = I_sub(x1);
+            const double y2 = I_sup(x2, logR);
+            const double k1 = dIdM_sub(x1);
+            const double k2 = dIdM_sup(x2, logR);
+            const double a = k1 * (x2 - x1) - (y2 - y1);
+            const double b = -k2 * (x2 - x1) + (y2 - y1);
+            return MachConnect{eps, x1, x2, y1, y2, a, b};
+        }();
+        return connect;
+    }
+
+    inline AlphaDisk::Context AlphaDisk::central_context() {
+        return Context{mach_connect(), Q, alpha, lambda, force >= 0 ? 1.0 : 0.0, force != 1 ? 1.0 : 0.0};
+    }
+
+    template <typename Vec>
+    auto AlphaDisk::local_Omega_H(Vec const &r, double M, Context const &ctx) {
+        auto M_dot = ctx.lambda * 0.22 * (M / 1e7) / (2 * consts::pi);
+        auto R = sqrt(r.x * r.x + r.y * r.y);
+        auto Omega = sqrt(M / (R * R * R));
+        auto H = pow(ctx.Q / 2 / ctx.alpha * M_dot / M / Omega, 1.0 / 3) * R;
+        return std::tuple(Omega, H);
+    }
+
+    template <typename Vec>
+    double AlphaDisk::disk_rho(Vec const &r, double M, double H, Context const &ctx) {
+        auto R = sqrt(r.x * r.x + r.y * r.y);
+        auto rho0 = M / (2 * ctx.Q * consts::pi * R * R * R);
+        return rho0 * exp(-(r.z * r.z) / (2 * H * H)) * 1000;
+    }
+
+    /**
+     * Every branch is evaluated on an argument clamped to its own range and the result is selected afterwards, so
+     * the body has no data dependent control flow.
+     */
+    template <typename Scalar>
+    Scalar AlphaDisk::friction_integral(Scalar Mach, MachConnect const &connect) {
+        Scalar M_sup = std::max(Mach, Scalar(connect.x2));
+        Scalar M_sub = std::clamp(Mach, Scalar(0.1), Scalar(connect.x1));
+        Scalar M_con = std::clamp(Mach, Scalar(connect.x1), Scalar(connect.x2));
+
+        Scalar I_sup = (0.5 * log(1 - 1 / (M_sup * M_sup)) + logR) / (M_sup * M_sup);
+        Scalar I_sub = (0.5 * log((1 + M_sub) / (1 - M_sub)) - M_sub) / (M_sub * M_sub);
+        Scalar I_low = Mach / 3.0;
+        Scalar I_con = connect(M_con);
+
+        Scalar I = Mach < connect.x1 && Mach >= 0.1 ? I_sub : I_con;
+        I = Mach < 0.1 ? I_low : I;
+        return Mach > connect.x2 ? I_sup : I;
+    }
+
+    template <typename Vector, typename Scalar>
+    Vector AlphaDisk::central_force(const CentralSample<Vector, Scalar> &s, Context const &ctx) {
+        auto [Omega, H] = local_Omega_H(s.dr, s.M, ctx);
+        auto v_disk = disk_v(s.dr, s.M);
+        auto v_rel = s.dv - v_disk;
+        auto rho = disk_rho(s.dr, s.M, H, ctx);
+        auto rd = s.radius;
+        auto v2 = dot(v_rel, v_rel);
+        auto vabs = sqrt(v2);
+        auto cs = Omega * H;
+        auto Mach = vabs / cs;
+
+        double I = friction_integral(Mach, ctx.connect);
+
+        double df = I * 4 * consts::pi * consts::G * consts::G * s.m * s.m / (cs * cs) * rho;
+        double aeo = 4 * consts::pi * rd * rd * rho * v2;
+        double f = ctx.df_weight * df + ctx.aeo_weight * aeo;
+        return -f * v_rel / vabs;
     }
 
 }  // namespace hub::force
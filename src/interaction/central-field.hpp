@@ -0,0 +1,260 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file central-field.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../macros.hpp"
+#include "../spacehub-concepts.hpp"
+
+namespace hub::force {
+    /**
+     * @brief State of a satellite relative to the central body (particle 0), passed to the per-particle model of
+     * a `CentralField`.
+     *
+     * @tparam Vector 3D vector type.
+     * @tparam Scalar Scalar type.
+     */
+    template <typename Vector, typename Scalar>
+    struct CentralSample {
+        /**
+         * @brief Position relative to the central body.
+         */
+        Vector dr;
+
+        /**
+         * @brief Velocity relative to the central body.
+         */
+        Vector dv;
+
+        /**
+         * @brief Mass of the central body.
+         */
+        Scalar M;
+
+        /**
+         * @brief Mass of the satellite.
+         */
+        Scalar m;
+
+        /**
+         * @brief Radius of the satellite, zero if the particle system has no radius.
+         */
+        Scalar radius;
+    };
+
+    namespace kernel {
+        CREATE_METHOD_CHECK(radius);
+
+        CREATE_METHOD_CHECK(central_context);
+
+        /*---------------------------------------------------------------------------*\
+             Class CentralScratch Declaration
+        \*---------------------------------------------------------------------------*/
+        /**
+         * @brief Structure-of-arrays copy of the satellite states relative to the central body, and of the forces
+         * exerted on them.
+         *
+         * @tparam T Scalar type of the scratch.
+         */
+        template <typename T>
+        struct CentralScratch {
+            std::vector<T> x, y, z, vx, vy, vz, m, radius, fx, fy, fz;
+
+            /**
+             * @brief Number of satellites in the scratch.
+             */
+            [[nodiscard]] inline size_t size() const { return m.size(); }
+
+            /**
+             * @brief Gather particle 1..N-1 relative to particle 0.
+             *
+             * @param[in] particles Particle system that is used to evaluated the acceleration.
+             */
+            template <typename Particles>
+            void gather(Particles const &particles);
+
+           private:
+            void resize(size_t n);
+        };
+
+        /**
+         * @brief Evaluate `Field::central_force` for every satellite in the scratch and store the forces.
+         *
+         * The loop reads and writes only contiguous streams without dependence between iterations, so it is
+         * vectorized whenever the model itself is free of calls the compiler cannot inline. The context of the
+         * model(see `CentralField`) is fetched once before the loop. Configure with `-DSPACEHUB_VEC_REPORT=ON` to
+         * get the vectorization report of the unit tests from the compiler.
+         *
+         * @param[in,out] s SoA scratch with gathered satellites.
+         * @param[in] M Mass of the central body.
+         */
+        template <typename Field, typename Vector, typename T>
+        void central_force(CentralScratch<T> &s, T M);
+    }  // namespace kernel
+
+    /*---------------------------------------------------------------------------*\
+         Class CentralField Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Base of the external fields(disks, drags) that act on every particle around the central body
+     * (particle 0), with the back-reaction on the central body.
+     *
+     * The derived class provides the per-satellite model
+     *
+     *     template <typename Vector, typename Scalar>
+     *     static Vector central_force(CentralSample<Vector, Scalar> const &s);
+     *
+     * that returns the force exerted on the satellite. A model that reads shared tables or parameters(lazily
+     * built singletons, static configuration) should instead provide
+     *
+     *     static Context central_context();
+     *
+     *     template <typename Vector, typename Scalar>
+     *     static Vector central_force(CentralSample<Vector, Scalar> const &s, Context const &ctx);
+     *
+     * The context is fetched once per evaluation, so the per-satellite body stays free of static guards and of
+     * loop invariant branches. This base gathers the satellites into a SoA scratch,
+     * evaluates the model over the scratch in one vectorizable loop, adds F/m to each satellite and the reduced
+     * -sum(F)/M to the central body.
+     *
+     * @tparam Field The derived field type.
+     */
+    template <typename Field>
+    class CentralField {
+       public:
+        constexpr static bool vel_dependent{true};
+
+        /**
+         * @brief Add the acceleration of the field to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class CentralScratch Implementation
+    \*---------------------------------------------------------------------------*/
+    namespace kernel {
+        template <typename T>
+        void CentralScratch<T>::resize(size_t n) {
+            x.resize(n), y.resize(n), z.resize(n), vx.resize(n), vy.resize(n), vz.resize(n);
+            m.resize(n), radius.assign(n, 0), fx.resize(n), fy.resize(n), fz.resize(n);
+        }
+
+        template <typename T>
+        template <typename Particles>
+        void CentralScratch<T>::gather(const Particles &particles) {
+            size_t const n = particles.number() - 1;
+            auto const &p = particles.pos();
+            auto const &v = particles.vel();
+            auto const &mass = particles.mass();
+            resize(n);
+            for (size_t k = 0; k < n; ++k) {
+                x[k] = p[k + 1].x - p[0].x;
+                y[k] = p[k + 1].y - p[0].y;
+                z[k] = p[k + 1].z - p[0].z;
+                vx[k] = v[k + 1].x - v[0].x;
+                vy[k] = v[k + 1].y - v[0].y;
+                vz[k] = v[k + 1].z - v[0].z;
+                m[k] = mass[k + 1];
+            }
+            if constexpr (HAS_METHOD(Particles, radius)) {
+                auto const &r = particles.radius();
+                for (size_t k = 0; k < n; ++k) {
+                    radius[k] = r[k + 1];
+                }
+            }
+        }
+
+        template <typename Field, typename Vector, typename T>
+        void central_force(CentralScratch<T> &s, T M) {
+            size_t const n = s.size();
+            T const *x = s.x.data();
+            T const *y = s.y.data();
+            T const *z = s.z.data();
+            T const *vx = s.vx.data();
+            T const *vy = s.vy.data();
+            T const *vz = s.vz.data();
+            T const *m = s.m.data();
+            T const *radius = s.radius.data();
+            T *fx = s.fx.data();
+            T *fy = s.fy.data();
+            T *fz = s.fz.data();
+
+            auto eval = [&](auto const &... ctx) {
+#pragma GCC ivdep
+                for (size_t k = 0; k < n; ++k) {
+                    CentralSample<Vector, T> sample{Vector{x[k], y[k], z[k]}, Vector{vx[k], vy[k], vz[k]}, M, m[k],
+                                                    radius[k]};
+                    Vector f = Field::central_force(sample, ctx...);
+                    fx[k] = f.x, fy[k] = f.y, fz[k] = f.z;
+                }
+            };
+
+            if constexpr (HAS_METHOD(Field, central_context)) {
+                auto const ctx = Field::central_context();
+                eval(ctx);
+            } else {
+                eval();
+            }
+        }
+    }  // namespace kernel
+
+    /*---------------------------------------------------------------------------*\
+         Class CentralField Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Field>
+    template <typename Particles>
+    void CentralField<Field>::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        using Scalar = typename Particles::Scalar;
+        using Vector = typename Particles::Vector;
+
+        if (particles.number() < 2) return;
+
+        static thread_local kernel::CentralScratch<Scalar> scratch;
+        auto const &m = particles.mass();
+
+        scratch.gather(particles);
+        kernel::central_force<Field, Vector>(scratch, m[0]);
+
+        size_t const n = scratch.size();
+        Scalar bx{0}, by{0}, bz{0};
+        for (size_t k = 0; k < n; ++k) {
+            acceleration[k + 1].x += scratch.fx[k] / scratch.m[k];
+            acceleration[k + 1].y += scratch.fy[k] / scratch.m[k];
+            acceleration[k + 1].z += scratch.fz[k] / scratch.m[k];
+            bx += scratch.fx[k], by += scratch.fy[k], bz += scratch.fz[k];
+        }
+        acceleration[0].x -= bx / m[0];
+        acceleration[0].y -= by / m[0];
+        acceleration[0].z -= bz / m[0];
+    }
+}  // namespace hub::force
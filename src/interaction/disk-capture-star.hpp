@@ -26,18 +26,18 @@ License
 
 #include "../dev-tools.hpp"
 #include "../spacehub-concepts.hpp"
+#include "central-field.hpp"
 namespace hub::force {
 
-    class DiskCaptureStar {
+    class DiskCaptureStar : public CentralField<DiskCaptureStar> {
        public:
-        constexpr static bool vel_dependent{true};
         // Type members
-        template <typename Particles>
-        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+        template <typename Vector, typename Scalar>
+        SPACEHUB_FORCE_INLINE static Vector central_force(CentralSample<Vector, Scalar> const &s);
 
        private:
         template <typename Vec>
-        static double disk_rho(Vec &r, double M) {
+        SPACEHUB_FORCE_INLINE static double disk_rho(Vec const &r, double M) {
             const double Q = 1;
             const double alpha = 1;
             const double lambda = 1;
@@ -50,38 +50,27 @@ namespace hub::force {
         }
 
         template <typename Vec>
-        static Vec disk_v(Vec &r, double M) {
+        SPACEHUB_FORCE_INLINE static Vec disk_v(Vec const &r, double M) {
             auto rr = sqrt(r.x * r.x + r.y * r.y);
             auto v = sqrt(M / rr);
             return Vec{-v * r.y / rr, v * r.x / rr, 0};
         }
     };
 
-    template <typename Particles>
-    void DiskCaptureStar::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
-        auto const &v = particles.vel();
-        auto const &m = particles.mass();
-        auto const &r = particles.radius();
-
-        for (size_t i = 1; i < num; ++i) {
-            auto dr = p[i] - p[0];
-            auto dv = v[i] - v[0];
-            auto v_disk = disk_v(dr, m[0]);
-            auto v_rel = dv - v_disk;
-            auto rho = disk_rho(dr, m[0]);
-            auto rd = r[i];
-            auto vabs = sqrt(dot(v_rel, v_rel));
-            /*double f1 = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
-            double f2 = 4 * consts::pi * consts::G * consts::G * m[i] * m[i] / dot(v_rel, v_rel) * rho;
-            acceleration[i] -= std::max(f1, f2) * v_rel / vabs;
-            acceleration[0] -= std::max(f1, f2) * v_rel / vabs;*/
-            // double f1 = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
-            double f = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
-            acceleration[i] -= f * v_rel / vabs / m[i];
-            acceleration[0] += f * v_rel / vabs / m[0];
-        }
+    template <typename Vector, typename Scalar>
+    Vector DiskCaptureStar::central_force(const CentralSample<Vector, Scalar> &s) {
+        auto v_disk = disk_v(s.dr, s.M);
+        auto v_rel = s.dv - v_disk;
+        auto rho = disk_rho(s.dr, s.M);
+        auto rd = s.radius;
+        auto vabs = sqrt(dot(v_rel, v_rel));
+        /*double f1 = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
+        double f2 = 4 * consts::pi * consts::G * consts::G * m[i] * m[i] / dot(v_rel, v_rel) * rho;
+        acceleration[i] -= std::max(f1, f2) * v_rel / vabs;
+        acceleration[0] -= std::max(f1, f2) * v_rel / vabs;*/
+        // double f1 = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
+        double f = consts::pi * rd * rd * rho * dot(v_rel, v_rel);
+        return -f * v_rel / vabs;
     }
 
 }  // namespace hub::force
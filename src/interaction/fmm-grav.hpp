@@ -0,0 +1,678 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file fmm-grav.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../multi-thread/multi-thread.hpp"
+#include "../particle-system/octree.hpp"
+#include "../spacehub-concepts.hpp"
+#include "soa-kernel.hpp"
+/**
+ * @namespace hub::force::fmm
+ * Cartesian Taylor fast multipole method.
+ */
+namespace hub::force::fmm {
+
+    /*---------------------------------------------------------------------------*\
+         Class Expansion Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Multi-index bookkeeping of Cartesian Taylor expansions up to total degree `order`.
+     *
+     * Multi-indices n = (a, b, c) are stored by increasing degree |n| = a + b + c, so the terms of degree <= q
+     * are the first (q+1)(q+2)(q+3)/6 entries. The translation operators are precomputed as sparse lists of
+     * (target, source, tensor, coefficient) terms.
+     */
+    class Expansion {
+       public:
+        /**
+         * @brief One term of a translation operator: out[target] += coef * in[source] * tensor[tensor].
+         */
+        struct Term {
+            int target, source, tensor;
+            double coef;
+
+            /**
+             * @brief (-1)^|tensor|, the parity of the tensor index used by the symmetric M2L.
+             */
+            double parity;
+        };
+
+        /**
+         * @brief Highest supported expansion order.
+         */
+        static constexpr size_t max_order{12};
+
+        explicit Expansion(size_t order);
+
+        [[nodiscard]] inline size_t order() const { return order_; }
+
+        /**
+         * @brief Number of expansion coefficients.
+         */
+        [[nodiscard]] inline size_t size() const { return n_.size(); }
+
+        /**
+         * @brief Monomials d^n for all |n| <= order.
+         */
+        template <typename T>
+        void monomials(Vec3<T> const &d, T *out) const;
+
+        /**
+         * @brief Taylor coefficients D^n(1/r)/n! for all |n| <= order.
+         */
+        template <typename T>
+        void derivatives(Vec3<T> const &r, T *out) const;
+
+        /**
+         * @brief Multipole to multipole: M_p[n] += C(n, m) s^(n-m) M_c[m] with s = z_c - z_p, tensor = s^n.
+         */
+        [[nodiscard]] inline std::vector<Term> const &m2m() const { return m2m_; }
+
+        /**
+         * @brief Multipole to local: L[k] += -(-1)^|n| C(n+k, k) M[n] b[n+k] with b = D(1/r)/n! at r = w - z.
+         *
+         * Since b(-r) = (-1)^|n| b(r), the opposite direction reuses b with the factor `parity`.
+         */
+        [[nodiscard]] inline std::vector<Term> const &m2l() const { return m2l_; }
+
+        /**
+         * @brief Local to local: L_c[j] += C(k, j) s^(k-j) L_p[k] with s = w_c - w_p, tensor = s^n.
+         */
+        [[nodiscard]] inline std::vector<Term> const &l2l() const { return l2l_; }
+
+        /**
+         * @brief The multi-indices (a, b, c).
+         */
+        [[nodiscard]] inline std::vector<std::array<int, 3>> const &indices() const { return n_; }
+
+        /**
+         * @brief For each multi-index n, the index of n - e_x, n - e_y and n - e_z (-1 if not exist).
+         */
+        [[nodiscard]] inline std::vector<std::array<int, 3>> const &lower() const { return lower_; }
+
+       private:
+        [[nodiscard]] inline int index(int a, int b, int c) const {
+            return lookup_[(a * (order_ + 1) + b) * (order_ + 1) + c];
+        }
+
+        size_t order_;
+        std::vector<std::array<int, 3>> n_;
+        std::vector<std::array<int, 3>> lower_;
+        std::vector<int> lookup_;
+        std::vector<Term> m2m_, m2l_, l2l_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Evaluator Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Dual tree FMM evaluation of the Newtonian acceleration.
+     *
+     * Upward pass (P2M, M2M) over an octree, symmetric dual tree traversal with M2L for well separated cell pairs
+     * ((b_A + b_B) < theta * |z_A - z_B|) and P2P for the rest, then the downward pass (L2L, L2P). All expansions
+     * are centered at the cell centers of mass.
+     *
+     * From `kernel::parallel_threshold` particles on and with more than one thread available(see
+     * `multi_thread::parallel_available()`), the tree is cut into at least `kernel::parallel_tiles` disjoint
+     * subtrees that run the upward and downward passes as parallel tasks. The traversal then runs one task per
+     * subtree as target against the whole tree, applying each M2L and P2P to the target side only. That costs up to
+     * twice the interactions of the symmetric traversal, but no two tasks write to the same cell or particle.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class Evaluator {
+       public:
+        using Vector = Vec3<T>;
+
+        /**
+         * @brief Maximum number of particles in a leaf.
+         */
+        static constexpr size_t leaf_capacity{64};
+
+        /**
+         * @brief Add the acceleration of all particles to `acceleration`.
+         *
+         * @param[in] pos Position array.
+         * @param[in] mass Mass array.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in] order Expansion order.
+         * @param[in] theta Opening angle.
+         */
+        template <typename VectorArray, typename ScalarArray, typename AccArray>
+        void add_acc_to(VectorArray const &pos, ScalarArray const &mass, AccArray &acceleration, size_t order,
+                        T theta);
+
+       private:
+        void split_tree(size_t tasks);
+
+        void upward(int id, T *tmp);
+
+        void upward_above(int id, T *tmp);
+
+        void interact(int a, int b, T *tmp);
+
+        void interact_target(int a, int b, T *tmp);
+
+        void downward(int id, T *tmp);
+
+        void downward_above(int id, T *tmp);
+
+        void m2m(int parent, int child, T *tmp);
+
+        void l2l(int parent, int child, T *tmp);
+
+        template <bool Symmetric>
+        void m2l(int a, int b, T *tmp);
+
+        octree::Octree<T, leaf_capacity> tree_;
+        std::unique_ptr<Expansion> exp_;
+        std::vector<T> multipole_, local_;
+        std::vector<T> tmp_;
+        std::vector<Vector> pos_, acc_;
+        std::vector<T> mass_;
+        std::vector<int> subtrees_;
+        std::vector<char> above_;
+        T theta_{0.5};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Expansion Implementation
+    \*---------------------------------------------------------------------------*/
+    inline Expansion::Expansion(size_t order) : order_{std::min(order, max_order)} {
+        int const p = static_cast<int>(order_);
+        lookup_.assign((order_ + 1) * (order_ + 1) * (order_ + 1), -1);
+        for (int d = 0; d <= p; ++d) {
+            for (int a = d; a >= 0; --a) {
+                for (int b = d - a; b >= 0; --b) {
+                    lookup_[(a * (p + 1) + b) * (p + 1) + (d - a - b)] = static_cast<int>(n_.size());
+                    n_.push_back({a, b, d - a - b});
+                }
+            }
+        }
+
+        for (auto const &[a, b, c] : n_) {
+            lower_.push_back({a > 0 ? index(a - 1, b, c) : -1, b > 0 ? index(a, b - 1, c) : -1,
+                              c > 0 ? index(a, b, c - 1) : -1});
+        }
+
+        double binom[max_order + 1][max_order + 1]{};
+        for (size_t i = 0; i <= max_order; ++i) {
+            binom[i][0] = 1;
+            for (size_t j = 1; j <= i; ++j) binom[i][j] = binom[i - 1][j - 1] + (j < i ? binom[i - 1][j] : 0);
+        }
+
+        int const size = static_cast<int>(n_.size());
+        for (int i = 0; i < size; ++i) {
+            auto const &n = n_[i];
+            for (int j = 0; j < size; ++j) {
+                auto const &m = n_[j];
+                // m <= n component wise
+                if (m[0] <= n[0] && m[1] <= n[1] && m[2] <= n[2]) {
+                    double c = binom[n[0]][m[0]] * binom[n[1]][m[1]] * binom[n[2]][m[2]];
+                    int diff = index(n[0] - m[0], n[1] - m[1], n[2] - m[2]);
+                    m2m_.push_back({i, j, diff, c, 1});
+                    l2l_.push_back({j, i, diff, c, 1});
+                }
+                // n + m within order
+                if (n[0] + m[0] + n[1] + m[1] + n[2] + m[2] <= p) {
+                    double c = binom[n[0] + m[0]][m[0]] * binom[n[1] + m[1]][m[1]] * binom[n[2] + m[2]][m[2]];
+                    double sign = (n[0] + n[1] + n[2]) % 2 ? 1.0 : -1.0;
+                    double parity = (n[0] + m[0] + n[1] + m[1] + n[2] + m[2]) % 2 ? -1.0 : 1.0;
+                    m2l_.push_back({j, i, index(n[0] + m[0], n[1] + m[1], n[2] + m[2]), sign * c, parity});
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void Expansion::monomials(const Vec3<T> &d, T *out) const {
+        out[0] = 1;
+        for (size_t i = 1; i < n_.size(); ++i) {
+            auto const &low = lower_[i];
+            if (low[0] >= 0) {
+                out[i] = out[low[0]] * d.x;
+            } else if (low[1] >= 0) {
+                out[i] = out[low[1]] * d.y;
+            } else {
+                out[i] = out[low[2]] * d.z;
+            }
+        }
+    }
+
+    template <typename T>
+    void Expansion::derivatives(const Vec3<T> &r, T *out) const {
+        // |k| r^2 b_k + (2|k|-1) sum_i r_i b_{k-e_i} + (|k|-1) sum_i b_{k-2e_i} = 0
+        T const r2 = norm2(r);
+        T const rr2 = 1 / r2;
+        T const x[3] = {r.x, r.y, r.z};
+        out[0] = 1 / std::sqrt(r2);
+        for (size_t i = 1; i < n_.size(); ++i) {
+            auto const &low = lower_[i];
+            int const k = n_[i][0] + n_[i][1] + n_[i][2];
+            T first = 0, second = 0;
+            for (size_t dim = 0; dim < 3; ++dim) {
+                if (low[dim] >= 0) {
+                    first += x[dim] * out[low[dim]];
+                    int low2 = lower_[low[dim]][dim];
+                    if (low2 >= 0) second += out[low2];
+                }
+            }
+            out[i] = -((2 * k - 1) * first + (k - 1) * second) * rr2 / k;
+        }
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Class Evaluator Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T>
+    template <typename VectorArray, typename ScalarArray, typename AccArray>
+    void Evaluator<T>::add_acc_to(const VectorArray &pos, const ScalarArray &mass, AccArray &acceleration,
+                                  size_t order, T theta) {
+        size_t const n = mass.size();
+        if (n < 2) return;
+
+        if (!exp_ || exp_->order() != std::min(order, Expansion::max_order)) {
+            exp_ = std::make_unique<Expansion>(order);
+        }
+        theta_ = theta;
+
+        pos_.resize(n), mass_.resize(n), acc_.assign(n, Vector{0, 0, 0});
+        for (size_t i = 0; i < n; ++i) {
+            pos_[i] = Vector{static_cast<T>(pos[i].x), static_cast<T>(pos[i].y), static_cast<T>(pos[i].z)};
+            mass_[i] = static_cast<T>(mass[i]);
+        }
+
+        tree_.build(pos_, mass_);
+
+        size_t const terms = exp_->size();
+        size_t const cells = tree_.nodes().size();
+        multipole_.assign(cells * terms, 0);
+        local_.assign(cells * terms, 0);
+
+        // the one sided traversal only pays off if the tasks really run in parallel
+        bool const parallel = n >= kernel::parallel_threshold && multi_thread::parallel_available();
+        split_tree(parallel ? kernel::parallel_tiles : 1);
+        size_t const tasks = subtrees_.size();
+        tmp_.resize(2 * terms * tasks);
+
+        if (tasks == 1) {
+            upward(0, tmp_.data());
+            interact(0, 0, tmp_.data());
+            downward(0, tmp_.data());
+        } else {
+            multi_thread::parallel_for_tasks(tasks, [&](size_t t) { upward(subtrees_[t], tmp_.data() + 2 * terms * t); });
+            upward_above(0, tmp_.data());
+            multi_thread::parallel_for_tasks(
+                tasks, [&](size_t t) { interact_target(subtrees_[t], 0, tmp_.data() + 2 * terms * t); });
+            downward_above(0, tmp_.data());
+            multi_thread::parallel_for_tasks(tasks,
+                                             [&](size_t t) { downward(subtrees_[t], tmp_.data() + 2 * terms * t); });
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            acceleration[i].x += acc_[i].x;
+            acceleration[i].y += acc_[i].y;
+            acceleration[i].z += acc_[i].z;
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::split_tree(size_t tasks) {
+        auto const &nodes = tree_.nodes();
+        subtrees_.assign(1, 0);
+        above_.assign(nodes.size(), 0);
+        // split the most populated cell until there are enough subtrees or only leaves are left
+        while (subtrees_.size() < tasks) {
+            auto largest = std::max_element(subtrees_.begin(), subtrees_.end(), [&](int a, int b) {
+                return nodes[a].end - nodes[a].begin < nodes[b].end - nodes[b].begin;
+            });
+            int id = *largest;
+            if (nodes[id].leaf) break;
+            above_[id] = 1;
+            subtrees_.erase(largest);
+            for (int c : nodes[id].child) {
+                if (c >= 0) subtrees_.push_back(c);
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::m2m(int parent, int child, T *tmp) {
+        size_t const terms = exp_->size();
+        exp_->monomials(tree_.nodes()[child].com - tree_.nodes()[parent].com, tmp);
+        T *M = multipole_.data() + parent * terms;
+        T const *Mc = multipole_.data() + child * terms;
+        for (auto const &term : exp_->m2m()) {
+            M[term.target] += static_cast<T>(term.coef) * tmp[term.tensor] * Mc[term.source];
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::l2l(int parent, int child, T *tmp) {
+        size_t const terms = exp_->size();
+        exp_->monomials(tree_.nodes()[child].com - tree_.nodes()[parent].com, tmp);
+        T const *L = local_.data() + parent * terms;
+        T *Lc = local_.data() + child * terms;
+        for (auto const &term : exp_->l2l()) {
+            Lc[term.target] += static_cast<T>(term.coef) * tmp[term.tensor] * L[term.source];
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::upward(int id, T *tmp) {
+        auto const &node = tree_.nodes()[id];
+        size_t const terms = exp_->size();
+        T *M = multipole_.data() + id * terms;
+
+        if (node.leaf) {
+            auto const &order = tree_.order();
+            for (size_t k = node.begin; k < node.end; ++k) {
+                size_t i = order[k];
+                exp_->monomials(pos_[i] - node.com, tmp);
+                for (size_t t = 0; t < terms; ++t) M[t] += mass_[i] * tmp[t];
+            }
+        } else {
+            for (int c : node.child) {
+                if (c < 0) continue;
+                upward(c, tmp);
+                m2m(id, c, tmp);
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::upward_above(int id, T *tmp) {
+        for (int c : tree_.nodes()[id].child) {
+            if (c < 0) continue;
+            if (above_[c]) upward_above(c, tmp);
+            m2m(id, c, tmp);
+        }
+    }
+
+    template <typename T>
+    template <bool Symmetric>
+    void Evaluator<T>::m2l(int a, int b, T *tmp) {
+        auto const &nodes = tree_.nodes();
+        size_t const terms = exp_->size();
+        T *d = tmp + terms;
+        exp_->derivatives(nodes[a].com - nodes[b].com, d);
+        T *La = local_.data() + a * terms;
+        T *Lb = local_.data() + b * terms;
+        T const *Ma = multipole_.data() + a * terms;
+        T const *Mb = multipole_.data() + b * terms;
+        for (auto const &term : exp_->m2l()) {
+            T t = static_cast<T>(term.coef) * d[term.tensor];
+            La[term.target] += t * Mb[term.source];
+            if constexpr (Symmetric) {
+                Lb[term.target] += static_cast<T>(term.parity) * t * Ma[term.source];
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::interact(int a, int b, T *tmp) {
+        auto const &nodes = tree_.nodes();
+        auto const &A = nodes[a];
+        auto const &B = nodes[b];
+        auto const &order = tree_.order();
+
+        auto direct = [&](size_t i, size_t j) {
+            Vector dr = pos_[j] - pos_[i];
+            T r = norm(dr);
+            T rr3 = 1 / (r * r * r);
+            acc_[i] += dr * (rr3 * mass_[j]);
+            acc_[j] -= dr * (rr3 * mass_[i]);
+        };
+
+        if (a == b) {
+            if (A.leaf) {
+                for (size_t k = A.begin; k < A.end; ++k) {
+                    for (size_t l = k + 1; l < A.end; ++l) {
+                        direct(order[k], order[l]);
+                    }
+                }
+            } else {
+                for (size_t c1 = 0; c1 < 8; ++c1) {
+                    if (A.child[c1] < 0) continue;
+                    for (size_t c2 = c1; c2 < 8; ++c2) {
+                        if (A.child[c2] >= 0) interact(A.child[c1], A.child[c2], tmp);
+                    }
+                }
+            }
+            return;
+        }
+
+        T const d2 = norm2(A.com - B.com);
+        T const rab = A.b_max + B.b_max;
+        if (rab * rab < theta_ * theta_ * d2) {
+            m2l<true>(a, b, tmp);
+        } else if (A.leaf && B.leaf) {
+            for (size_t k = A.begin; k < A.end; ++k) {
+                for (size_t l = B.begin; l < B.end; ++l) {
+                    direct(order[k], order[l]);
+                }
+            }
+        } else if (A.leaf || (!B.leaf && B.b_max > A.b_max)) {
+            for (int c : B.child) {
+                if (c >= 0) interact(a, c, tmp);
+            }
+        } else {
+            for (int c : A.child) {
+                if (c >= 0) interact(c, b, tmp);
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::interact_target(int a, int b, T *tmp) {
+        auto const &nodes = tree_.nodes();
+        auto const &A = nodes[a];
+        auto const &B = nodes[b];
+        auto const &order = tree_.order();
+
+        T const d2 = norm2(A.com - B.com);
+        T const rab = A.b_max + B.b_max;
+        if (a != b && rab * rab < theta_ * theta_ * d2) {
+            m2l<false>(a, b, tmp);
+        } else if (A.leaf && B.leaf) {
+            for (size_t k = A.begin; k < A.end; ++k) {
+                size_t i = order[k];
+                for (size_t l = B.begin; l < B.end; ++l) {
+                    size_t j = order[l];
+                    if (i == j) continue;
+                    Vector dr = pos_[j] - pos_[i];
+                    T r = norm(dr);
+                    acc_[i] += dr * (mass_[j] / (r * r * r));
+                }
+            }
+        } else if (A.leaf || (!B.leaf && B.b_max >= A.b_max)) {
+            for (int c : B.child) {
+                if (c >= 0) interact_target(a, c, tmp);
+            }
+        } else {
+            for (int c : A.child) {
+                if (c >= 0) interact_target(c, b, tmp);
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::downward(int id, T *tmp) {
+        auto const &node = tree_.nodes()[id];
+        size_t const terms = exp_->size();
+        T const *L = local_.data() + id * terms;
+        T *mono = tmp;
+
+        if (node.leaf) {
+            auto const &order = tree_.order();
+            auto const &lower = exp_->lower();
+            auto const &n = exp_->indices();
+            for (size_t k = node.begin; k < node.end; ++k) {
+                size_t i = order[k];
+                exp_->monomials(pos_[i] - node.com, mono);
+                // a = -grad(phi), phi = sum_k L_k d^k, d/dx d^k = k_x d^(k - e_x)
+                Vector grad{0, 0, 0};
+                for (size_t t = 1; t < terms; ++t) {
+                    auto const &low = lower[t];
+                    if (low[0] >= 0) grad.x += L[t] * mono[low[0]] * static_cast<T>(n[t][0]);
+                    if (low[1] >= 0) grad.y += L[t] * mono[low[1]] * static_cast<T>(n[t][1]);
+                    if (low[2] >= 0) grad.z += L[t] * mono[low[2]] * static_cast<T>(n[t][2]);
+                }
+                acc_[i] -= grad;
+            }
+        } else {
+            for (int c : node.child) {
+                if (c < 0) continue;
+                l2l(id, c, tmp);
+                downward(c, tmp);
+            }
+        }
+    }
+
+    template <typename T>
+    void Evaluator<T>::downward_above(int id, T *tmp) {
+        for (int c : tree_.nodes()[id].child) {
+            if (c < 0) continue;
+            l2l(id, c, tmp);
+            if (above_[c]) downward_above(c, tmp);
+        }
+    }
+}  // namespace hub::force::fmm
+
+namespace hub::force {
+    /*---------------------------------------------------------------------------*\
+         Class FMMGrav Declaration
+    \*---------------------------------------------------------------------------*/
+
+    /**
+     * @brief Newtonian gravity from a Cartesian fast multipole method.
+     *
+     * Drop-in replacement of `NewtonianGrav` as the internal force of `force::Interactions` for very large N. The
+     * relative truncation error of a well separated cell pair is bounded by about theta^(order+1). The expansion
+     * order is chosen on every evaluation from the relative tolerance of the run, which `Simulator::run` stores in
+     * the `force_rtol()` of the evaluated system, or from `tolerance` if it is set. Without a tolerance, `order` is used.
+     *
+     * @note The cell acceptance makes the force only piecewise smooth. Use it with the symplectic methods
+     * (e.g. `methods::Sym4`) rather than the extrapolation methods.
+     */
+    class FMMGrav {
+       public:
+        /**
+         * @brief Is this force velocity dependent?
+         *
+         */
+        constexpr static bool vel_dependent{false};
+
+        /**
+         * @brief Expansion order if no tolerance is set.
+         */
+        inline static size_t order{6};
+
+        /**
+         * @brief Opening angle of the multipole acceptance criterion (b_A + b_B) < theta * d.
+         */
+        inline static double opening_angle{0.7};
+
+        /**
+         * @brief Target relative truncation error. Overrides the tolerance of the run if positive.
+         */
+        inline static double tolerance{0};
+
+        /**
+         * @brief The tolerance used by the next evaluation of `particles`.
+         *
+         * @return `tolerance` if positive, else the `force_rtol()` of `particles` if it has one, else zero.
+         */
+        template <typename Particles>
+        static double current_tolerance(Particles const &particles);
+
+        /**
+         * @brief The expansion order for a given tolerance.
+         *
+         * @param[in] tol Relative tolerance(see `current_tolerance()`).
+         * @return `order` if the tolerance is not positive.
+         */
+        static size_t current_order(double tol);
+
+        /**
+         * @brief Add the FMM acceleration to existing 3D vector array.
+         *
+         * @note this method ADD acceleration TO input 'acceleration'.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+
+       private:
+        CREATE_METHOD_CHECK(force_rtol);
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class FMMGrav Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Particles>
+    double FMMGrav::current_tolerance(const Particles &particles) {
+        if (tolerance > 0) {
+            return tolerance;
+        }
+        if constexpr (HAS_METHOD(Particles, force_rtol)) {
+            return particles.force_rtol();
+        } else {
+            return 0;
+        }
+    }
+
+    inline size_t FMMGrav::current_order(double tol) {
+        if (tol > 0 && opening_angle > 0 && opening_angle < 1) {
+            auto p = static_cast<long>(std::ceil(std::log(tol) / std::log(opening_angle))) - 1;
+            return static_cast<size_t>(std::clamp(p, 1L, static_cast<long>(fmm::Expansion::max_order)));
+        } else {
+            return std::clamp(order, size_t{1}, fmm::Expansion::max_order);
+        }
+    }
+
+    template <typename Particles>
+    void FMMGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        using Scalar = typename Particles::Scalar;
+        static_assert(std::is_floating_point_v<Scalar>, "FMMGrav requires a floating point scalar type!");
+
+        static thread_local fmm::Evaluator<Scalar> evaluator;
+        evaluator.add_acc_to(particles.pos(), particles.mass(), acceleration,
+                             current_order(current_tolerance(particles)),
+                             static_cast<Scalar>(opening_angle));
+    }
+}  // namespace hub::force
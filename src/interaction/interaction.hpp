@@ -24,8 +24,11 @@ License
  */
 #pragma once
 
+#include <atomic>
+
 #include "../core-computation.hpp"
 #include "../spacehub-concepts.hpp"
+#include "pair-loop.hpp"
 namespace hub::force {
 
     /*---------------------------------------------------------------------------*\
@@ -52,6 +55,14 @@ namespace hub::force {
          */
         static constexpr bool ext_vel_indep{(... || !ExtraForce::vel_dependent)};
 
+        /**
+         * @brief Does any force only walk the compact pairs? The particle systems then rebuild their
+         * `force::CompactPairs` every step.
+         *
+         */
+        static constexpr bool compact_pairs{pair_loop::is_compact_force<InternalForce>() ||
+                                            (... || pair_loop::is_compact_force<ExtraForce>())};
+
         /**
          * Evaluate the total acceleration of the current state of a given particle system.
          *
@@ -63,6 +74,20 @@ namespace hub::force {
         template <CONCEPT_PARTICLES_DATA Particles>
         static void eval_acc(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * Evaluate the total acceleration of the current state of a given particle system, and the potential energy
+         * of the forces that provide it as a by-product of the same pass.
+         *
+         * @tparam Particles Type of the particle system.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         * @param[out] potential The output of the potential energy.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles>
+        static void eval_acc(Particles const &particles, typename Particles::VectorArray &acceleration,
+                             typename Particles::Scalar &potential);
+
         /**
          * Evaluate the external acceleration of the current state of a given particle system.
          *
@@ -106,6 +131,76 @@ namespace hub::force {
          */
         template <CONCEPT_PARTICLES_DATA Particles>
         static void eval_newtonian_acc(Particles const &particles, typename Particles::VectorArray &acceleration);
+
+        /**
+         * Evaluate the internal newtonian acceleration and potential energy of the current state of a given
+         * particle system.
+         *
+         * @tparam Particles Type of the particle system.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         * @param[out] potential The output of the potential energy.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles>
+        static void eval_newtonian_acc(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                       typename Particles::Scalar &potential);
+
+        /**
+         * @brief Can the internal force of this interaction provide the potential energy of particle system
+         * `Particles` as a by-product of the acceleration?
+         */
+        template <typename Particles>
+        static constexpr bool potential_by_product{pair_loop::has_potential<InternalForce, Particles>};
+    };
+
+    /**
+     * @brief Process wide unique key of the storage layout of a particle system.
+     *
+     * Forces that cache index based structures between evaluations (e.g. the octree of `TreeGrav`) compare the key
+     * instead of the system address, so a cache is never reused by another system. Copies draw a new key, and the
+     * owner system renews or swaps it whenever it permutes its storage.
+     */
+    class LayoutKey {
+       public:
+        LayoutKey() : id_{next()} {}
+
+        LayoutKey(LayoutKey const &) : id_{next()} {}
+
+        LayoutKey(LayoutKey &&) noexcept : id_{next()} {}
+
+        LayoutKey &operator=(LayoutKey const &) {
+            id_ = next();
+            return *this;
+        }
+
+        LayoutKey &operator=(LayoutKey &&) noexcept {
+            id_ = next();
+            return *this;
+        }
+
+        /**
+         * @brief Current key.
+         */
+        [[nodiscard]] size_t id() const { return id_; }
+
+        /**
+         * @brief Draw a new key, invalidating the caches keyed by the old one.
+         */
+        void renew() { id_ = next(); }
+
+        /**
+         * @brief Exchange the keys of two layouts, e.g. when a system switches between two storage orders.
+         */
+        void swap(LayoutKey &other) noexcept { std::swap(id_, other.id_); }
+
+       private:
+        static size_t next() {
+            static std::atomic<size_t> counter{0};
+            return ++counter;
+        }
+
+        size_t id_;
     };
 
     /**
@@ -118,6 +213,9 @@ namespace hub::force {
     template <typename Interactions, typename VectorArray>
     class InteractionData {
        public:
+        // Type members
+        using Scalar = typename VectorArray::value_type::value_type;
+
         // Constructors
         SPACEHUB_MAKE_CONSTRUCTORS(InteractionData, default, default, default, default, default);
 
@@ -161,6 +259,56 @@ namespace hub::force {
          */
         SPACEHUB_ARRAY_ACCESSOR(VectorArray, ext_vel_dep_acc, ext_vel_dep_acc_);
 
+        /**
+         * @brief Potential energy evaluated as a by-product of the last force pass.
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(Scalar, potential, potential_);
+
+        /**
+         * @brief Does `potential()` still belong to the current positions and masses? The owner system resets it
+         * on every position update, on chain rebuilds and whenever its writable `pos()`/`mass()` are taken.
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(bool, potential_valid, potential_valid_);
+
+        /**
+         * @brief Compact pair list of the forces that declare `compact_pairs_only`.
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(CompactPairs, compact_pairs, compact_pairs_);
+
+        /**
+         * @brief Key of the storage layout of the owner system(see `force::LayoutKey`).
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(LayoutKey, layout_key, layout_key_);
+
+        /**
+         * @brief Relative tolerance of the run, read by the forces that adapt their accuracy to it(e.g.
+         * `MixedNewtonianGrav`, `FMMGrav`). Zero if unset.
+         *
+         */
+        SPACEHUB_STD_ACCESSOR(double, rtol, rtol_);
+
+        /**
+         * @brief Evaluate `Interactions::eval_acc` and keep the potential energy if it comes for free.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         */
+        template <typename Particles>
+        void eval_acc(Particles const &particles, VectorArray &acceleration);
+
+        /**
+         * @brief Evaluate `Interactions::eval_newtonian_acc` and keep the potential energy if it comes for free.
+         *
+         * @param[in] particles The particle system need to be evaluated.
+         * @param[out] acceleration The output of the evaluated acceleration.
+         */
+        template <typename Particles>
+        void eval_newtonian_acc(Particles const &particles, VectorArray &acceleration);
+
        private:
         VectorArray acc_{0};
 
@@ -171,32 +319,147 @@ namespace hub::force {
         std::conditional_t<Interactions::ext_vel_indep, VectorArray, Empty> ext_vel_indep_acc_;
 
         std::conditional_t<Interactions::ext_vel_dep, VectorArray, Empty> ext_vel_dep_acc_;
+
+        Scalar potential_{0};
+
+        bool potential_valid_{false};
+
+        CompactPairs compact_pairs_;
+
+        LayoutKey layout_key_;
+
+        double rtol_{0};
     };
-    template <typename Arg, typename... Args>
-    struct InvokeVelDepForce {
+    template <typename Force>
+    struct AllForce : std::true_type {};
+
+    template <typename Force>
+    struct VelDepForce : std::bool_constant<Force::vel_dependent> {};
+
+    template <typename Force>
+    struct VelIndepForce : std::bool_constant<!Force::vel_dependent> {};
+
+    /**
+     * @brief Add the acceleration of the forces selected by `Select` from `Forces`.
+     *
+     * If two or more of the selected forces provide `add_pair_acc`, they share one walk over the particle pairs
+     * (see `force::for_each_pair`) so dr, r, 1/r and 1/r^3 are computed once per pair instead of once per force.
+     * If the particle system keeps an active compact pair list(see `force::CompactPairs`), the forces declaring
+     * `compact_pairs_only` share a second walk over the listed pairs instead. The remaining forces are evaluated by
+     * their own `add_acc_to`.
+     *
+     * @tparam Select Unary type predicate on the force type.
+     * @tparam Forces Force types.
+     */
+    template <template <typename> class Select, typename... Forces>
+    struct FusedForces {
         template <CONCEPT_PARTICLES_DATA Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration) {
-            if constexpr (Arg::vel_dependent) {
-                Arg::add_acc_to(particles, acceleration);
+            typename Particles::Scalar unused{0};
+            add_acc_impl<false>(particles, acceleration, unused);
+        }
+
+        /**
+         * @brief Same as above, the forces that can evaluate their potential energy as a by-product of the
+         * acceleration (see `pair_loop::has_potential`) also add it to `potential`.
+         */
+        template <CONCEPT_PARTICLES_DATA Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration,
+                               typename Particles::Scalar &potential) {
+            add_acc_impl<true>(particles, acceleration, potential);
+        }
+
+       private:
+        /**
+         * @brief Pair walks of the fused forces. `All` is used if no compact pair list is active, otherwise `Full`
+         * and `Compact`.
+         */
+        enum class Walk { All, Full, Compact };
+
+        template <typename Force, typename Particles, Walk W>
+        static constexpr bool walks_in() {
+            if constexpr (Select<Force>::value && pair_loop::is_pair_force<Force, Particles>) {
+                return W == Walk::All || (W == Walk::Compact) == pair_loop::is_compact_force<Force>();
+            } else {
+                return false;
             }
-            if constexpr (sizeof...(Args) > 0) {
-                InvokeVelDepForce<Args...>::add_acc_to(particles, acceleration);
+        }
+
+        template <typename Particles, Walk W>
+        struct in_walk {
+            static constexpr size_t num{(0 + ... + size_t(walks_in<Forces, Particles, W>()))};
+
+            static constexpr bool with_vel{(... || (walks_in<Forces, Particles, W>() && Forces::vel_dependent))};
+        };
+
+        template <bool WithPot, typename Particles>
+        static void add_acc_impl(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                 typename Particles::Scalar &potential) {
+            constexpr size_t pair_force_num =
+                (0 + ... + size_t(Select<Forces>::value && pair_loop::is_pair_force<Forces, Particles>));
+
+            if constexpr (pair_force_num > 1) {
+                (add_unfused<WithPot, Forces>(particles, acceleration, potential), ...);
+
+                if (compact_pairs_active(particles)) {
+                    if constexpr (in_walk<Particles, Walk::Full>::num > 0) {
+                        for_each_pair<in_walk<Particles, Walk::Full>::with_vel>(particles, [&](auto const &pair) {
+                            (add_fused_pair<WithPot, Walk::Full, Forces>(particles, pair, acceleration, potential),
+                             ...);
+                        });
+                    }
+                    if constexpr (in_walk<Particles, Walk::Compact>::num > 0) {
+                        for_each_compact_pair<in_walk<Particles, Walk::Compact>::with_vel>(
+                            particles, [&](auto const &pair) {
+                                (add_fused_pair<WithPot, Walk::Compact, Forces>(particles, pair, acceleration,
+                                                                                potential),
+                                 ...);
+                            });
+                    }
+                } else {
+                    for_each_pair<in_walk<Particles, Walk::All>::with_vel>(particles, [&](auto const &pair) {
+                        (add_fused_pair<WithPot, Walk::All, Forces>(particles, pair, acceleration, potential), ...);
+                    });
+                }
+            } else {
+                (add_selected<WithPot, Forces>(particles, acceleration, potential), ...);
             }
         }
-    };
 
-    template <typename Arg, typename... Args>
-    struct InvokeVelIndepForce {
-        template <CONCEPT_PARTICLES_DATA Particles>
-        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration) {
-            if constexpr (!Arg::vel_dependent) {
-                Arg::add_acc_to(particles, acceleration);
+        template <bool WithPot, typename Force, typename Particles>
+        static void add_selected(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                 typename Particles::Scalar &potential) {
+            if constexpr (Select<Force>::value) {
+                if constexpr (WithPot && pair_loop::has_potential<Force, Particles>) {
+                    Force::add_acc_to(particles, acceleration, potential);
+                } else {
+                    Force::add_acc_to(particles, acceleration);
+                }
             }
-            if constexpr (sizeof...(Args) > 0) {
-                InvokeVelIndepForce<Args...>::add_acc_to(particles, acceleration);
+        }
+
+        template <bool WithPot, typename Force, typename Particles>
+        static void add_unfused(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                typename Particles::Scalar &potential) {
+            if constexpr (!pair_loop::is_pair_force<Force, Particles>) {
+                add_selected<WithPot, Force>(particles, acceleration, potential);
+            }
+        }
+
+        template <bool WithPot, Walk W, typename Force, typename Particles, typename Pair>
+        static void add_fused_pair(Particles const &particles, Pair const &pair,
+                                   typename Particles::VectorArray &acceleration,
+                                   typename Particles::Scalar &potential) {
+            if constexpr (walks_in<Force, Particles, W>()) {
+                if constexpr (WithPot && pair_loop::has_pair_potential<Force, Particles>) {
+                    Force::add_pair_acc(particles, pair, acceleration, potential);
+                } else {
+                    Force::add_pair_acc(particles, pair, acceleration);
+                }
             }
         }
     };
+
     /*---------------------------------------------------------------------------*\
         Class Interactions Implementation
     \*---------------------------------------------------------------------------*/
@@ -206,8 +469,17 @@ namespace hub::force {
     void Interactions<InternalForce, ExtraForce...>::eval_acc(const Particles &particles,
                                                               typename Particles::VectorArray &acceleration) {
         calc::array_set_zero(acceleration);
-        InternalForce::add_acc_to(particles, acceleration);
-        (ExtraForce::add_acc_to(particles, acceleration), ...);
+        FusedForces<AllForce, InternalForce, ExtraForce...>::add_acc_to(particles, acceleration);
+    }
+
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles>
+    void Interactions<InternalForce, ExtraForce...>::eval_acc(const Particles &particles,
+                                                              typename Particles::VectorArray &acceleration,
+                                                              typename Particles::Scalar &potential) {
+        calc::array_set_zero(acceleration);
+        potential = 0;
+        FusedForces<AllForce, InternalForce, ExtraForce...>::add_acc_to(particles, acceleration, potential);
     }
 
     template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
@@ -216,12 +488,7 @@ namespace hub::force {
                                                                     typename Particles::VectorArray &acceleration) {
         if constexpr (ext_vel_dep || ext_vel_indep) {
             calc::array_set_zero(acceleration);
-        }
-        if constexpr (ext_vel_dep) {
-            InvokeVelDepForce<ExtraForce...>::add_acc_to(particles, acceleration);
-        }
-        if constexpr (ext_vel_indep) {
-            InvokeVelIndepForce<ExtraForce...>::add_acc_to(particles, acceleration);
+            FusedForces<AllForce, ExtraForce...>::add_acc_to(particles, acceleration);
         }
     }
 
@@ -231,7 +498,7 @@ namespace hub::force {
         const Particles &particles, typename Particles::VectorArray &acceleration) {
         if constexpr (ext_vel_dep) {
             calc::array_set_zero(acceleration);
-            InvokeVelDepForce<ExtraForce...>::add_acc_to(particles, acceleration);
+            FusedForces<VelDepForce, ExtraForce...>::add_acc_to(particles, acceleration);
         }
     }
 
@@ -241,7 +508,7 @@ namespace hub::force {
         const Particles &particles, typename Particles::VectorArray &acceleration) {
         if constexpr (ext_vel_indep) {
             calc::array_set_zero(acceleration);
-            InvokeVelIndepForce<ExtraForce...>::add_acc_to(particles, acceleration);
+            FusedForces<VelIndepForce, ExtraForce...>::add_acc_to(particles, acceleration);
         }
     }
 
@@ -253,6 +520,16 @@ namespace hub::force {
         InternalForce::add_acc_to(particles, acceleration);
     }
 
+    template <CONCEPT_FORCE InternalForce, CONCEPT_FORCE... ExtraForce>
+    template <CONCEPT_PARTICLES_DATA Particles>
+    void Interactions<InternalForce, ExtraForce...>::eval_newtonian_acc(const Particles &particles,
+                                                                        typename Particles::VectorArray &acceleration,
+                                                                        typename Particles::Scalar &potential) {
+        calc::array_set_zero(acceleration);
+        potential = 0;
+        FusedForces<AllForce, InternalForce>::add_acc_to(particles, acceleration, potential);
+    }
+
     /*---------------------------------------------------------------------------*\
             Class InteractionData Implementation
     \*---------------------------------------------------------------------------*/
@@ -266,4 +543,27 @@ namespace hub::force {
             ext_vel_dep_acc_.resize(size);
         }
     }
+
+    template <typename Interactions, typename VectorArray>
+    template <typename Particles>
+    void InteractionData<Interactions, VectorArray>::eval_acc(const Particles &particles, VectorArray &acceleration) {
+        if constexpr (Interactions::template potential_by_product<Particles>) {
+            Interactions::eval_acc(particles, acceleration, potential_);
+            potential_valid_ = true;
+        } else {
+            Interactions::eval_acc(particles, acceleration);
+        }
+    }
+
+    template <typename Interactions, typename VectorArray>
+    template <typename Particles>
+    void InteractionData<Interactions, VectorArray>::eval_newtonian_acc(const Particles &particles,
+                                                                        VectorArray &acceleration) {
+        if constexpr (Interactions::template potential_by_product<Particles>) {
+            Interactions::eval_newtonian_acc(particles, acceleration, potential_);
+            potential_valid_ = true;
+        } else {
+            Interactions::eval_newtonian_acc(particles, acceleration);
+        }
+    }
 }  // namespace hub::force
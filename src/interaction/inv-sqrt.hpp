@@ -0,0 +1,157 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file inv-sqrt.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "../cpu-dispatch.hpp"
+
+#if defined(__SSE__)
+
+#include <immintrin.h>
+
+#endif
+
+namespace hub::force::kernel {
+    /**
+     * @brief Evaluation of 1/r from r^2 in the pair kernels.
+     */
+    enum class InvSqrt {
+        /**
+         * @brief sqrt followed by a division.
+         */
+        Exact,
+        /**
+         * @brief Hardware reciprocal square root estimate refined by Newton-Raphson iterations.
+         */
+        Newton
+    };
+
+    /**
+     * @brief How the double precision pair kernels(`NewtonianGrav`, the pair walk of `PN1`, `Tidal` and the other
+     * pair forces, `calc::calc_potential_energy`) evaluate 1/r and 1/r^3.
+     *
+     * `InvSqrt::Newton` replaces the sqrt and the division, the two slowest double instructions of the pair loop,
+     * by the AVX-512 `rsqrt14` estimate(two refinements) or the single precision SSE/AVX `rsqrt` estimate upcast
+     * to double(three refinements). The SIMD kernels take the estimate of the path `cpu::isa()` selects, the scalar
+     * remainders the one of the compile target. The result is within a few ulp of `InvSqrt::Exact`. Other scalar
+     * types and targets without these instructions always use `InvSqrt::Exact`.
+     */
+    inline InvSqrt inv_sqrt_policy{InvSqrt::Exact};
+
+    /**
+     * @brief Does a pair kernel of scalar type T use the Newton-Raphson reciprocal square root?
+     */
+    template <typename T>
+    inline bool use_newton_rsqrt() {
+        return std::is_same_v<T, double> && inv_sqrt_policy == InvSqrt::Newton;
+    }
+
+    namespace details {
+        template <typename T>
+        inline T newton_rsqrt_step(T x, T y) {
+            return y * (1.5 - 0.5 * x * y * y);
+        }
+
+        inline bool in_float_range(double x) {
+            return x >= static_cast<double>(std::numeric_limits<float>::min()) &&
+                   x <= static_cast<double>(std::numeric_limits<float>::max());
+        }
+    }  // namespace details
+
+    /**
+     * @brief 1/sqrt(x) from the hardware estimate refined to double precision.
+     */
+    inline double rsqrt_newton(double x) {
+#if defined(__AVX512F__)
+        __m128d const v = _mm_set_sd(x);
+        double y = _mm_cvtsd_f64(_mm_rsqrt14_sd(v, v));
+        y = details::newton_rsqrt_step(x, y);
+        return details::newton_rsqrt_step(x, y);
+#elif defined(__SSE__)
+        if (!details::in_float_range(x)) {
+            return 1.0 / std::sqrt(x);
+        }
+        double y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(static_cast<float>(x))));
+        y = details::newton_rsqrt_step(x, y);
+        y = details::newton_rsqrt_step(x, y);
+        return details::newton_rsqrt_step(x, y);
+#else
+        return 1.0 / std::sqrt(x);
+#endif
+    }
+
+    /**
+     * @brief Fallback for the scalar types without a hardware estimate.
+     */
+    template <typename T>
+    inline T rsqrt_newton(T x) {
+        using std::sqrt;
+        return 1 / sqrt(x);
+    }
+
+#if defined(SPACEHUB_AVX512_KERNEL)
+// GCC flags the undefined placeholder operands of the AVX-512 intrinsics once they are inlined into a target
+// attributed function.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    /**
+     * @brief Lane-wise 1/sqrt(x) from the `rsqrt14` estimate refined by two Newton-Raphson iterations.
+     */
+    SPACEHUB_TARGET_AVX512 inline __m512d rsqrt_newton(__m512d x) {
+        __m512d const half_x = _mm512_mul_pd(x, _mm512_set1_pd(0.5));
+        __m512d const three_half = _mm512_set1_pd(1.5);
+        __m512d y = _mm512_rsqrt14_pd(x);
+        y = _mm512_mul_pd(y, _mm512_sub_pd(three_half, _mm512_mul_pd(half_x, _mm512_mul_pd(y, y))));
+        y = _mm512_mul_pd(y, _mm512_sub_pd(three_half, _mm512_mul_pd(half_x, _mm512_mul_pd(y, y))));
+        return y;
+    }
+#pragma GCC diagnostic pop
+#endif
+
+#if defined(SPACEHUB_AVX2_KERNEL)
+    /**
+     * @brief Lane-wise 1/sqrt(x) from the single precision `rsqrt` estimate refined by three Newton-Raphson
+     * iterations. Blocks with a lane out of the single precision range fall back to sqrt and division.
+     */
+    SPACEHUB_TARGET_AVX2 inline __m256d rsqrt_newton(__m256d x) {
+        __m256d const lo = _mm256_set1_pd(static_cast<double>(std::numeric_limits<float>::min()));
+        __m256d const hi = _mm256_set1_pd(static_cast<double>(std::numeric_limits<float>::max()));
+        __m256d const in_range = _mm256_and_pd(_mm256_cmp_pd(x, lo, _CMP_GE_OQ), _mm256_cmp_pd(x, hi, _CMP_LE_OQ));
+        if (_mm256_movemask_pd(in_range) != 0xF) {
+            return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(x));
+        }
+        __m256d const half_x = _mm256_mul_pd(x, _mm256_set1_pd(0.5));
+        __m256d const three_half = _mm256_set1_pd(1.5);
+        __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(x)));
+        y = _mm256_mul_pd(y, _mm256_sub_pd(three_half, _mm256_mul_pd(half_x, _mm256_mul_pd(y, y))));
+        y = _mm256_mul_pd(y, _mm256_sub_pd(three_half, _mm256_mul_pd(half_x, _mm256_mul_pd(y, y))));
+        y = _mm256_mul_pd(y, _mm256_sub_pd(three_half, _mm256_mul_pd(half_x, _mm256_mul_pd(y, y))));
+        return y;
+    }
+#endif
+}  // namespace hub::force::kernel
@@ -18,17 +18,22 @@ License
     with SpaceHub.
 \*---------------------------------------------------------------------------*/
 /**
- * @file axis-symmetric.hpp
+ * @file magneto-disk.hpp
  *
  * Header file.
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "../dev-tools.hpp"
 #include "../macros.hpp"
 #include "../spacehub-concepts.hpp"
+#include "central-field.hpp"
 namespace hub::force {
-    static const std::vector<double> _GDF_I = {
+    inline constexpr std::array<double, 200> _GDF_I = {
         0.03353477310756164,    0.034734392236140756,   0.035978060412398705,   0.03726752096204775,
         0.03860460002519508,    0.03999121194153265,    0.04142936512106664,    0.0429211684550382,
         0.04446883832868869,    0.04607470630560932,    0.047741227562810094,   0.04947099016618135,
@@ -79,208 +84,208 @@ namespace hub::force {
         0.000429205207489882,   0.00040042002832459616, 0.0003735652726685521,  0.0003485114920231916,
         0.00032513791680695617, 0.00030333187467122244, 0.00028298824777671524, 0.0002640089664241957,
         0.00024630253660710614, 0.0002297835992162493,  0.00021437251877811514, 0.00019999499974998334};
-    static const std::vector<double> _GDF_lgM = {-1.0,
-                                                 -0.9849246231155779,
-                                                 -0.9698492462311558,
-                                                 -0.9547738693467337,
-                                                 -0.9396984924623115,
-                                                 -0.9246231155778895,
-                                                 -0.9095477386934674,
-                                                 -0.8944723618090452,
-                                                 -0.8793969849246231,
-                                                 -0.864321608040201,
-                                                 -0.8492462311557789,
-                                                 -0.8341708542713568,
-                                                 -0.8190954773869347,
-                                                 -0.8040201005025126,
-                                                 -0.7889447236180904,
-                                                 -0.7738693467336684,
-                                                 -0.7587939698492463,
-                                                 -0.7437185929648241,
-                                                 -0.728643216080402,
-                                                 -0.7135678391959799,
-                                                 -0.6984924623115578,
-                                                 -0.6834170854271358,
-                                                 -0.6683417085427136,
-                                                 -0.6532663316582914,
-                                                 -0.6381909547738693,
-                                                 -0.6231155778894473,
-                                                 -0.6080402010050252,
-                                                 -0.592964824120603,
-                                                 -0.5778894472361809,
-                                                 -0.5628140703517588,
-                                                 -0.5477386934673367,
-                                                 -0.5326633165829147,
-                                                 -0.5175879396984925,
-                                                 -0.5025125628140703,
-                                                 -0.48743718592964824,
-                                                 -0.4723618090452261,
-                                                 -0.457286432160804,
-                                                 -0.4422110552763819,
-                                                 -0.42713567839195987,
-                                                 -0.4120603015075377,
-                                                 -0.39698492462311563,
-                                                 -0.38190954773869346,
-                                                 -0.3668341708542714,
-                                                 -0.3517587939698493,
-                                                 -0.33668341708542715,
-                                                 -0.3216080402010051,
-                                                 -0.3065326633165829,
-                                                 -0.2914572864321609,
-                                                 -0.2763819095477386,
-                                                 -0.2613065326633166,
-                                                 -0.2462311557788945,
-                                                 -0.23115577889447236,
-                                                 -0.21608040201005027,
-                                                 -0.2010050251256281,
-                                                 -0.18592964824120603,
-                                                 -0.17085427135678397,
-                                                 -0.15577889447236182,
-                                                 -0.14070351758793972,
-                                                 -0.12562814070351758,
-                                                 -0.11055276381909553,
-                                                 -0.09547738693467346,
-                                                 -0.08040201005025127,
-                                                 -0.06532663316582918,
-                                                 -0.05025125628140704,
-                                                 -0.03517587939698496,
-                                                 -0.020100502512562922,
-                                                 -0.005025125628140743,
-                                                 0.010050251256281438,
-                                                 0.02512562814070352,
-                                                 0.040201005025125615,
-                                                 0.05527638190954762,
-                                                 0.07035175879396968,
-                                                 0.08542713567839198,
-                                                 0.10050251256281402,
-                                                 0.11557788944723611,
-                                                 0.13065326633165816,
-                                                 0.14572864321608026,
-                                                 0.16080402010050251,
-                                                 0.17587939698492458,
-                                                 0.1909547738693467,
-                                                 0.2060301507537687,
-                                                 0.2211055276381908,
-                                                 0.23618090452261306,
-                                                 0.25125628140703515,
-                                                 0.2663316582914572,
-                                                 0.2814070351758793,
-                                                 0.29648241206030135,
-                                                 0.31155778894472363,
-                                                 0.3266331658291457,
-                                                 0.34170854271356776,
-                                                 0.35678391959798983,
-                                                 0.3718592964824119,
-                                                 0.3869346733668342,
-                                                 0.40201005025125625,
-                                                 0.4170854271356783,
-                                                 0.4321608040201003,
-                                                 0.44723618090452266,
-                                                 0.4623115577889447,
-                                                 0.4773869346733668,
-                                                 0.49246231155778886,
-                                                 0.5075376884422109,
-                                                 0.5226130653266332,
-                                                 0.5376884422110553,
-                                                 0.5527638190954773,
-                                                 0.5678391959798994,
-                                                 0.5829145728643215,
-                                                 0.5979899497487438,
-                                                 0.6130653266331658,
-                                                 0.6281407035175879,
-                                                 0.64321608040201,
-                                                 0.658291457286432,
-                                                 0.6733668341708543,
-                                                 0.6884422110552764,
-                                                 0.7035175879396984,
-                                                 0.7185929648241205,
-                                                 0.7336683417085426,
-                                                 0.7487437185929648,
-                                                 0.7638190954773869,
-                                                 0.778894472361809,
-                                                 0.793969849246231,
-                                                 0.8090452261306531,
-                                                 0.8241206030150754,
-                                                 0.8391959798994975,
-                                                 0.8542713567839195,
-                                                 0.8693467336683416,
-                                                 0.8844221105527637,
-                                                 0.8994974874371859,
-                                                 0.914572864321608,
-                                                 0.9296482412060301,
-                                                 0.9447236180904521,
-                                                 0.9597989949748742,
-                                                 0.9748743718592965,
-                                                 0.9899497487437185,
-                                                 1.0050251256281406,
-                                                 1.020100502512563,
-                                                 1.0351758793969847,
-                                                 1.050251256281407,
-                                                 1.0653266331658289,
-                                                 1.0804020100502512,
-                                                 1.0954773869346734,
-                                                 1.1105527638190953,
-                                                 1.1256281407035176,
-                                                 1.1407035175879394,
-                                                 1.1557788944723617,
-                                                 1.170854271356784,
-                                                 1.1859296482412058,
-                                                 1.2010050251256281,
-                                                 1.21608040201005,
-                                                 1.2311557788944723,
-                                                 1.2462311557788945,
-                                                 1.2613065326633164,
-                                                 1.2763819095477387,
-                                                 1.2914572864321605,
-                                                 1.3065326633165828,
-                                                 1.321608040201005,
-                                                 1.336683417085427,
-                                                 1.3517587939698492,
-                                                 1.366834170854271,
-                                                 1.3819095477386933,
-                                                 1.3969849246231156,
-                                                 1.4120603015075375,
-                                                 1.4271356783919598,
-                                                 1.4422110552763816,
-                                                 1.457286432160804,
-                                                 1.4723618090452262,
-                                                 1.487437185929648,
-                                                 1.5025125628140703,
-                                                 1.5175879396984921,
-                                                 1.5326633165829144,
-                                                 1.5477386934673367,
-                                                 1.5628140703517586,
-                                                 1.5778894472361809,
-                                                 1.5929648241206027,
-                                                 1.608040201005025,
-                                                 1.6231155778894473,
-                                                 1.6381909547738691,
-                                                 1.6532663316582914,
-                                                 1.6683417085427132,
-                                                 1.6834170854271355,
-                                                 1.6984924623115578,
-                                                 1.7135678391959797,
-                                                 1.728643216080402,
-                                                 1.7437185929648238,
-                                                 1.758793969849246,
-                                                 1.7738693467336684,
-                                                 1.7889447236180902,
-                                                 1.8040201005025125,
-                                                 1.8190954773869343,
-                                                 1.8341708542713566,
-                                                 1.849246231155779,
-                                                 1.8643216080402008,
-                                                 1.879396984924623,
-                                                 1.8944723618090453,
-                                                 1.9095477386934672,
-                                                 1.9246231155778895,
-                                                 1.9396984924623113,
-                                                 1.9547738693467336,
-                                                 1.9698492462311559,
-                                                 1.9849246231155777,
-                                                 2.0};
-
-    static const std::vector<double> _mag_disk_lgr_cgs = {
+    inline constexpr std::array<double, 200> _GDF_lgM = {-1.0,
+                                                         -0.9849246231155779,
+                                                         -0.9698492462311558,
+                                                         -0.9547738693467337,
+                                                         -0.9396984924623115,
+                                                         -0.9246231155778895,
+                                                         -0.9095477386934674,
+                                                         -0.8944723618090452,
+                                                         -0.8793969849246231,
+                                                         -0.864321608040201,
+                                                         -0.8492462311557789,
+                                                         -0.8341708542713568,
+                                                         -0.8190954773869347,
+                                                         -0.8040201005025126,
+                                                         -0.7889447236180904,
+                                                         -0.7738693467336684,
+                                                         -0.7587939698492463,
+                                                         -0.7437185929648241,
+                                                         -0.728643216080402,
+                                                         -0.7135678391959799,
+                                                         -0.6984924623115578,
+                                                         -0.6834170854271358,
+                                                         -0.6683417085427136,
+                                                         -0.6532663316582914,
+                                                         -0.6381909547738693,
+                                                         -0.6231155778894473,
+                                                         -0.6080402010050252,
+                                                         -0.592964824120603,
+                                                         -0.5778894472361809,
+                                                         -0.5628140703517588,
+                                                         -0.5477386934673367,
+                                                         -0.5326633165829147,
+                                                         -0.5175879396984925,
+                                                         -0.5025125628140703,
+                                                         -0.48743718592964824,
+                                                         -0.4723618090452261,
+                                                         -0.457286432160804,
+                                                         -0.4422110552763819,
+                                                         -0.42713567839195987,
+                                                         -0.4120603015075377,
+                                                         -0.39698492462311563,
+                                                         -0.38190954773869346,
+                                                         -0.3668341708542714,
+                                                         -0.3517587939698493,
+                                                         -0.33668341708542715,
+                                                         -0.3216080402010051,
+                                                         -0.3065326633165829,
+                                                         -0.2914572864321609,
+                                                         -0.2763819095477386,
+                                                         -0.2613065326633166,
+                                                         -0.2462311557788945,
+                                                         -0.23115577889447236,
+                                                         -0.21608040201005027,
+                                                         -0.2010050251256281,
+                                                         -0.18592964824120603,
+                                                         -0.17085427135678397,
+                                                         -0.15577889447236182,
+                                                         -0.14070351758793972,
+                                                         -0.12562814070351758,
+                                                         -0.11055276381909553,
+                                                         -0.09547738693467346,
+                                                         -0.08040201005025127,
+                                                         -0.06532663316582918,
+                                                         -0.05025125628140704,
+                                                         -0.03517587939698496,
+                                                         -0.020100502512562922,
+                                                         -0.005025125628140743,
+                                                         0.010050251256281438,
+                                                         0.02512562814070352,
+                                                         0.040201005025125615,
+                                                         0.05527638190954762,
+                                                         0.07035175879396968,
+                                                         0.08542713567839198,
+                                                         0.10050251256281402,
+                                                         0.11557788944723611,
+                                                         0.13065326633165816,
+                                                         0.14572864321608026,
+                                                         0.16080402010050251,
+                                                         0.17587939698492458,
+                                                         0.1909547738693467,
+                                                         0.2060301507537687,
+                                                         0.2211055276381908,
+                                                         0.23618090452261306,
+                                                         0.25125628140703515,
+                                                         0.2663316582914572,
+                                                         0.2814070351758793,
+                                                         0.29648241206030135,
+                                                         0.31155778894472363,
+                                                         0.3266331658291457,
+                                                         0.34170854271356776,
+                                                         0.35678391959798983,
+                                                         0.3718592964824119,
+                                                         0.3869346733668342,
+                                                         0.40201005025125625,
+                                                         0.4170854271356783,
+                                                         0.4321608040201003,
+                                                         0.44723618090452266,
+                                                         0.4623115577889447,
+                                                         0.4773869346733668,
+                                                         0.49246231155778886,
+                                                         0.5075376884422109,
+                                                         0.5226130653266332,
+                                                         0.5376884422110553,
+                                                         0.5527638190954773,
+                                                         0.5678391959798994,
+                                                         0.5829145728643215,
+                                                         0.5979899497487438,
+                                                         0.6130653266331658,
+                                                         0.6281407035175879,
+                                                         0.64321608040201,
+                                                         0.658291457286432,
+                                                         0.6733668341708543,
+                                                         0.6884422110552764,
+                                                         0.7035175879396984,
+                                                         0.7185929648241205,
+                                                         0.7336683417085426,
+                                                         0.7487437185929648,
+                                                         0.7638190954773869,
+                                                         0.778894472361809,
+                                                         0.793969849246231,
+                                                         0.8090452261306531,
+                                                         0.8241206030150754,
+                                                         0.8391959798994975,
+                                                         0.8542713567839195,
+                                                         0.8693467336683416,
+                                                         0.8844221105527637,
+                                                         0.8994974874371859,
+                                                         0.914572864321608,
+                                                         0.9296482412060301,
+                                                         0.9447236180904521,
+                                                         0.9597989949748742,
+                                                         0.9748743718592965,
+                                                         0.9899497487437185,
+                                                         1.0050251256281406,
+                                                         1.020100502512563,
+                                                         1.0351758793969847,
+                                                         1.050251256281407,
+                                                         1.0653266331658289,
+                                                         1.0804020100502512,
+                                                         1.0954773869346734,
+                                                         1.1105527638190953,
+                                                         1.1256281407035176,
+                                                         1.1407035175879394,
+                                                         1.1557788944723617,
+                                                         1.170854271356784,
+                                                         1.1859296482412058,
+                                                         1.2010050251256281,
+                                                         1.21608040201005,
+                                                         1.2311557788944723,
+                                                         1.2462311557788945,
+                                                         1.2613065326633164,
+                                                         1.2763819095477387,
+                                                         1.2914572864321605,
+                                                         1.3065326633165828,
+                                                         1.321608040201005,
+                                                         1.336683417085427,
+                                                         1.3517587939698492,
+                                                         1.366834170854271,
+                                                         1.3819095477386933,
+                                                         1.3969849246231156,
+                                                         1.4120603015075375,
+                                                         1.4271356783919598,
+                                                         1.4422110552763816,
+                                                         1.457286432160804,
+                                                         1.4723618090452262,
+                                                         1.487437185929648,
+                                                         1.5025125628140703,
+                                                         1.5175879396984921,
+                                                         1.5326633165829144,
+                                                         1.5477386934673367,
+                                                         1.5628140703517586,
+                                                         1.5778894472361809,
+                                                         1.5929648241206027,
+                                                         1.608040201005025,
+                                                         1.6231155778894473,
+                                                         1.6381909547738691,
+                                                         1.6532663316582914,
+                                                         1.6683417085427132,
+                                                         1.6834170854271355,
+                                                         1.6984924623115578,
+                                                         1.7135678391959797,
+                                                         1.728643216080402,
+                                                         1.7437185929648238,
+                                                         1.758793969849246,
+                                                         1.7738693467336684,
+                                                         1.7889447236180902,
+                                                         1.8040201005025125,
+                                                         1.8190954773869343,
+                                                         1.8341708542713566,
+                                                         1.849246231155779,
+                                                         1.8643216080402008,
+                                                         1.879396984924623,
+                                                         1.8944723618090453,
+                                                         1.9095477386934672,
+                                                         1.9246231155778895,
+                                                         1.9396984924623113,
+                                                         1.9547738693467336,
+                                                         1.9698492462311559,
+                                                         1.9849246231155777,
+                                                         2.0};
+
+    inline constexpr std::array<double, 252> _mag_disk_lgr_cgs = {
         10.848169570835784, 10.859134940659754, 10.870074926723767, 10.881024445344949, 10.89201486057357,
         10.902960824351105, 10.913932586562831, 10.924885589614927, 10.93584953080633,  10.946782718423142,
         10.957747351495597, 10.968701922991093, 10.979672130541898, 10.990619207942363, 11.001598376550799,
@@ -333,7 +338,7 @@ namespace hub::force {
         13.533764090443672, 13.544723214961603, 13.555681733888772, 13.56664937008129,  13.577610728997579,
         13.588575134557013, 13.599535635149245};
 
-    static const std::vector<double> _mag_disk_lgrho_cgs = {
+    inline constexpr std::array<double, 252> _mag_disk_lgrho_cgs = {
         -2.71526350508578,   -2.711456477359652,  -2.7157736396180883, -2.7314689820458367, -2.7614082652385026,
         -2.8140202802923477, -2.892999970109418,  -2.997477767306345,  -3.1430203359765394, -3.3289490056862174,
         -3.5600302786958,    -3.810392751346183,  -4.13789715897176,   -4.472723437905198,  -4.927878306374829,
@@ -386,7 +391,7 @@ namespace hub::force {
         -13.529924433774621, -13.555242499272813, -13.579261145992765, -13.604488739068536, -13.628898102479122,
         -13.653211911190022, -13.677680342984816};
 
-    static const std::vector<double> _mag_disk_lgH_cgs = {
+    inline constexpr std::array<double, 252> _mag_disk_lgH_cgs = {
         10.848075643604924, 10.859041013428895, 10.869980999492908, 10.88093051811409,  10.891920933342709,
         10.902866897120246, 10.913838659331972, 10.924791662384067, 10.935755603575469, 10.946688791192281,
         10.957653424264736, 10.968607995760234, 10.979578203311037, 10.990525280711502, 11.001504449319938,
@@ -439,7 +444,7 @@ namespace hub::force {
         13.096439967538423, 13.11345215525121,  13.129320524958173, 13.140288161150691, 13.15124952006698,
         13.162213925626414, 13.173174426218646};
 
-    static const std::vector<double> _mag_disk_v_cgs = {
+    inline constexpr std::array<double, 252> _mag_disk_v_cgs = {
         2434.8078260999755,  4145.470221161596,   4676.8416205963,     4408.808386110136,   2668.318490456546,
         -1457.266730310404,  -9807.171722414942,  -23345.542824436357, -39278.39939064638,  -53514.126409285585,
         -67504.05272860208,  -73417.07854039887,  -63462.15021782927,  -58287.90740680579,  -79957.03422574908,
@@ -492,85 +497,149 @@ namespace hub::force {
         1770869.757367632,   1745323.0554717325,  1721433.436942054,   1696577.1864487466,  1672963.7484801044,
         1649626.4910724992,  1626427.3239454124};
 
-    class MagnetoDisk {
+    /*---------------------------------------------------------------------------*\
+         Class MagnetoDiskProfile Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Disk density, scale height and rotation speed of the tables `_mag_disk_*_cgs`, in code units.
+     *
+     * Every interval of `_mag_disk_lgr_cgs` is split into `oversample` sub-intervals whose nodes hold the log-space
+     * interpolation of the tables, converted to code units and linear space once. Within a sub-interval the density
+     * and the scale height are the node values times exp(t * dln), with the exponential evaluated by a degree 6
+     * Taylor polynomial(|t * dln| < 0.12 for the shipped tables, relative error < 1e-10), and the speed is linear.
+     * A lookup is therefore the log-space interpolation of the tables without `pow` and without branches. Outside
+     * the tabulated radii the edge values are returned.
+     */
+    class MagnetoDiskProfile {
+       public:
+        struct Sample {
+            double rho;
+            double H;
+            double v;
+        };
+
+        /**
+         * @brief Number of sub-intervals per interval of `_mag_disk_lgr_cgs`.
+         */
+        constexpr static size_t oversample{16};
+
+        constexpr static size_t intervals{_mag_disk_lgr_cgs.size() - 1};
+
+        constexpr static size_t size{intervals * oversample + 1};
+
+        /**
+         * @brief The shared table, built on first use.
+         */
+        static MagnetoDiskProfile const &table() {
+            static const MagnetoDiskProfile profile;
+            return profile;
+        }
+
+        /**
+         * @brief Disk profile at the cylindrical radius R(in code units).
+         */
+        template <typename Scalar>
+        SPACEHUB_FORCE_INLINE Sample operator()(Scalar R) const {
+            using std::log10;
+            auto const &lgr = _mag_disk_lgr_cgs;
+            double x = std::clamp(static_cast<double>(log10(R)) - lg_cm_, lgr.front(), lgr.back());
+
+            // the radial grid is uniform to 1% of its spacing, one correction step finds the interval(x at the outer
+            // edge lands on the padding interval). The indices are int since the SIMD conversions from double only
+            // exist for 32 bit integers before AVX-512.
+            int idx = std::min(static_cast<int>((x - lgr.front()) * inv_dlg_r_), static_cast<int>(intervals) - 1);
+            idx += static_cast<int>(x >= lgr[idx + 1]) - static_cast<int>(x < lgr[idx]);
+
+            Slope const &slope = slopes_[idx];
+            double u = (x - lgr[idx]) * slope.inv_width;
+            int sub = std::min(static_cast<int>(u), static_cast<int>(oversample) - 1);
+            double t = u - static_cast<double>(sub);
+
+            Sample const &node = nodes_[idx * oversample + sub];
+            return Sample{node.rho * exp_taylor(t * slope.dln_rho), node.H * exp_taylor(t * slope.dln_H),
+                          node.v + t * slope.dv};
+        }
+
+       private:
+        /**
+         * @brief Per interval of `_mag_disk_lgr_cgs`: inverse sub-interval width in log10(R), and the change of
+         * ln(rho), ln(H) and v over one sub-interval. The last entry pads the outer edge with zero slopes.
+         */
+        struct Slope {
+            double inv_width;
+            double dln_rho;
+            double dln_H;
+            double dv;
+        };
+
+        constexpr static double rho_unit{5.893333333333333e-07};
+        constexpr static double H_unit{1.5e13};
+        constexpr static double v_unit{3.357318203286629e-07};
+
+        MagnetoDiskProfile();
+
+        SPACEHUB_FORCE_INLINE static double exp_taylor(double y) {
+            return 1 + y * (1 + y / 2 * (1 + y / 3 * (1 + y / 4 * (1 + y / 5 * (1 + y / 6)))));
+        }
+
+        std::array<Sample, size> nodes_;
+        std::array<Slope, intervals + 1> slopes_;
+        double lg_cm_;
+        double inv_dlg_r_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class MagnetoDisk Declaration
+    \*---------------------------------------------------------------------------*/
+    class MagnetoDisk : public CentralField<MagnetoDisk> {
        public:
-        constexpr static bool vel_dependent{true};
         // Type members
-        template <typename Particles>
-        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+        /**
+         * @brief The profile table, fetched once per force evaluation.
+         */
+        struct Context {
+            MagnetoDiskProfile const *profile;
+        };
+
+        static Context central_context() { return Context{&MagnetoDiskProfile::table()}; }
+
+        template <typename Vector, typename Scalar>
+        SPACEHUB_FORCE_INLINE static Vector central_force(CentralSample<Vector, Scalar> const &s, Context const &ctx);
 
         template <typename Vec>
-        static double disk_rho(Vec &r) {
-            auto R = sqrt(r.x * r.x + r.y * r.y) / unit::cm;
-            auto lgR = log10(R);
-            auto lgRmin = _mag_disk_lgr_cgs[0];
-            auto lgRmax = _mag_disk_lgr_cgs[_mag_disk_lgr_cgs.size() - 1];
-            auto lgrholo = _mag_disk_lgrho_cgs[0];
-            auto lgrhohi = _mag_disk_lgrho_cgs[_mag_disk_lgrho_cgs.size() - 1];
-
-            if (lgR < lgRmin) {
-                return pow(10, lgrholo) / 5.893333333333333e-07;
-            } else if (lgR >= lgRmax) {
-                return pow(10, lgrhohi) / 5.893333333333333e-07;
-            } else {
-                auto lgrho = interpolate(lgR, _mag_disk_lgr_cgs, _mag_disk_lgrho_cgs);
-                return pow(10, lgrho) / 5.893333333333333e-07;
-            }
+        static double disk_rho(Vec const &r) {
+            return MagnetoDiskProfile::table()(sqrt(r.x * r.x + r.y * r.y)).rho;
         }
 
         template <typename Vec>
-        static double disk_H(Vec &r) {
-            auto R = sqrt(r.x * r.x + r.y * r.y) / unit::cm;
-            auto lgR = log10(R);
-            auto lgRmin = _mag_disk_lgr_cgs[0];
-            auto lgRmax = _mag_disk_lgr_cgs[_mag_disk_lgr_cgs.size() - 1];
-            auto lgHlo = _mag_disk_lgH_cgs[0];
-            auto lgHhi = _mag_disk_lgH_cgs[_mag_disk_lgH_cgs.size() - 1];
-
-            if (lgR < lgRmin) {
-                return pow(10, lgHlo) / 1.5e13;
-            } else if (lgR >= lgRmax) {
-                return pow(10, lgHhi) / 1.5e13;
-            } else {
-                auto lgH = interpolate(lgR, _mag_disk_lgr_cgs, _mag_disk_lgH_cgs);
-                return pow(10, lgH) / 1.5e13;
-            }
+        static double disk_H(Vec const &r) {
+            return MagnetoDiskProfile::table()(sqrt(r.x * r.x + r.y * r.y)).H;
         }
 
         template <typename Vec>
-        static Vec disk_v(Vec &r) {
+        static Vec disk_v(Vec const &r) {
             auto rr = sqrt(r.x * r.x + r.y * r.y);
-            auto R = rr / unit::cm;
-            auto lgR = log10(R);
-            auto lgRmin = _mag_disk_lgr_cgs[0];
-            auto lgRmax = _mag_disk_lgr_cgs[_mag_disk_lgr_cgs.size() - 1];
-            auto vlo = _mag_disk_v_cgs[0] * 3.357318203286629e-07;
-            auto vhi = _mag_disk_v_cgs[_mag_disk_v_cgs.size() - 1] * 3.357318203286629e-07;
-
-            if (lgR < lgRmin) {
-                return Vec{-vlo * r.y / rr, vlo * r.x / rr, 0};
-            } else if (lgR >= lgRmax) {
-                return Vec{-vhi * r.y / rr, vhi * r.x / rr, 0};
-            } else {
-                auto v = interpolate(lgR, _mag_disk_lgr_cgs, _mag_disk_v_cgs) * 3.357318203286629e-07;
-                return Vec{-v * r.y / rr, v * r.x / rr, 0};
-            }
+            auto v = MagnetoDiskProfile::table()(rr).v;
+            return Vec{-v * r.y / rr, v * r.x / rr, 0};
         }
 
+        /**
+         * @brief Dynamical friction integral at Mach number M: M/3 below the table, 0 above it. The table lookup
+         * is evaluated on the clamped Mach number and the result selected afterwards, without branches.
+         */
         template <typename Scalar>
-        static Scalar GDF_I(Scalar M) {
-            auto lgM = log10(M);
-            if (lgM < _GDF_lgM[0]) {
-                return M / 3.0;
-            } else if (lgM >= _GDF_lgM[_GDF_lgM.size() - 1]) {
-                return 0;
-            } else {
-                return interpolate(lgM, _GDF_lgM, _GDF_I);
-            }
+        SPACEHUB_FORCE_INLINE static Scalar GDF_I(Scalar M) {
+            constexpr double lgM_min = _GDF_lgM.front();
+            constexpr double lgM_max = _GDF_lgM.back();
+            Scalar lgM = log10(M);
+            Scalar I = interpolate(std::clamp(lgM, Scalar(lgM_min), Scalar(lgM_max)), _GDF_lgM, _GDF_I);
+            I = lgM < lgM_min ? Scalar(M / 3.0) : I;
+            return lgM >= lgM_max ? Scalar(0) : I;
         }
-        template <typename Scalar>
-        static double interpolate(Scalar x, std::vector<double> const &xarry, std::vector<double> const &yarray) {
-            size_t idx = int((x - xarry[0]) / (xarry[1] - xarry[0]));
+
+        template <typename Scalar, typename Array>
+        SPACEHUB_FORCE_INLINE static double interpolate(Scalar x, Array const &xarry, Array const &yarray) {
+            int idx = std::min(static_cast<int>((x - xarry[0]) / (xarry[1] - xarry[0])), static_cast<int>(xarry.size()) - 2);
             double x0 = xarry[idx];
             double x1 = xarry[idx + 1];
             double y0 = yarray[idx];
@@ -579,41 +648,67 @@ namespace hub::force {
         }
     };
 
-    template <typename Particles>
-    void MagnetoDisk::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
-        auto const &v = particles.vel();
-        auto const &m = particles.mass();
-        auto const &R = particles.radius();
+    /*---------------------------------------------------------------------------*\
+         Class MagnetoDiskProfile Implementation
+    \*---------------------------------------------------------------------------*/
+    inline MagnetoDiskProfile::MagnetoDiskProfile() {
+        auto const &lgr = _mag_disk_lgr_cgs;
+        auto const &lgrho = _mag_disk_lgrho_cgs;
+        auto const &lgH = _mag_disk_lgH_cgs;
+        auto const &v = _mag_disk_v_cgs;
+        double const ln10 = std::log(10.0);
+        double const dlg_r = (lgr.back() - lgr.front()) / static_cast<double>(intervals);
+        lg_cm_ = std::log10(unit::cm);
+        inv_dlg_r_ = 1.0 / dlg_r;
 
-        for (size_t i = 1; i < num; ++i) {
-            auto dr = p[i] - p[0];
-            auto dv = v[i] - v[0];
+        for (size_t i = 0; i < intervals; ++i) {
+            if (std::abs(lgr[i] - lgr.front() - static_cast<double>(i) * dlg_r) > 0.5 * dlg_r) {
+                spacehub_abort("The radial grid of the magneto disk tables is not uniform enough!");
+            }
+            double const k = static_cast<double>(oversample);
+            slopes_[i] = Slope{k / (lgr[i + 1] - lgr[i]), ln10 * (lgrho[i + 1] - lgrho[i]) / k,
+                               ln10 * (lgH[i + 1] - lgH[i]) / k, (v[i + 1] - v[i]) * v_unit / k};
+            for (size_t j = 0; j < oversample; ++j) {
+                double t = static_cast<double>(j) / k;
+                nodes_[i * oversample + j] = Sample{std::pow(10.0, lgrho[i] + t * (lgrho[i + 1] - lgrho[i])) / rho_unit,
+                                                    std::pow(10.0, lgH[i] + t * (lgH[i + 1] - lgH[i])) / H_unit,
+                                                    (v[i] + t * (v[i + 1] - v[i])) * v_unit};
+            }
+        }
+        slopes_[intervals] = Slope{0, 0, 0, 0};
+        nodes_[size - 1] = Sample{std::pow(10.0, lgrho.back()) / rho_unit, std::pow(10.0, lgH.back()) / H_unit,
+                                  v.back() * v_unit};
+    }
 
-            auto rho = disk_rho(dr);
-            auto v_disk = disk_v(dr);
-            auto H = disk_H(dr);
-            auto v_rel = dv - v_disk;
-            auto r = norm(dr);
-            auto Omega = sqrt(consts::G * m[0] / (r * r * r));
-            auto cs = Omega * H;
+    /*---------------------------------------------------------------------------*\
+         Class MagnetoDisk Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Vector, typename Scalar>
+    Vector MagnetoDisk::central_force(const CentralSample<Vector, Scalar> &s, Context const &ctx) {
+        auto const &dr = s.dr;
+        auto r_cyl = sqrt(dr.x * dr.x + dr.y * dr.y);
+        auto disk = (*ctx.profile)(r_cyl);
+        auto rho = disk.rho;
+        auto H = disk.H;
+        auto v_disk = Vector{-disk.v * dr.y / r_cyl, disk.v * dr.x / r_cyl, 0};
+        auto v_rel = s.dv - v_disk;
+        auto r = norm(dr);
+        auto Omega = sqrt(consts::G * s.M / (r * r * r));
+        auto cs = Omega * H;
 
-            auto v2 = dot(v_rel, v_rel);
-            auto vabs = sqrt(v2);
-            auto Mach = vabs / cs;
+        auto v2 = dot(v_rel, v_rel);
+        auto vabs = sqrt(v2);
+        auto Mach = vabs / cs;
 
-            auto rd = R[i];
+        auto rd = s.radius;
 
-            double I = GDF_I(Mach);
+        double I = GDF_I(Mach);
 
-            double df = I * 4 * consts::pi * consts::G * consts::G * m[i] * m[i] / (cs * cs) * rho;
-            double aeo = 4 * consts::pi * rd * rd * rho * v2;
-            double f = df + aeo;
+        double df = I * 4 * consts::pi * consts::G * consts::G * s.m * s.m / (cs * cs) * rho;
+        double aeo = 4 * consts::pi * rd * rd * rho * v2;
+        double f = df + aeo;
 
-            acceleration[i] -= f * v_rel / vabs / m[i];
-            acceleration[0] += f * v_rel / vabs / m[0];
-        }
+        return -f * v_rel / vabs;
     }
 
 }  // namespace hub::force
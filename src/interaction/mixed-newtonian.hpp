@@ -0,0 +1,212 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file mixed-newtonian.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "newtonian.hpp"
+#include "soa-kernel.hpp"
+
+namespace hub::force {
+    /*---------------------------------------------------------------------------*\
+         Class MixedNewtonianGrav Declaration
+    \*---------------------------------------------------------------------------*/
+
+    /**
+     * @brief Newtonian direct summation force with the distant pairs evaluated in single precision.
+     *
+     * Drop-in replacement of `NewtonianGrav` for large N. In the SoA pair loop, the pairs further apart than
+     * `far_distance2()` are evaluated in float(see `kernel::newtonian_mixed_pair_acc`) and accumulated in double,
+     * the closer pairs stay in double. The distance is derived from the relative tolerance of the run, which
+     * `Simulator::run` stores in the `force_rtol()` of the evaluated system, or from `tolerance` if it is set. Without a tolerance, or if
+     * too few pairs are distant enough(see `max_near_fraction`), this is exactly `NewtonianGrav`.
+     *
+     * @note Combined with other pair forces in `Interactions`, the fused pair walk evaluates it in double.
+     */
+    class MixedNewtonianGrav : public NewtonianGrav {
+       public:
+        /**
+         * @brief Relative tolerance of the far pairs. Overrides the tolerance of the run if positive.
+         */
+        inline static double tolerance{0};
+
+        /**
+         * @brief Single precision error of a far pair relative to its contribution, the rounding of the coordinates,
+         * the square root and the division.
+         */
+        constexpr static double float_error{4 * std::numeric_limits<float>::epsilon()};
+
+        /**
+         * @brief Largest fraction of near pairs for which the mixed precision kernel is used. Near pairs fall out of
+         * the SIMD lanes, so above it the plain double kernel is faster.
+         */
+        inline static double max_near_fraction{1.0 / 32};
+
+        /**
+         * @brief The tolerance used by the next evaluation of `particles`.
+         *
+         * @return `tolerance` if positive, else the `force_rtol()` of `particles` if it has one, else zero.
+         */
+        template <typename Particles>
+        static double current_tolerance(Particles const &particles);
+
+        /**
+         * @brief Squared distance beyond which a pair of the gathered particles is evaluated in single precision.
+         *
+         * A far pair adds a rounding error of about `float_error`*m_j/r^2 to the acceleration. The errors of the N
+         * pairs of a particle add up like a random walk, so bounding their sum by the tolerance times M/R^2, the
+         * acceleration scale of the whole system(M total mass, R rms radius about the center of mass), gives
+         * r^2 > `float_error`*max(m_j)*sqrt(N)*R^2/(tolerance*M).
+         *
+         * @param[in] s SoA scratch with gathered positions and masses.
+         * @param[in] rtol Relative tolerance(see `current_tolerance()`).
+         * @return Infinity if the tolerance is not positive or no pair is that far apart.
+         */
+        template <typename T>
+        static T far_distance2(kernel::SoAScratch<T> const &s, double rtol);
+
+        /**
+         * @brief Add newtonian acceleration to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+
+        /**
+         * @brief Add newtonian acceleration to existing 3D vector array and the newtonian potential energy to
+         * `potential` in the same pass.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] potential Potential energy to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration,
+                               typename Particles::Scalar &potential);
+
+       private:
+        template <bool WithPot, typename T>
+        static T mixed_pair_acc(kernel::SoAScratch<T> &s, size_t offset, double tol);
+
+        /**
+         * @brief Fraction of near pairs, estimated from the N pairs (k, k + N/2).
+         */
+        template <typename T>
+        static double near_fraction(kernel::SoAScratch<T> const &s, T far_r2);
+
+        CREATE_METHOD_CHECK(force_rtol);
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class MixedNewtonianGrav Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Particles>
+    double MixedNewtonianGrav::current_tolerance(const Particles &particles) {
+        if (tolerance > 0) {
+            return tolerance;
+        }
+        if constexpr (HAS_METHOD(Particles, force_rtol)) {
+            return particles.force_rtol();
+        } else {
+            return 0;
+        }
+    }
+
+    template <typename T>
+    T MixedNewtonianGrav::far_distance2(const kernel::SoAScratch<T> &s, double rtol) {
+        auto const tol = static_cast<T>(rtol);
+        size_t const n = s.size();
+        if (tol <= 0 || n == 0) {
+            return std::numeric_limits<T>::infinity();
+        }
+
+        T M = 0, m_max = 0, cx = 0, cy = 0, cz = 0;
+        for (size_t k = 0; k < n; ++k) {
+            M += s.m[k], m_max = std::max(m_max, s.m[k]);
+            cx += s.m[k] * s.x[k], cy += s.m[k] * s.y[k], cz += s.m[k] * s.z[k];
+        }
+        cx /= M, cy /= M, cz /= M;
+
+        T R2 = 0, r2_max = 0;
+        for (size_t k = 0; k < n; ++k) {
+            T dx = s.x[k] - cx, dy = s.y[k] - cy, dz = s.z[k] - cz;
+            T r2 = dx * dx + dy * dy + dz * dz;
+            R2 += s.m[k] * r2, r2_max = std::max(r2_max, r2);
+        }
+        R2 /= M;
+
+        T const far_r2 = static_cast<T>(float_error) * m_max * std::sqrt(static_cast<T>(n)) * R2 / (tol * M);
+        if (far_r2 >= 4 * r2_max) {
+            return std::numeric_limits<T>::infinity();
+        }
+        return far_r2;
+    }
+
+    template <typename T>
+    double MixedNewtonianGrav::near_fraction(const kernel::SoAScratch<T> &s, T far_r2) {
+        size_t const n = s.size();
+        size_t near = 0;
+        for (size_t k = 0; k < n; ++k) {
+            size_t const j = (k + n / 2) % n;
+            T dx = s.x[j] - s.x[k], dy = s.y[j] - s.y[k], dz = s.z[j] - s.z[k];
+            near += (dx * dx + dy * dy + dz * dz <= far_r2);
+        }
+        return static_cast<double>(near) / static_cast<double>(n);
+    }
+
+    template <bool WithPot, typename T>
+    T MixedNewtonianGrav::mixed_pair_acc(kernel::SoAScratch<T> &s, size_t offset, double tol) {
+        T const far_r2 = far_distance2(s, tol);
+        if (far_r2 < std::numeric_limits<T>::infinity() && near_fraction(s, far_r2) <= max_near_fraction) {
+            return kernel::newtonian_mixed_pair_acc<WithPot>(s, far_r2, offset);
+        } else {
+            return kernel::newtonian_pair_acc<WithPot>(s, offset);
+        }
+    }
+
+    template <typename Particles>
+    void MixedNewtonianGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        typename Particles::Scalar unused{0};
+        double const tol = current_tolerance(particles);
+        add_acc_impl<false>(particles, acceleration, unused, [tol](auto &scratch, size_t offset) {
+            return mixed_pair_acc<false>(scratch, offset, tol);
+        });
+    }
+
+    template <typename Particles>
+    void MixedNewtonianGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration,
+                                        typename Particles::Scalar &potential) {
+        double const tol = current_tolerance(particles);
+        add_acc_impl<true>(particles, acceleration, potential, [tol](auto &scratch, size_t offset) {
+            return mixed_pair_acc<true>(scratch, offset, tol);
+        });
+    }
+}  // namespace hub::force
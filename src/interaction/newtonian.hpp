@@ -24,7 +24,11 @@ License
  */
 #pragma once
 
+#include "../dev-tools.hpp"
+#include "../macros.hpp"
 #include "../spacehub-concepts.hpp"
+#include "pair-loop.hpp"
+#include "soa-kernel.hpp"
 /**
  * @namespace hub::force
  * Documentation for hub
@@ -37,6 +41,11 @@ namespace hub::force {
     /**
      * @brief Newtonian direct summation force.
      *
+     * For floating point types with more than `kernel::soa_threshold` particles, the pair loop (or the far pair
+     * loop of the chain, copied from the chain ordered mirror `ChainOrdered` without a gather) runs on a SoA scratch with the SIMD kernel `kernel::newtonian_pair_acc`. Combined with
+     * other pair forces in `Interactions`, it contributes through `add_pair_acc` to the fused pair walk instead. For
+     * particle systems with a compile time particle number(see `particles::FixedParticles`) the pair loops are fully
+     * unrolled. 1/r^3 follows `kernel::inv_sqrt_policy`.
      */
     class NewtonianGrav {
        public:
@@ -59,10 +68,61 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
+        /**
+         * @brief Add newtonian acceleration to existing 3D vector array and the newtonian potential energy to
+         * `potential` in the same pass.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] potential Potential energy to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration,
+                               typename Particles::Scalar &potential);
+
+        /**
+         * @brief Add the newtonian acceleration of a single pair to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam Pair Pair geometry type(see `force::Pair`).
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pair Shared geometry of the pair.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename Pair>
+        static void add_pair_acc(Particles const &particles, Pair const &pair,
+                                 typename Particles::VectorArray &acceleration);
+
+        /**
+         * @brief Add the newtonian acceleration and potential energy of a single pair.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam Pair Pair geometry type(see `force::Pair`).
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pair Shared geometry of the pair.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in,out] potential Potential energy to be updated.
+         */
+        template <typename Particles, typename Pair>
+        static void add_pair_acc(Particles const &particles, Pair const &pair,
+                                 typename Particles::VectorArray &acceleration, typename Particles::Scalar &potential);
+
+       protected:
+        /**
+         * @brief Direct summation over all pairs, with the SoA pair loop delegated to
+         * `soa_kernel(SoAScratch<Scalar> &scratch, size_t offset) -> Scalar`.
+         */
+        template <bool WithPot, typename Particles, typename SoAKernel>
+        static void add_acc_impl(Particles const &particles, typename Particles::VectorArray &acceleration,
+                                 typename Particles::Scalar &potential, SoAKernel &&soa_kernel);
+
        private:
         CREATE_METHOD_CHECK(chain_pos);
 
         CREATE_METHOD_CHECK(index);
+
+        CREATE_METHOD_CHECK(chain_ordered);
     };
 
     /*---------------------------------------------------------------------------*\
@@ -70,14 +130,46 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void NewtonianGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        typename Particles::Scalar unused{0};
+        add_acc_impl<false>(particles, acceleration, unused,
+                            [](auto &scratch, size_t offset) { return kernel::newtonian_pair_acc(scratch, offset); });
+    }
+
+    template <typename Particles>
+    void NewtonianGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration,
+                                   typename Particles::Scalar &potential) {
+        add_acc_impl<true>(particles, acceleration, potential, [](auto &scratch, size_t offset) {
+            return kernel::newtonian_pair_acc<true>(scratch, offset);
+        });
+    }
+
+    template <bool WithPot, typename Particles, typename SoAKernel>
+    void NewtonianGrav::add_acc_impl(const Particles &particles, typename Particles::VectorArray &acceleration,
+                                     typename Particles::Scalar &potential, SoAKernel &&soa_kernel) {
         using Vector = typename Particles::Vector;
+        using Scalar = typename Particles::Scalar;
+        constexpr size_t Num = pair_loop::unrolled_number_v<Particles>;
         size_t num = particles.number();
         auto const &p = particles.pos();
         auto const &m = particles.mass();
+        Scalar pot{0};
+        bool const newton = kernel::use_newton_rsqrt<Scalar>();
 
         auto force = [&](Vector const &dr, size_t i, size_t j) {
-            auto r = norm(dr);
-            auto rr3 = 1.0 / (r * r * r);
+            Scalar rr3;
+            if (newton) {
+                auto rr = kernel::rsqrt_newton(norm2(dr));
+                rr3 = rr * rr * rr;
+                if constexpr (WithPot) {
+                    pot -= m[i] * m[j] * rr;
+                }
+            } else {
+                auto r = norm(dr);
+                rr3 = 1.0 / (r * r * r);
+                if constexpr (WithPot) {
+                    pot -= m[i] * m[j] * rr3 * r * r;
+                }
+            }
             /*
             acceleration[i] += dr * rr3 * m[j];
             acceleration[j] -= dr * rr3 * m[i];*/
@@ -94,26 +186,82 @@ namespace hub::force {
             auto const &idx = particles.index();
 
             size_t size = particles.number();
+            bool far_pairs_done = false;
 
-            for (size_t i = 0; i < size; ++i) {
-                for (size_t j = i + 3; j < size; ++j) {
-                    force(p[idx[j]] - p[idx[i]], idx[i], idx[j]);
+            if constexpr (std::is_floating_point_v<Scalar> && Num == 0) {
+                if (size > kernel::soa_threshold) {
+                    static thread_local kernel::SoAScratch<Scalar> scratch;
+                    if constexpr (HAS_METHOD(Particles, chain_ordered)) {
+                        if (particles.chain_ordered().size() == size) {
+                            scratch.load(particles.chain_ordered());
+                        } else {
+                            scratch.gather(p, m, idx);
+                        }
+                    } else {
+                        scratch.gather(p, m, idx);
+                    }
+                    pot += soa_kernel(scratch, size_t{3});
+                    scratch.scatter_add_to(acceleration, idx);
+                    far_pairs_done = true;
                 }
             }
 
-            for (size_t i = 0; i < size - 2; ++i) {
-                force(ch_p[i] + ch_p[i + 1], idx[i], idx[i + 2]);
+            if constexpr (HAS_METHOD(Particles, chain_ordered)) {
+                auto const &o = particles.chain_ordered();
+                if (!far_pairs_done && o.size() == size) {
+                    pair_loop::for_each_index_pair<Num, 3>(size, [&](size_t i, size_t j) {
+                        force(Vector{o.x[j] - o.x[i], o.y[j] - o.y[i], o.z[j] - o.z[i]}, idx[i], idx[j]);
+                    });
+                    far_pairs_done = true;
+                }
             }
 
-            for (size_t i = 0; i < size - 1; ++i) {
-                force(ch_p[i], idx[i], idx[i + 1]);
+            if (!far_pairs_done) {
+                pair_loop::for_each_index_pair<Num, 3>(
+                    size, [&](size_t i, size_t j) { force(p[idx[j]] - p[idx[i]], idx[i], idx[j]); });
             }
+
+            pair_loop::for_each_index<Num, 2>(size,
+                                              [&](size_t i) { force(ch_p[i] + ch_p[i + 1], idx[i], idx[i + 2]); });
+
+            pair_loop::for_each_index<Num, 1>(size, [&](size_t i) { force(ch_p[i], idx[i], idx[i + 1]); });
         } else {
-            for (size_t i = 0; i < num; ++i) {
-                for (size_t j = i + 1; j < num; ++j) {
-                    force(p[j] - p[i], i, j);
+            bool pairs_done = false;
+
+            if constexpr (std::is_floating_point_v<Scalar> && Num == 0) {
+                if (num > kernel::soa_threshold) {
+                    static thread_local kernel::SoAScratch<Scalar> scratch;
+                    scratch.gather(p, m);
+                    pot += soa_kernel(scratch, size_t{1});
+                    scratch.scatter_add_to(acceleration);
+                    pairs_done = true;
                 }
             }
+
+            if (!pairs_done) {
+                pair_loop::for_each_index_pair<Num, 1>(num, [&](size_t i, size_t j) { force(p[j] - p[i], i, j); });
+            }
+        }
+
+        if constexpr (WithPot) {
+            potential += pot * consts::G;
         }
     }
+
+    template <typename Particles, typename Pair>
+    void NewtonianGrav::add_pair_acc(const Particles &particles, const Pair &pair,
+                                     typename Particles::VectorArray &acceleration) {
+        auto const &m = particles.mass();
+        acceleration[pair.i] += pair.dr * (pair.inv_r3 * m[pair.j]);
+        acceleration[pair.j] -= pair.dr * (pair.inv_r3 * m[pair.i]);
+    }
+
+    template <typename Particles, typename Pair>
+    void NewtonianGrav::add_pair_acc(const Particles &particles, const Pair &pair,
+                                     typename Particles::VectorArray &acceleration,
+                                     typename Particles::Scalar &potential) {
+        add_pair_acc(particles, pair, acceleration);
+        auto const &m = particles.mass();
+        potential -= consts::G * m[pair.i] * m[pair.j] * pair.inv_r;
+    }
 }  // namespace hub::force
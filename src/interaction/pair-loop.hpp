@@ -0,0 +1,512 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file pair-loop.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "../dev-tools.hpp"
+#include "../macros.hpp"
+#include "../spacehub-concepts.hpp"
+#include "../type-class.hpp"
+#include "inv-sqrt.hpp"
+
+namespace hub::force {
+    /*---------------------------------------------------------------------------*\
+        Class Pair Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Shared geometry of a particle pair (i, j) with dr = r_j - r_i.
+     *
+     * Forces that provide a static `add_pair_acc(particles, pair, acceleration)` receive this struct from
+     * `for_each_pair` and can be fused by `Interactions` into one pass over the pairs.
+     *
+     * @tparam Vector 3D vector type.
+     * @tparam Scalar Scalar type.
+     */
+    template <typename Vector, typename Scalar>
+    struct Pair {
+        Vector dr;
+        Vector dv;
+        Scalar r2;
+        Scalar r;
+        Scalar inv_r;
+        Scalar inv_r3;
+        size_t i;
+        size_t j;
+    };
+
+    template <typename Particles>
+    using PairOf = Pair<typename Particles::Vector, typename Particles::Scalar>;
+
+    namespace pair_loop {
+        CREATE_METHOD_CHECK(chain_pos);
+
+        CREATE_METHOD_CHECK(chain_vel);
+
+        CREATE_METHOD_CHECK(index);
+
+        CREATE_METHOD_CHECK(chain_ordered);
+
+        CREATE_METHOD_CHECK(add_acc_to);
+
+        CREATE_METHOD_CHECK(add_pair_acc);
+
+        CREATE_METHOD_CHECK(compact_pairs);
+
+        CREATE_STATIC_MEMBER_CHECK(compact_pairs_only);
+
+        /**
+         * @brief Can force `Force` be evaluated pair by pair on particle system `Particles`?
+         */
+        template <typename Force, typename Particles>
+        constexpr bool is_pair_force = HAS_METHOD(Force, add_pair_acc, Particles const &, PairOf<Particles> const &,
+                                                  typename Particles::VectorArray &);
+
+        /**
+         * @brief Can force `Force` add its potential energy to a scalar while evaluating the acceleration?
+         */
+        template <typename Force, typename Particles>
+        constexpr bool has_potential = HAS_METHOD(Force, add_acc_to, Particles const &,
+                                                  typename Particles::VectorArray &, typename Particles::Scalar &);
+
+        /**
+         * @brief Can force `Force` add the potential energy of a single pair in the fused pair walk?
+         */
+        template <typename Force, typename Particles>
+        constexpr bool has_pair_potential =
+            HAS_METHOD(Force, add_pair_acc, Particles const &, PairOf<Particles> const &,
+                       typename Particles::VectorArray &, typename Particles::Scalar &);
+
+        /**
+         * @brief Does the particle system provide the chain coordinates required by the pair walk?
+         */
+        template <bool WithVel, typename Particles>
+        constexpr bool use_chain = HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
+                                   (!WithVel || HAS_METHOD(Particles, chain_vel));
+
+        /**
+         * @brief Does force `Force` only need the pairs of the compact pair list(see `force::CompactPairs`)?
+         */
+        template <typename Force>
+        constexpr bool is_compact_force() {
+            if constexpr (HAS_STATIC_MEMBER(Force, compact_pairs_only)) {
+                return Force::compact_pairs_only;
+            } else {
+                return false;
+            }
+        }
+
+        /**
+         * @brief Compile time particle number of the particle system if its loops are unrolled, otherwise 0(see
+         * `hub::unrolled_size_v`).
+         */
+        template <typename Particles>
+        inline constexpr size_t unrolled_number_v = unrolled_size_v<decltype(std::declval<Particles const &>().pos())>;
+
+        /**
+         * @brief Call `func(i)` for every i with i + Offset < num. Fully unrolled if `Num` is not 0, in which case
+         * `num` must equal `Num`.
+         */
+        template <size_t Num, size_t Offset, typename Func>
+        inline void for_each_index(size_t num, Func &&func) {
+            if constexpr (Num != 0) {
+                static_for<0, (Num > Offset ? Num - Offset : 0)>([&](auto i) { func(size_t{i}); });
+            } else {
+                for (size_t i = 0; i + Offset < num; ++i) {
+                    func(i);
+                }
+            }
+        }
+
+        /**
+         * @brief Call `func(i, j)` for every index pair with i + Offset <= j < num. Fully unrolled if `Num` is not 0,
+         * in which case `num` must equal `Num`.
+         */
+        template <size_t Num, size_t Offset, typename Func>
+        inline void for_each_index_pair(size_t num, Func &&func) {
+            if constexpr (Num != 0) {
+                static_for<0, Num>([&](auto i) {
+                    static_for<decltype(i)::value + Offset, Num>([&](auto j) { func(size_t{i}, size_t{j}); });
+                });
+            } else {
+                for (size_t i = 0; i < num; ++i) {
+                    for (size_t j = i + Offset; j < num; ++j) {
+                        func(i, j);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Fill the pair geometry from the separation dr = r_j - r_i. 1/r follows `kernel::inv_sqrt_policy`.
+         */
+        template <typename Pair, typename Vector>
+        inline void fill(Pair &pair, Vector const &dr, size_t i, size_t j) {
+            pair.dr = dr;
+            using std::sqrt;
+            pair.r2 = norm2(dr);
+            if (kernel::use_newton_rsqrt<decltype(pair.r2)>()) {
+                pair.inv_r = kernel::rsqrt_newton(pair.r2);
+                pair.r = pair.r2 * pair.inv_r;
+            } else {
+                pair.r = sqrt(pair.r2);
+                pair.inv_r = 1.0 / pair.r;
+            }
+            pair.inv_r3 = pair.inv_r * pair.inv_r * pair.inv_r;
+            pair.i = i;
+            pair.j = j;
+        }
+    }  // namespace pair_loop
+
+    /*---------------------------------------------------------------------------*\
+        Class CompactPairs Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief List of the relativistic pairs of a particle system.
+     *
+     * A pair (i, j) is compact if G(m_i + m_j)/(r c^2) exceeds `threshold`. The particle systems rebuild the list in
+     * `pre_iter_process()` if any of their forces declares `compact_pairs_only` (the post-Newtonian terms), and these
+     * forces then only walk the listed pairs during the step. With the default threshold 0 no list is built and
+     * every pair is walked.
+     */
+    class CompactPairs {
+       public:
+        /**
+         * @brief Compactness G(m_i + m_j)/(r c^2) above which a pair is kept. 0 keeps every pair.
+         */
+        inline static double threshold{0};
+
+        /**
+         * @brief Rebuild the list from the current positions.
+         *
+         * @param[in] particles Particle system.
+         */
+        template <typename Particles>
+        void rebuild(Particles const &particles);
+
+        /**
+         * @brief Can the list be used for particle system `particles`?
+         */
+        template <typename Particles>
+        [[nodiscard]] bool active(Particles const &particles) const {
+            return built_ && number_ == particles.number();
+        }
+
+        /**
+         * @brief Number of the listed pairs.
+         */
+        [[nodiscard]] size_t size() const { return pairs_.size(); }
+
+        /**
+         * @brief Walk the listed pairs and call `func(pair)` with the pair geometry.
+         *
+         * Pairs that were chain neighbours (or next neighbours) at the rebuild take their separation from the chain
+         * coordinates as long as the chain has not changed.
+         */
+        template <bool WithVel, typename Particles, typename Func>
+        void for_each(Particles const &particles, Func &&func) const;
+
+       private:
+        struct Entry {
+            size_t i;
+            size_t j;
+            size_t rank;
+            size_t span;
+        };
+
+        std::vector<Entry> pairs_;
+
+        size_t number_{0};
+
+        bool built_{false};
+    };
+
+    /**
+     * @brief Walk the compact pairs of the particle system if it keeps an active list(see `force::CompactPairs`),
+     * otherwise every pair.
+     *
+     * @tparam WithVel Fill `Pair::dv` as well.
+     * @param[in] particles Particle system.
+     * @param[in] func Callable with signature `void(Pair const &)`.
+     */
+    template <bool WithVel, typename Particles, typename Func>
+    void for_each_compact_pair(Particles const &particles, Func &&func);
+
+    /**
+     * @brief Walk the pairs (a, b) of every particle a in `active` with every other particle b, and call `func(pair)`
+     * with `pair.i = a` and `pair.j = b`.
+     *
+     * Pairs of two active particles are visited twice, once from each side. For chain systems the pairs that are
+     * chain neighbours (or next neighbours) take their separation from the chain coordinates.
+     *
+     * @tparam WithVel Fill `Pair::dv` as well.
+     * @param[in] particles Particle system.
+     * @param[in] active Indices of the active particles.
+     * @param[in] func Callable with signature `void(Pair const &)`.
+     */
+    template <bool WithVel, typename Particles, typename IdxArray, typename Func>
+    void for_each_active_pair(Particles const &particles, IdxArray const &active, Func &&func);
+
+    /**
+     * @brief Does the particle system keep an active compact pair list?
+     */
+    template <typename Particles>
+    bool compact_pairs_active(Particles const &particles) {
+        if constexpr (pair_loop::HAS_METHOD(Particles, compact_pairs)) {
+            return particles.compact_pairs().active(particles);
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * @brief Walk every particle pair once and call `func(pair)` with the shared pair geometry.
+     *
+     * For chain systems the near pairs (i, i+1) and (i, i+2) take their separation from the chain coordinates to
+     * keep the regularized precision; the rest use the Cartesian coordinates, read from the chain ordered copy(see
+     * `ChainOrdered`) if the system keeps one. The walk is fully unrolled for the
+     * particle systems with a compile time particle number(see `particles::FixedParticles`).
+     *
+     * @tparam WithVel Fill `Pair::dv` as well.
+     * @param[in] particles Particle system.
+     * @param[in] func Callable with signature `void(Pair const &)`.
+     */
+    template <bool WithVel, typename Particles, typename Func>
+    void for_each_pair(Particles const &particles, Func &&func) {
+        using Vector = typename Particles::Vector;
+        using PairT = PairOf<Particles>;
+        constexpr size_t Num = pair_loop::unrolled_number_v<Particles>;
+
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+        size_t num = particles.number();
+
+        PairT pair;
+        auto visit = [&](Vector const &dr, size_t i, size_t j) {
+            pair_loop::fill(pair, dr, i, j);
+            func(static_cast<PairT const &>(pair));
+        };
+
+        if constexpr (pair_loop::use_chain<WithVel, Particles>) {
+            auto const &ch_p = particles.chain_pos();
+            auto const &idx = particles.index();
+
+            pair_loop::for_each_index<Num, 1>(num, [&](size_t i) {
+                if constexpr (WithVel) {
+                    pair.dv = particles.chain_vel()[i];
+                }
+                visit(ch_p[i], idx[i], idx[i + 1]);
+            });
+
+            pair_loop::for_each_index<Num, 2>(num, [&](size_t i) {
+                if constexpr (WithVel) {
+                    auto const &ch_v = particles.chain_vel();
+                    pair.dv = ch_v[i] + ch_v[i + 1];
+                }
+                visit(ch_p[i] + ch_p[i + 1], idx[i], idx[i + 2]);
+            });
+
+            bool far_pairs_done = false;
+
+            if constexpr (pair_loop::HAS_METHOD(Particles, chain_ordered)) {
+                auto const &o = particles.chain_ordered();
+                if (o.size() == num) {
+                    pair_loop::for_each_index_pair<Num, 3>(num, [&](size_t i, size_t j) {
+                        if constexpr (WithVel) {
+                            pair.dv = Vector{o.vx[j] - o.vx[i], o.vy[j] - o.vy[i], o.vz[j] - o.vz[i]};
+                        }
+                        visit(Vector{o.x[j] - o.x[i], o.y[j] - o.y[i], o.z[j] - o.z[i]}, idx[i], idx[j]);
+                    });
+                    far_pairs_done = true;
+                }
+            }
+
+            if (!far_pairs_done) {
+                pair_loop::for_each_index_pair<Num, 3>(num, [&](size_t i, size_t j) {
+                    if constexpr (WithVel) {
+                        pair.dv = v[idx[j]] - v[idx[i]];
+                    }
+                    visit(p[idx[j]] - p[idx[i]], idx[i], idx[j]);
+                });
+            }
+        } else {
+            pair_loop::for_each_index_pair<Num, 1>(num, [&](size_t i, size_t j) {
+                if constexpr (WithVel) {
+                    pair.dv = v[j] - v[i];
+                }
+                visit(p[j] - p[i], i, j);
+            });
+        }
+    }
+
+    template <bool WithVel, typename Particles, typename Func>
+    void for_each_compact_pair(Particles const &particles, Func &&func) {
+        if constexpr (pair_loop::HAS_METHOD(Particles, compact_pairs)) {
+            if (compact_pairs_active(particles)) {
+                particles.compact_pairs().template for_each<WithVel>(particles, std::forward<Func>(func));
+                return;
+            }
+        }
+        for_each_pair<WithVel>(particles, std::forward<Func>(func));
+    }
+
+    template <bool WithVel, typename Particles, typename IdxArray, typename Func>
+    void for_each_active_pair(Particles const &particles, IdxArray const &active, Func &&func) {
+        using Vector = typename Particles::Vector;
+        using PairT = PairOf<Particles>;
+
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+        size_t num = particles.number();
+
+        PairT pair;
+        if constexpr (pair_loop::use_chain<WithVel, Particles>) {
+            auto const &ch_p = particles.chain_pos();
+            auto const &idx = particles.index();
+
+            static thread_local std::vector<size_t> rank;
+            rank.resize(num);
+            for (size_t k = 0; k < num; ++k) {
+                rank[idx[k]] = k;
+            }
+
+            for (auto a : active) {
+                for (size_t b = 0; b < num; ++b) {
+                    if (b == a) continue;
+
+                    size_t lo = std::min(rank[a], rank[b]);
+                    size_t span = std::max(rank[a], rank[b]) - lo;
+                    if (span <= 2) {
+                        Vector dr = span == 1 ? ch_p[lo] : ch_p[lo] + ch_p[lo + 1];
+                        if constexpr (WithVel) {
+                            auto const &ch_v = particles.chain_vel();
+                            pair.dv = span == 1 ? ch_v[lo] : ch_v[lo] + ch_v[lo + 1];
+                            if (rank[a] > rank[b]) pair.dv = -pair.dv;
+                        }
+                        pair_loop::fill(pair, rank[a] < rank[b] ? dr : -dr, a, b);
+                    } else {
+                        if constexpr (WithVel) {
+                            pair.dv = v[b] - v[a];
+                        }
+                        pair_loop::fill(pair, p[b] - p[a], a, b);
+                    }
+                    func(static_cast<PairT const &>(pair));
+                }
+            }
+        } else {
+            for (auto a : active) {
+                for (size_t b = 0; b < num; ++b) {
+                    if (b == a) continue;
+
+                    if constexpr (WithVel) {
+                        pair.dv = v[b] - v[a];
+                    }
+                    pair_loop::fill(pair, p[b] - p[a], a, b);
+                    func(static_cast<PairT const &>(pair));
+                }
+            }
+        }
+    }
+
+    /*---------------------------------------------------------------------------*\
+        Class CompactPairs Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Particles>
+    void CompactPairs::rebuild(const Particles &particles) {
+        pairs_.clear();
+        number_ = particles.number();
+        built_ = threshold > 0;
+
+        if (!built_) {
+            return;
+        }
+
+        std::vector<size_t> rank(number_);
+        if constexpr (pair_loop::use_chain<false, Particles>) {
+            auto const &idx = particles.index();
+            for (size_t k = 0; k < number_; ++k) {
+                rank[idx[k]] = k;
+            }
+        }
+
+        auto const &m = particles.mass();
+        auto const coef = consts::G / (consts::C * consts::C);
+
+        for_each_pair<false>(particles, [&](auto const &pair) {
+            if (coef * (m[pair.i] + m[pair.j]) * pair.inv_r > threshold) {
+                size_t span = 0;
+                if constexpr (pair_loop::use_chain<false, Particles>) {
+                    size_t d = rank[pair.j] - rank[pair.i];
+                    span = d <= 2 ? d : 0;
+                }
+                pairs_.push_back(Entry{pair.i, pair.j, rank[pair.i], span});
+            }
+        });
+    }
+
+    template <bool WithVel, typename Particles, typename Func>
+    void CompactPairs::for_each(const Particles &particles, Func &&func) const {
+        using PairT = PairOf<Particles>;
+
+        auto const &p = particles.pos();
+        auto const &v = particles.vel();
+
+        PairT pair;
+        for (auto const &e : pairs_) {
+            bool on_chain = false;
+
+            if constexpr (pair_loop::use_chain<WithVel, Particles>) {
+                auto const &idx = particles.index();
+                if (e.span != 0 && idx[e.rank] == e.i && idx[e.rank + e.span] == e.j) {
+                    auto const &ch_p = particles.chain_pos();
+                    if (e.span == 1) {
+                        if constexpr (WithVel) {
+                            pair.dv = particles.chain_vel()[e.rank];
+                        }
+                        pair_loop::fill(pair, ch_p[e.rank], e.i, e.j);
+                    } else {
+                        if constexpr (WithVel) {
+                            auto const &ch_v = particles.chain_vel();
+                            pair.dv = ch_v[e.rank] + ch_v[e.rank + 1];
+                        }
+                        pair_loop::fill(pair, ch_p[e.rank] + ch_p[e.rank + 1], e.i, e.j);
+                    }
+                    on_chain = true;
+                }
+            }
+
+            if (!on_chain) {
+                if constexpr (WithVel) {
+                    pair.dv = v[e.j] - v[e.i];
+                }
+                pair_loop::fill(pair, p[e.j] - p[e.i], e.i, e.j);
+            }
+            func(static_cast<PairT const &>(pair));
+        }
+    }
+}  // namespace hub::force
@@ -26,6 +26,7 @@ License
 
 #include "../dev-tools.hpp"
 #include "interaction.hpp"
+#include "pair-loop.hpp"
 
 namespace hub::force {
 
@@ -43,6 +44,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Only walk the compact pairs(see `force::CompactPairs`).
+         *
+         */
+        constexpr static bool compact_pairs_only{true};
+
         // Type members
         /**
          * @brief Add acceleration from first order post-newtonian term to existing 3D vector array.
@@ -56,12 +63,18 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
-       private:
-        CREATE_METHOD_CHECK(chain_pos);
-
-        CREATE_METHOD_CHECK(chain_vel);
-
-        CREATE_METHOD_CHECK(index);
+        /**
+         * @brief Add the first order post-newtonian acceleration of a single pair to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam Pair Pair geometry type(see `force::Pair`).
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pair Shared geometry of the pair.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename Pair>
+        static void add_pair_acc(Particles const &particles, Pair const &pair,
+                                 typename Particles::VectorArray &acceleration);
     };
 
     class PN2 {
@@ -72,6 +85,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Only walk the compact pairs(see `force::CompactPairs`).
+         *
+         */
+        constexpr static bool compact_pairs_only{true};
+
         // Type members
         /**
          * @brief Add acceleration from second order post-newtonian term to existing 3D vector array.
@@ -85,12 +104,18 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
-       private:
-        CREATE_METHOD_CHECK(chain_pos);
-
-        CREATE_METHOD_CHECK(chain_vel);
-
-        CREATE_METHOD_CHECK(index);
+        /**
+         * @brief Add the second order post-newtonian acceleration of a single pair to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam Pair Pair geometry type(see `force::Pair`).
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pair Shared geometry of the pair.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename Pair>
+        static void add_pair_acc(Particles const &particles, Pair const &pair,
+                                 typename Particles::VectorArray &acceleration);
     };
 
     class PN2p5 {
@@ -101,6 +126,12 @@ namespace hub::force {
          */
         constexpr static bool vel_dependent{true};
 
+        /**
+         * @brief Only walk the compact pairs(see `force::CompactPairs`).
+         *
+         */
+        constexpr static bool compact_pairs_only{true};
+
         // Type members
         /**
          * @brief Add acceleration from two point five order post-newtonian term to existing 3D vector array.
@@ -114,12 +145,18 @@ namespace hub::force {
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
 
-       private:
-        CREATE_METHOD_CHECK(chain_pos);
-
-        CREATE_METHOD_CHECK(chain_vel);
-
-        CREATE_METHOD_CHECK(index);
+        /**
+         * @brief Add the two point five order post-newtonian acceleration of a single pair to existing 3D vector array.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @tparam Pair Pair geometry type(see `force::Pair`).
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in] pair Shared geometry of the pair.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles, typename Pair>
+        static void add_pair_acc(Particles const &particles, Pair const &pair,
+                                 typename Particles::VectorArray &acceleration);
     };
 
     constexpr double INV_C = 1.0 / consts::C;
@@ -133,68 +170,44 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN1::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
+        for_each_compact_pair<true>(particles,
+                                    [&](auto const &pair) { add_pair_acc(particles, pair, acceleration); });
+    }
+
+    template <typename Particles, typename Pair>
+    void PN1::add_pair_acc(const Particles &particles, const Pair &pair,
+                           typename Particles::VectorArray &acceleration) {
         auto const &v = particles.vel();
         auto const &m = particles.mass();
+        auto i = pair.i;
+        auto j = pair.j;
+        auto const &dv = pair.dv;
+        auto r2 = pair.r2;
+        auto inv_r = pair.inv_r;
+        auto n = -pair.dr * inv_r;
 
-        auto force = [&](auto const &dr, auto const &dv, auto i, auto j) {
-            auto r2 = norm2(dr);
-            auto r = sqrt(r2);
-            auto n = -dr / r;
-
-            auto v1s = norm2(v[i]);
-            auto v2s = norm2(v[j]);
-            auto v12 = dot(v[i], v[j]);
-
-            auto nv1 = dot(n, v[i]);
-            auto nv2 = dot(n, v[j]);
-
-            auto gmr1 = consts::G * m[i] / r;
-            auto gmr2 = consts::G * m[j] / r;
-
-            auto Ai = -v1s - 2 * v2s + 4 * v12 + 1.5 * nv2 * nv2 + 5 * gmr1 + 4 * gmr2;
+        auto v1s = norm2(v[i]);
+        auto v2s = norm2(v[j]);
+        auto v12 = dot(v[i], v[j]);
 
-            auto Aj = -v2s - 2 * v1s + 4 * v12 + 1.5 * nv1 * nv1 + 5 * gmr2 + 4 * gmr1;
+        auto nv1 = dot(n, v[i]);
+        auto nv2 = dot(n, v[j]);
 
-            auto Bi = 4 * nv1 - 3 * nv2;
+        auto gmr1 = consts::G * m[i] * inv_r;
+        auto gmr2 = consts::G * m[j] * inv_r;
 
-            auto Bj = -4 * nv2 + 3 * nv1;
+        auto Ai = -v1s - 2 * v2s + 4 * v12 + 1.5 * nv2 * nv2 + 5 * gmr1 + 4 * gmr2;
 
-            auto coef = consts::G / r2 * INV_C2;
+        auto Aj = -v2s - 2 * v1s + 4 * v12 + 1.5 * nv1 * nv1 + 5 * gmr2 + 4 * gmr1;
 
-            acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
-            acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
-        };
+        auto Bi = 4 * nv1 - 3 * nv2;
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
-            auto const &ch_p = particles.chain_pos();
-            auto const &ch_v = particles.chain_vel();
-            auto const &idx = particles.index();
+        auto Bj = -4 * nv2 + 3 * nv1;
 
-            size_t size = particles.number();
-            for (size_t i = 0; i < size - 1; ++i) {
-                force(ch_p[i], ch_v[i], idx[i], idx[i + 1]);
-            }
+        auto coef = consts::G / r2 * INV_C2;
 
-            for (size_t i = 0; i < size - 2; ++i) {
-                force(ch_p[i] + ch_p[i + 1], ch_v[i] + ch_v[i + 1], idx[i], idx[i + 2]);
-            }
-
-            for (size_t i = 0; i < size; ++i) {
-                for (size_t j = i + 3; j < size; ++j) {
-                    force(p[idx[j]] - p[idx[i]], v[idx[j]] - v[idx[i]], idx[i], idx[j]);
-                }
-            }
-
-        } else {
-            for (size_t i = 0; i < num; ++i) {
-                for (size_t j = i + 1; j < num; ++j) {
-                    force(p[j] - p[i], v[j] - v[i], i, j);
-                }
-            }
-        }
+        acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
+        acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
     }
 
     /*---------------------------------------------------------------------------*\
@@ -202,85 +215,62 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN2::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
+        for_each_compact_pair<true>(particles,
+                                    [&](auto const &pair) { add_pair_acc(particles, pair, acceleration); });
+    }
+
+    template <typename Particles, typename Pair>
+    void PN2::add_pair_acc(const Particles &particles, const Pair &pair,
+                           typename Particles::VectorArray &acceleration) {
         auto const &v = particles.vel();
         auto const &m = particles.mass();
-
-        auto force = [&](auto const &dr, auto const &dv, auto i, auto j) {
-            auto r2 = norm2(dr);
-            auto r = sqrt(r2);
-            auto n = -dr / r;
-
-            auto v1s = norm2(v[i]);
-            auto v1q = v1s * v1s;
-            auto v2s = norm2(v[j]);
-            auto v2q = v2s * v2s;
-            auto v12 = dot(v[i], v[j]);
-
-            auto nv1 = dot(n, v[i]);
-            auto nv1s = nv1 * nv1;
-            auto nv2 = dot(n, v[j]);
-            auto nv2s = nv2 * nv2;
-
-            auto gmr1 = consts::G * m[i] / r;
-            auto gmr2 = consts::G * m[j] / r;
-
-            auto m1s = m[i] * m[i];
-            auto m2s = m[j] * m[j];
-            auto m12 = m[i] * m[j];
-
-            auto Ai = -2 * v2q + 4 * v2s * v12 - 2 * v12 * v12 +
-                      nv2s * (1.5 * v1s + 4.5 * v2s - 6 * v12 - 1.875 * nv2s) +
-                      gmr1 * (-3.75 * v1s + 1.25 * v2s - 2.5 * v12 + 19.5 * nv1s - 39 * nv1 * nv2 + 8.5 * nv2s) +
-                      gmr2 * (4 * v2s - 8 * v12 + 2 * nv1s - 4 * nv1 * nv2 - 6 * nv2s) +
-                      consts::G * consts::G / r2 * (-14.25 * m1s - 9 * m2s - 34.5 * m12);
-
-            auto Aj = -2 * v1q + 4 * v1s * v12 - 2 * v12 * v12 +
-                      nv1s * (1.5 * v2s + 4.5 * v1s - 6 * v12 - 1.875 * nv1s) +
-                      gmr2 * (-3.75 * v2s + 1.25 * v1s - 2.5 * v12 + 19.5 * nv2s - 39 * nv1 * nv2 + 8.5 * nv1s) +
-                      gmr1 * (4 * v1s - 8 * v12 + 2 * nv2s - 4 * nv1 * nv2 - 6 * nv1s) +
-                      consts::G * consts::G / r2 * (-14.25 * m2s - 9 * m1s - 34.5 * m12);
-
-            auto Bi = v1s * nv2 + 4 * v2s * nv1 - 5 * v2s * nv2 - 4 * v12 * nv1 + 4 * v12 * nv2 - 6 * nv1 * nv2s +
-                      4.5 * nv2 * nv2s + gmr1 * (-15.75 * nv1 + 13.75 * nv2) + gmr2 * (-2 * nv1 - 2 * nv2);
-
-            auto Bj = -v2s * nv1 - 4 * v1s * nv2 + 5 * v1s * nv2 + 4 * v12 * nv2 - 4 * v12 * nv1 + 6 * nv2 * nv1s -
-                      4.5 * nv1 * nv1s + gmr2 * (15.75 * nv2 - 13.75 * nv1) + gmr1 * (2 * nv2 + 2 * nv1);
-
-            auto coef = consts::G / r2 * INV_C4;
-
-            acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
-            acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
-        };
-
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
-            auto const &ch_p = particles.chain_pos();
-            auto const &ch_v = particles.chain_vel();
-            auto const &idx = particles.index();
-
-            size_t size = particles.number();
-            for (size_t i = 0; i < size - 1; ++i) {
-                force(ch_p[i], ch_v[i], idx[i], idx[i + 1]);
-            }
-
-            for (size_t i = 0; i < size - 2; ++i) {
-                force(ch_p[i] + ch_p[i + 1], ch_v[i] + ch_v[i + 1], idx[i], idx[i + 2]);
-            }
-
-            for (size_t i = 0; i < size; ++i) {
-                for (size_t j = i + 3; j < size; ++j) {
-                    force(p[idx[j]] - p[idx[i]], v[idx[j]] - v[idx[i]], idx[i], idx[j]);
-                }
-            }
-        } else {
-            for (size_t i = 0; i < num; ++i) {
-                for (size_t j = i + 1; j < num; ++j) {
-                    force(p[j] - p[i], v[j] - v[i], i, j);
-                }
-            }
-        }
+        auto i = pair.i;
+        auto j = pair.j;
+        auto const &dv = pair.dv;
+        auto r2 = pair.r2;
+        auto inv_r = pair.inv_r;
+        auto n = -pair.dr * inv_r;
+
+        auto v1s = norm2(v[i]);
+        auto v1q = v1s * v1s;
+        auto v2s = norm2(v[j]);
+        auto v2q = v2s * v2s;
+        auto v12 = dot(v[i], v[j]);
+
+        auto nv1 = dot(n, v[i]);
+        auto nv1s = nv1 * nv1;
+        auto nv2 = dot(n, v[j]);
+        auto nv2s = nv2 * nv2;
+
+        auto gmr1 = consts::G * m[i] * inv_r;
+        auto gmr2 = consts::G * m[j] * inv_r;
+
+        auto m1s = m[i] * m[i];
+        auto m2s = m[j] * m[j];
+        auto m12 = m[i] * m[j];
+
+        auto Ai = -2 * v2q + 4 * v2s * v12 - 2 * v12 * v12 +
+                  nv2s * (1.5 * v1s + 4.5 * v2s - 6 * v12 - 1.875 * nv2s) +
+                  gmr1 * (-3.75 * v1s + 1.25 * v2s - 2.5 * v12 + 19.5 * nv1s - 39 * nv1 * nv2 + 8.5 * nv2s) +
+                  gmr2 * (4 * v2s - 8 * v12 + 2 * nv1s - 4 * nv1 * nv2 - 6 * nv2s) +
+                  consts::G * consts::G / r2 * (-14.25 * m1s - 9 * m2s - 34.5 * m12);
+
+        auto Aj = -2 * v1q + 4 * v1s * v12 - 2 * v12 * v12 +
+                  nv1s * (1.5 * v2s + 4.5 * v1s - 6 * v12 - 1.875 * nv1s) +
+                  gmr2 * (-3.75 * v2s + 1.25 * v1s - 2.5 * v12 + 19.5 * nv2s - 39 * nv1 * nv2 + 8.5 * nv1s) +
+                  gmr1 * (4 * v1s - 8 * v12 + 2 * nv2s - 4 * nv1 * nv2 - 6 * nv1s) +
+                  consts::G * consts::G / r2 * (-14.25 * m2s - 9 * m1s - 34.5 * m12);
+
+        auto Bi = v1s * nv2 + 4 * v2s * nv1 - 5 * v2s * nv2 - 4 * v12 * nv1 + 4 * v12 * nv2 - 6 * nv1 * nv2s +
+                  4.5 * nv2 * nv2s + gmr1 * (-15.75 * nv1 + 13.75 * nv2) + gmr2 * (-2 * nv1 - 2 * nv2);
+
+        auto Bj = -v2s * nv1 - 4 * v1s * nv2 + 5 * v1s * nv2 + 4 * v12 * nv2 - 4 * v12 * nv1 + 6 * nv2 * nv1s -
+                  4.5 * nv1 * nv1s + gmr2 * (15.75 * nv2 - 13.75 * nv1) + gmr1 * (2 * nv2 + 2 * nv1);
+
+        auto coef = consts::G / r2 * INV_C4;
+
+        acceleration[i] += (coef * m[j]) * (Ai * n - Bi * dv);
+        acceleration[j] -= (coef * m[i]) * (Aj * n - Bj * dv);
     }
 
     /*---------------------------------------------------------------------------*\
@@ -288,64 +278,38 @@ namespace hub::force {
     \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void PN2p5::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
-        auto const &v = particles.vel();
-        auto const &m = particles.mass();
-
-        auto force = [&](auto const &dr, auto const &dv, auto i, auto j) {
-            auto r2 = norm2(dr);
-            auto r = sqrt(r2);
-            auto n = -dr / r;
-
-            auto dv2 = norm2(dv);
-
-            auto nv = -dot(n, dv);
-
-            auto gmr1 = consts::G * m[i] / r;
-            auto gmr2 = consts::G * m[j] / r;
-
-            auto Ai = nv * (3 * dv2 - 6 * gmr1 + 52.0 / 3 * gmr2);
+        for_each_compact_pair<true>(particles,
+                                    [&](auto const &pair) { add_pair_acc(particles, pair, acceleration); });
+    }
 
-            auto Aj = nv * (3 * dv2 - 6 * gmr2 + 52.0 / 3 * gmr1);
+    template <typename Particles, typename Pair>
+    void PN2p5::add_pair_acc(const Particles &particles, const Pair &pair,
+                             typename Particles::VectorArray &acceleration) {
+        auto const &m = particles.mass();
+        auto i = pair.i;
+        auto j = pair.j;
+        auto const &dv = pair.dv;
+        auto inv_r = pair.inv_r;
+        auto n = -pair.dr * inv_r;
 
-            auto Bi = -dv2 + 2 * gmr1 - 8 * gmr2;
+        auto dv2 = norm2(dv);
 
-            auto Bj = -dv2 + 2 * gmr2 - 8 * gmr1;
+        auto nv = -dot(n, dv);
 
-            auto coef = 0.8 * consts::G * consts::G * m[i] * m[j] / (r2 * r) * INV_C5;
+        auto gmr1 = consts::G * m[i] * inv_r;
+        auto gmr2 = consts::G * m[j] * inv_r;
 
-            acceleration[i] += coef * (Ai * n - Bi * dv);
-            acceleration[j] -= coef * (Aj * n - Bj * dv);
-        };
+        auto Ai = nv * (3 * dv2 - 6 * gmr1 + 52.0 / 3 * gmr2);
 
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
-            auto const &ch_p = particles.chain_pos();
-            auto const &ch_v = particles.chain_vel();
-            auto const &idx = particles.index();
+        auto Aj = nv * (3 * dv2 - 6 * gmr2 + 52.0 / 3 * gmr1);
 
-            size_t size = particles.number();
-            for (size_t i = 0; i < size - 1; ++i) {
-                force(ch_p[i], ch_v[i], idx[i], idx[i + 1]);
-            }
+        auto Bi = -dv2 + 2 * gmr1 - 8 * gmr2;
 
-            for (size_t i = 0; i < size - 2; ++i) {
-                force(ch_p[i] + ch_p[i + 1], ch_v[i] + ch_v[i + 1], idx[i], idx[i + 2]);
-            }
+        auto Bj = -dv2 + 2 * gmr2 - 8 * gmr1;
 
-            for (size_t i = 0; i < size; ++i) {
-                for (size_t j = i + 3; j < size; ++j) {
-                    force(p[idx[j]] - p[idx[i]], v[idx[j]] - v[idx[i]], idx[i], idx[j]);
-                }
-            }
+        auto coef = 0.8 * consts::G * consts::G * m[i] * m[j] * pair.inv_r3 * INV_C5;
 
-        } else {
-            for (size_t i = 0; i < num; ++i) {
-                for (size_t j = i + 1; j < num; ++j) {
-                    force(p[j] - p[i], v[j] - v[i], i, j);
-                }
-            }
-        }
+        acceleration[i] += coef * (Ai * n - Bi * dv);
+        acceleration[j] -= coef * (Aj * n - Bj * dv);
     }
 }  // namespace hub::force
@@ -0,0 +1,902 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file soa-kernel.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "../cpu-dispatch.hpp"
+#include "../multi-thread/multi-thread.hpp"
+#include "inv-sqrt.hpp"
+/**
+ * @namespace hub::force::kernel
+ * Structure-of-arrays pair kernels shared by the direct summation forces.
+ */
+namespace hub::force::kernel {
+
+    /**
+     * @brief Particle number above which the direct summation forces switch to the SoA pair kernel.
+     *
+     * Below this number the gather/scatter overhead is larger than the gain of the vectorized inner loop.
+     */
+    inline constexpr size_t soa_threshold{8};
+
+    /**
+     * @brief Particle number above which the pair kernels tile the i-j triangle across the worker threads.
+     *
+     * Below this number the scheduling overhead is larger than the gain of the parallel evaluation.
+     */
+    inline constexpr size_t parallel_threshold{1024};
+
+    /**
+     * @brief Number of tiles of the i-j triangle in the parallel pair kernels.
+     *
+     * Fixed independently of the worker number so that the partial sums, and thereby the results, are the same
+     * on every machine.
+     */
+    inline constexpr size_t parallel_tiles{16};
+
+    /*---------------------------------------------------------------------------*\
+         Class SoAScratch Declaration
+    \*---------------------------------------------------------------------------*/
+
+    /**
+     * @brief Structure-of-arrays copy of positions, masses and accelerations.
+     *
+     * The AoS `Vec3` arrays of the particle system are gathered into separated x/y/z/m streams so that
+     * the inner loop of the pair kernels works on contiguous data and can process several j-partners per
+     * SIMD instruction.
+     *
+     * @tparam T Floating point type of the scratch.
+     */
+    template <typename T>
+    struct SoAScratch {
+        std::vector<T> x, y, z, m, ax, ay, az;
+
+        /**
+         * @brief Single precision positions relative to the centroid and masses, for the far pairs of the mixed
+         * precision kernel.
+         */
+        std::vector<float> lo_x, lo_y, lo_z, lo_m;
+
+        /**
+         * @brief Per tile acceleration accumulators of the parallel kernel.
+         */
+        std::vector<T> tile_acc;
+
+        /**
+         * @brief Number of particles in the scratch.
+         */
+        [[nodiscard]] inline size_t size() const { return m.size(); }
+
+        /**
+         * @brief Gather positions and masses in storage order and zero the accelerations.
+         *
+         * @param[in] pos Position array.
+         * @param[in] mass Mass array.
+         */
+        template <typename VectorArray, typename ScalarArray>
+        void gather(VectorArray const &pos, ScalarArray const &mass);
+
+        /**
+         * @brief Gather positions and masses in the order of `idx` and zero the accelerations.
+         *
+         * @param[in] pos Position array.
+         * @param[in] mass Mass array.
+         * @param[in] idx The k-th element of the scratch is the idx[k]-th particle.
+         */
+        template <typename VectorArray, typename ScalarArray, typename IdxArray>
+        void gather(VectorArray const &pos, ScalarArray const &mass, IdxArray const &idx);
+
+        /**
+         * @brief Copy positions and masses from a chain ordered SoA copy(see `ChainOrdered`) and zero the
+         * accelerations. The k-th element of the scratch is the k-th element of the copy.
+         *
+         * @param[in] ordered Chain ordered copy with contiguous `x`, `y`, `z` and `m`.
+         */
+        template <typename Ordered>
+        void load(Ordered const &ordered);
+
+        /**
+         * @brief Add the accumulated accelerations back to an AoS acceleration array in storage order.
+         *
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename VectorArray>
+        void scatter_add_to(VectorArray &acceleration) const;
+
+        /**
+         * @brief Add the accumulated accelerations back to an AoS acceleration array in the order of `idx`.
+         *
+         * @param[in,out] acceleration 3D vector array to be updated.
+         * @param[in] idx The k-th element of the scratch is the idx[k]-th particle.
+         */
+        template <typename VectorArray, typename IdxArray>
+        void scatter_add_to(VectorArray &acceleration, IdxArray const &idx) const;
+
+        /**
+         * @brief Fill `lo_x`, `lo_y`, `lo_z`, `lo_m` from the gathered positions and masses. The centroid is subtracted first, so the
+         * rounding error of a coordinate is bounded by the size of the system rather than by its distance to the
+         * origin.
+         */
+        void gather_low_precision();
+
+       private:
+        void resize(size_t n);
+    };
+
+    /**
+     * @brief Accumulate the Newtonian acceleration of all pairs (i, j) with j >= i + offset into the scratch.
+     *
+     * Each pair updates both i and j symmetrically. The j-loop is vectorized with AVX-512 (8 lanes) or
+     * AVX2 (4 lanes) if the scratch is double and the running CPU has it(see `cpu::isa()`), the remainder runs in
+     * scalar. Above
+     * `parallel_threshold` particles the rows are split into `parallel_tiles` tiles of equal pair numbers, each
+     * accumulated into its own buffer, and the buffers are reduced in tile order. 1/r^3 follows
+     * `inv_sqrt_policy`.
+     *
+     * @tparam WithPot Also accumulate the pair potential from the 1/r already at hand.
+     * @param[in,out] s SoA scratch with gathered positions and masses.
+     * @param[in] offset Minimum index distance of the pairs. 1 for all pairs, 3 for chain far pairs.
+     * @return T Sum of -m[i]*m[j]/r over the pairs (without the gravitational constant) if `WithPot`, otherwise 0.
+     */
+    template <bool WithPot = false, typename T>
+    T newtonian_pair_acc(SoAScratch<T> &s, size_t offset = 1);
+
+    /**
+     * @brief Mixed precision version of `newtonian_pair_acc`.
+     *
+     * Pairs with r^2 > `far_r2` are evaluated in single precision on `SoAScratch::lo_x`, with AVX-512 (16 lanes) or
+     * AVX2 (8 lanes) if the running CPU has it(see `cpu::isa()`), the near pairs masked out of a SIMD block are evaluated one by one in
+     * T. The single precision partial sums are flushed into T every `details::mixed_fold` partners of a row and
+     * every `details::mixed_row_block` rows, so no float accumulator sums more than about a hundred terms.
+     *
+     * @tparam WithPot Also accumulate the pair potential.
+     * @param[in,out] s SoA scratch with gathered positions and masses.
+     * @param[in] far_r2 Squared distance beyond which a pair is evaluated in single precision.
+     * @param[in] offset Minimum index distance of the pairs. 1 for all pairs, 3 for chain far pairs.
+     * @return T Sum of -m[i]*m[j]/r over the pairs (without the gravitational constant) if `WithPot`, otherwise 0.
+     */
+    template <bool WithPot = false, typename T>
+    T newtonian_mixed_pair_acc(SoAScratch<T> &s, T far_r2, size_t offset = 1);
+
+    /**
+     * @brief Sum of -m[i]*m[j]/r over all pairs (i, j) with j >= i + offset (without the gravitational constant).
+     *
+     * @param[in] s SoA scratch with gathered positions and masses.
+     * @param[in] offset Minimum index distance of the pairs. 1 for all pairs, 3 for chain far pairs.
+     * @return T The pair potential.
+     */
+    template <typename T>
+    T newtonian_pair_pot(SoAScratch<T> const &s, size_t offset = 1);
+
+    /*---------------------------------------------------------------------------*\
+         Class SoAScratch Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T>
+    void SoAScratch<T>::resize(size_t n) {
+        x.resize(n), y.resize(n), z.resize(n), m.resize(n);
+        ax.assign(n, 0), ay.assign(n, 0), az.assign(n, 0);
+    }
+
+    template <typename T>
+    template <typename VectorArray, typename ScalarArray>
+    void SoAScratch<T>::gather(const VectorArray &pos, const ScalarArray &mass) {
+        size_t const n = mass.size();
+        resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            x[k] = static_cast<T>(pos[k].x);
+            y[k] = static_cast<T>(pos[k].y);
+            z[k] = static_cast<T>(pos[k].z);
+            m[k] = static_cast<T>(mass[k]);
+        }
+    }
+
+    template <typename T>
+    template <typename VectorArray, typename ScalarArray, typename IdxArray>
+    void SoAScratch<T>::gather(const VectorArray &pos, const ScalarArray &mass, const IdxArray &idx) {
+        size_t const n = idx.size();
+        resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            x[k] = static_cast<T>(pos[idx[k]].x);
+            y[k] = static_cast<T>(pos[idx[k]].y);
+            z[k] = static_cast<T>(pos[idx[k]].z);
+            m[k] = static_cast<T>(mass[idx[k]]);
+        }
+    }
+
+    template <typename T>
+    template <typename Ordered>
+    void SoAScratch<T>::load(const Ordered &ordered) {
+        size_t const n = ordered.size();
+        resize(n);
+        std::copy(ordered.x.begin(), ordered.x.end(), x.begin());
+        std::copy(ordered.y.begin(), ordered.y.end(), y.begin());
+        std::copy(ordered.z.begin(), ordered.z.end(), z.begin());
+        std::copy(ordered.m.begin(), ordered.m.end(), m.begin());
+    }
+
+    template <typename T>
+    template <typename VectorArray>
+    void SoAScratch<T>::scatter_add_to(VectorArray &acceleration) const {
+        size_t const n = size();
+        for (size_t k = 0; k < n; ++k) {
+            acceleration[k].x += ax[k];
+            acceleration[k].y += ay[k];
+            acceleration[k].z += az[k];
+        }
+    }
+
+    template <typename T>
+    template <typename VectorArray, typename IdxArray>
+    void SoAScratch<T>::scatter_add_to(VectorArray &acceleration, const IdxArray &idx) const {
+        size_t const n = size();
+        for (size_t k = 0; k < n; ++k) {
+            acceleration[idx[k]].x += ax[k];
+            acceleration[idx[k]].y += ay[k];
+            acceleration[idx[k]].z += az[k];
+        }
+    }
+
+    template <typename T>
+    void SoAScratch<T>::gather_low_precision() {
+        size_t const n = size();
+        T cx = 0, cy = 0, cz = 0;
+        for (size_t k = 0; k < n; ++k) {
+            cx += x[k], cy += y[k], cz += z[k];
+        }
+        cx /= static_cast<T>(n), cy /= static_cast<T>(n), cz /= static_cast<T>(n);
+
+        lo_x.resize(n), lo_y.resize(n), lo_z.resize(n), lo_m.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            lo_x[k] = static_cast<float>(x[k] - cx);
+            lo_y[k] = static_cast<float>(y[k] - cy);
+            lo_z[k] = static_cast<float>(z[k] - cz);
+            lo_m[k] = static_cast<float>(m[k]);
+        }
+    }
+
+    /*---------------------------------------------------------------------------*\
+         Newtonian pair kernel Implementation
+    \*---------------------------------------------------------------------------*/
+    namespace details {
+#if defined(SPACEHUB_AVX2_KERNEL)
+        SPACEHUB_TARGET_AVX2 inline double horizontal_add(__m256d v) {
+            __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+        }
+
+        template <bool WithPot, bool Newton>
+        SPACEHUB_TARGET_AVX2 inline size_t newtonian_row_avx2(SoAScratch<double> const &s, size_t i, size_t j, double *ax,
+                                                    double *ay, double *az, double &axi, double &ayi, double &azi,
+                                                    double &pot_i) {
+            size_t const n = s.size();
+            double const *x = s.x.data();
+            double const *y = s.y.data();
+            double const *z = s.z.data();
+            double const *m = s.m.data();
+            constexpr size_t lanes = 4;
+            if (j + lanes > n) return j;
+
+            __m256d const xi = _mm256_set1_pd(x[i]);
+            __m256d const yi = _mm256_set1_pd(y[i]);
+            __m256d const zi = _mm256_set1_pd(z[i]);
+            __m256d const mi = _mm256_set1_pd(m[i]);
+            __m256d const one = _mm256_set1_pd(1.0);
+            __m256d sx = _mm256_setzero_pd();
+            __m256d sy = _mm256_setzero_pd();
+            __m256d sz = _mm256_setzero_pd();
+            [[maybe_unused]] __m256d sp = _mm256_setzero_pd();
+
+            for (; j + lanes <= n; j += lanes) {
+                __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), xi);
+                __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), yi);
+                __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), zi);
+                __m256d r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                           _mm256_mul_pd(dz, dz));
+                __m256d rr3;
+                [[maybe_unused]] __m256d rr;
+                if constexpr (Newton) {
+                    rr = rsqrt_newton(r2);
+                    rr3 = _mm256_mul_pd(rr, _mm256_mul_pd(rr, rr));
+                } else {
+                    __m256d r = _mm256_sqrt_pd(r2);
+                    rr3 = _mm256_div_pd(one, _mm256_mul_pd(r2, r));
+                }
+                __m256d mj = _mm256_loadu_pd(m + j);
+
+                if constexpr (WithPot) {
+                    if constexpr (Newton) {
+                        sp = _mm256_add_pd(sp, _mm256_mul_pd(mj, rr));
+                    } else {
+                        sp = _mm256_add_pd(sp, _mm256_mul_pd(mj, _mm256_mul_pd(rr3, r2)));
+                    }
+                }
+
+                dx = _mm256_mul_pd(dx, rr3);
+                dy = _mm256_mul_pd(dy, rr3);
+                dz = _mm256_mul_pd(dz, rr3);
+
+                sx = _mm256_add_pd(sx, _mm256_mul_pd(dx, mj));
+                sy = _mm256_add_pd(sy, _mm256_mul_pd(dy, mj));
+                sz = _mm256_add_pd(sz, _mm256_mul_pd(dz, mj));
+
+                _mm256_storeu_pd(ax + j, _mm256_sub_pd(_mm256_loadu_pd(ax + j), _mm256_mul_pd(dx, mi)));
+                _mm256_storeu_pd(ay + j, _mm256_sub_pd(_mm256_loadu_pd(ay + j), _mm256_mul_pd(dy, mi)));
+                _mm256_storeu_pd(az + j, _mm256_sub_pd(_mm256_loadu_pd(az + j), _mm256_mul_pd(dz, mi)));
+            }
+            axi += horizontal_add(sx);
+            ayi += horizontal_add(sy);
+            azi += horizontal_add(sz);
+            if constexpr (WithPot) {
+                pot_i += horizontal_add(sp);
+            }
+            return j;
+        }
+#endif
+
+#if defined(SPACEHUB_AVX512_KERNEL)
+// GCC flags the undefined placeholder operands of the AVX-512 intrinsics once they are inlined into a target
+// attributed function.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+        template <bool WithPot, bool Newton>
+        SPACEHUB_TARGET_AVX512 inline size_t newtonian_row_avx512(SoAScratch<double> const &s, size_t i, size_t j, double *ax,
+                                                    double *ay, double *az, double &axi, double &ayi, double &azi,
+                                                    double &pot_i) {
+            size_t const n = s.size();
+            double const *x = s.x.data();
+            double const *y = s.y.data();
+            double const *z = s.z.data();
+            double const *m = s.m.data();
+            constexpr size_t lanes = 8;
+            if (j + lanes > n) return j;
+
+            __m512d const xi = _mm512_set1_pd(x[i]);
+            __m512d const yi = _mm512_set1_pd(y[i]);
+            __m512d const zi = _mm512_set1_pd(z[i]);
+            __m512d const mi = _mm512_set1_pd(m[i]);
+            __m512d const one = _mm512_set1_pd(1.0);
+            __m512d sx = _mm512_setzero_pd();
+            __m512d sy = _mm512_setzero_pd();
+            __m512d sz = _mm512_setzero_pd();
+            [[maybe_unused]] __m512d sp = _mm512_setzero_pd();
+
+            for (; j + lanes <= n; j += lanes) {
+                __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + j), xi);
+                __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + j), yi);
+                __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(z + j), zi);
+                __m512d r2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)),
+                                           _mm512_mul_pd(dz, dz));
+                __m512d rr3;
+                [[maybe_unused]] __m512d rr;
+                if constexpr (Newton) {
+                    rr = rsqrt_newton(r2);
+                    rr3 = _mm512_mul_pd(rr, _mm512_mul_pd(rr, rr));
+                } else {
+                    __m512d r = _mm512_sqrt_pd(r2);
+                    rr3 = _mm512_div_pd(one, _mm512_mul_pd(r2, r));
+                }
+                __m512d mj = _mm512_loadu_pd(m + j);
+
+                if constexpr (WithPot) {
+                    if constexpr (Newton) {
+                        sp = _mm512_add_pd(sp, _mm512_mul_pd(mj, rr));
+                    } else {
+                        sp = _mm512_add_pd(sp, _mm512_mul_pd(mj, _mm512_mul_pd(rr3, r2)));
+                    }
+                }
+
+                dx = _mm512_mul_pd(dx, rr3);
+                dy = _mm512_mul_pd(dy, rr3);
+                dz = _mm512_mul_pd(dz, rr3);
+
+                sx = _mm512_add_pd(sx, _mm512_mul_pd(dx, mj));
+                sy = _mm512_add_pd(sy, _mm512_mul_pd(dy, mj));
+                sz = _mm512_add_pd(sz, _mm512_mul_pd(dz, mj));
+
+                _mm512_storeu_pd(ax + j, _mm512_sub_pd(_mm512_loadu_pd(ax + j), _mm512_mul_pd(dx, mi)));
+                _mm512_storeu_pd(ay + j, _mm512_sub_pd(_mm512_loadu_pd(ay + j), _mm512_mul_pd(dy, mi)));
+                _mm512_storeu_pd(az + j, _mm512_sub_pd(_mm512_loadu_pd(az + j), _mm512_mul_pd(dz, mi)));
+            }
+            axi += _mm512_reduce_add_pd(sx);
+            ayi += _mm512_reduce_add_pd(sy);
+            azi += _mm512_reduce_add_pd(sz);
+            if constexpr (WithPot) {
+                pot_i += _mm512_reduce_add_pd(sp);
+            }
+            return j;
+        }
+#pragma GCC diagnostic pop
+#endif
+
+        /**
+         * @brief Vectorized part of the i-th row of the pair kernel, in the widest variant `cpu::isa()` allows.
+         *
+         * @tparam Newton Use `rsqrt_newton` instead of sqrt and division(see `inv_sqrt_policy`).
+         * @return The first j that is left for the scalar remainder loop.
+         */
+        template <bool WithPot, bool Newton>
+        inline size_t newtonian_row_simd(SoAScratch<double> const &s, size_t i, size_t j, double *ax, double *ay,
+                                         double *az, double &axi, double &ayi, double &azi, double &pot_i) {
+            switch (cpu::isa()) {
+#if defined(SPACEHUB_AVX512_KERNEL)
+                case cpu::Isa::AVX512:
+                    return newtonian_row_avx512<WithPot, Newton>(s, i, j, ax, ay, az, axi, ayi, azi, pot_i);
+#endif
+#if defined(SPACEHUB_AVX2_KERNEL)
+                case cpu::Isa::AVX2:
+                    return newtonian_row_avx2<WithPot, Newton>(s, i, j, ax, ay, az, axi, ayi, azi, pot_i);
+#endif
+                default:
+                    return j;
+            }
+        }
+
+        template <bool WithPot, bool Newton, typename T>
+        T newtonian_pair_rows(SoAScratch<T> const &s, size_t row_begin, size_t row_end, size_t offset, T *ax, T *ay,
+                              T *az) {
+            size_t const n = s.size();
+            T const *x = s.x.data();
+            T const *y = s.y.data();
+            T const *z = s.z.data();
+            T const *m = s.m.data();
+
+            T pot = 0;
+            for (size_t i = row_begin; i < row_end; ++i) {
+                T axi = 0, ayi = 0, azi = 0, pot_i = 0;
+                size_t j = i + offset;
+
+                if constexpr (std::is_same_v<T, double>) {
+                    j = newtonian_row_simd<WithPot, Newton>(s, i, j, ax, ay, az, axi, ayi, azi, pot_i);
+                }
+
+                for (; j < n; ++j) {
+                    T dx = x[j] - x[i];
+                    T dy = y[j] - y[i];
+                    T dz = z[j] - z[i];
+                    T r2 = dx * dx + dy * dy + dz * dz;
+                    T rr3;
+                    if constexpr (Newton) {
+                        T rr = rsqrt_newton(r2);
+                        rr3 = rr * rr * rr;
+                    } else {
+                        rr3 = 1 / (r2 * std::sqrt(r2));
+                    }
+                    if constexpr (WithPot) {
+                        pot_i += m[j] * rr3 * r2;
+                    }
+                    dx *= rr3, dy *= rr3, dz *= rr3;
+                    axi += dx * m[j], ayi += dy * m[j], azi += dz * m[j];
+                    ax[j] -= dx * m[i], ay[j] -= dy * m[i], az[j] -= dz * m[i];
+                }
+                ax[i] += axi, ay[i] += ayi, az[i] += azi;
+                if constexpr (WithPot) {
+                    pot -= m[i] * pot_i;
+                }
+            }
+            return pot;
+        }
+
+        template <bool Newton, typename T>
+        T newtonian_pot_rows(SoAScratch<T> const &s, size_t row_begin, size_t row_end, size_t offset) {
+            size_t const n = s.size();
+            T const *x = s.x.data();
+            T const *y = s.y.data();
+            T const *z = s.z.data();
+            T const *m = s.m.data();
+
+            T pot = 0;
+            for (size_t i = row_begin; i < row_end; ++i) {
+                T pot_i = 0;
+                for (size_t j = i + offset; j < n; ++j) {
+                    T dx = x[j] - x[i];
+                    T dy = y[j] - y[i];
+                    T dz = z[j] - z[i];
+                    if constexpr (Newton) {
+                        pot_i += m[j] * rsqrt_newton(dx * dx + dy * dy + dz * dz);
+                    } else {
+                        pot_i += m[j] / std::sqrt(dx * dx + dy * dy + dz * dz);
+                    }
+                }
+                pot -= m[i] * pot_i;
+            }
+            return pot;
+        }
+
+        /**
+         * @brief Rows of the mixed precision kernel are processed in blocks of this size, after which the single
+         * precision accumulators of the j-partners are flushed into T.
+         */
+        inline constexpr size_t mixed_row_block{32};
+
+        /**
+         * @brief The single precision partial sums of the i-th row are flushed into T every `mixed_fold` partners.
+         */
+        inline constexpr size_t mixed_fold{128};
+
+        /**
+         * @brief Full precision evaluation of a near pair of the mixed precision kernel.
+         */
+        template <bool WithPot, typename T>
+        inline void mixed_near_pair(SoAScratch<T> const &s, size_t i, size_t j, T *ax, T *ay, T *az, T &axi, T &ayi,
+                                    T &azi, T &pot_i) {
+            T dx = s.x[j] - s.x[i];
+            T dy = s.y[j] - s.y[i];
+            T dz = s.z[j] - s.z[i];
+            T r2 = dx * dx + dy * dy + dz * dz;
+            T rr3 = 1 / (r2 * std::sqrt(r2));
+            if constexpr (WithPot) {
+                pot_i += s.m[j] * rr3 * r2;
+            }
+            dx *= rr3, dy *= rr3, dz *= rr3;
+            axi += dx * s.m[j], ayi += dy * s.m[j], azi += dz * s.m[j];
+            ax[j] -= dx * s.m[i], ay[j] -= dy * s.m[i], az[j] -= dz * s.m[i];
+        }
+
+#if defined(SPACEHUB_AVX2_KERNEL)
+        SPACEHUB_TARGET_AVX2 inline float horizontal_add(__m256 v) {
+            __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+            return _mm_cvtss_f32(_mm_add_ss(lo, _mm_movehdup_ps(lo)));
+        }
+
+        template <bool WithPot, typename T>
+        SPACEHUB_TARGET_AVX2 inline size_t newtonian_mixed_row_avx2(SoAScratch<T> const &s, size_t i, size_t j, float far,
+                                                          float *lax, float *lay, float *laz, T *ax, T *ay, T *az,
+                                                          T &axi, T &ayi, T &azi, T &pot_i) {
+            size_t const n = s.size();
+            float const *x = s.lo_x.data();
+            float const *y = s.lo_y.data();
+            float const *z = s.lo_z.data();
+            float const *m = s.lo_m.data();
+            constexpr size_t lanes = 8;
+            if (j + lanes > n) return j;
+
+            __m256 const xi = _mm256_set1_ps(x[i]);
+            __m256 const yi = _mm256_set1_ps(y[i]);
+            __m256 const zi = _mm256_set1_ps(z[i]);
+            __m256 const mi = _mm256_set1_ps(m[i]);
+            __m256 const far_r2 = _mm256_set1_ps(far);
+            __m256 const one = _mm256_set1_ps(1.0f);
+
+            while (j + lanes <= n) {
+                size_t const fold_end = std::min(n, j + mixed_fold);
+                __m256 sx = _mm256_setzero_ps();
+                __m256 sy = _mm256_setzero_ps();
+                __m256 sz = _mm256_setzero_ps();
+                [[maybe_unused]] __m256 sp = _mm256_setzero_ps();
+
+                for (; j + lanes <= fold_end; j += lanes) {
+                    __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), xi);
+                    __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), yi);
+                    __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + j), zi);
+                    __m256 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                              _mm256_mul_ps(dz, dz));
+                    __m256 is_far = _mm256_cmp_ps(r2, far_r2, _CMP_GT_OQ);
+                    __m256 r = _mm256_sqrt_ps(r2);
+                    __m256 rr3 = _mm256_and_ps(is_far, _mm256_div_ps(one, _mm256_mul_ps(r2, r)));
+                    __m256 mj = _mm256_loadu_ps(m + j);
+
+                    if constexpr (WithPot) {
+                        sp = _mm256_add_ps(sp, _mm256_mul_ps(mj, _mm256_mul_ps(rr3, r2)));
+                    }
+
+                    dx = _mm256_mul_ps(dx, rr3);
+                    dy = _mm256_mul_ps(dy, rr3);
+                    dz = _mm256_mul_ps(dz, rr3);
+
+                    sx = _mm256_add_ps(sx, _mm256_mul_ps(dx, mj));
+                    sy = _mm256_add_ps(sy, _mm256_mul_ps(dy, mj));
+                    sz = _mm256_add_ps(sz, _mm256_mul_ps(dz, mj));
+
+                    _mm256_storeu_ps(lax + j, _mm256_sub_ps(_mm256_loadu_ps(lax + j), _mm256_mul_ps(dx, mi)));
+                    _mm256_storeu_ps(lay + j, _mm256_sub_ps(_mm256_loadu_ps(lay + j), _mm256_mul_ps(dy, mi)));
+                    _mm256_storeu_ps(laz + j, _mm256_sub_ps(_mm256_loadu_ps(laz + j), _mm256_mul_ps(dz, mi)));
+
+                    for (unsigned near = ~static_cast<unsigned>(_mm256_movemask_ps(is_far)) & 0xFFu; near != 0;
+                         near &= near - 1) {
+                        mixed_near_pair<WithPot>(s, i, j + __builtin_ctz(near), ax, ay, az, axi, ayi, azi, pot_i);
+                    }
+                }
+                axi += horizontal_add(sx);
+                ayi += horizontal_add(sy);
+                azi += horizontal_add(sz);
+                if constexpr (WithPot) {
+                    pot_i += horizontal_add(sp);
+                }
+            }
+            return j;
+        }
+#endif
+
+#if defined(SPACEHUB_AVX512_KERNEL)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+        template <bool WithPot, typename T>
+        SPACEHUB_TARGET_AVX512 inline size_t newtonian_mixed_row_avx512(SoAScratch<T> const &s, size_t i, size_t j, float far,
+                                                          float *lax, float *lay, float *laz, T *ax, T *ay, T *az,
+                                                          T &axi, T &ayi, T &azi, T &pot_i) {
+            size_t const n = s.size();
+            float const *x = s.lo_x.data();
+            float const *y = s.lo_y.data();
+            float const *z = s.lo_z.data();
+            float const *m = s.lo_m.data();
+            constexpr size_t lanes = 16;
+            if (j + lanes > n) return j;
+
+            __m512 const xi = _mm512_set1_ps(x[i]);
+            __m512 const yi = _mm512_set1_ps(y[i]);
+            __m512 const zi = _mm512_set1_ps(z[i]);
+            __m512 const mi = _mm512_set1_ps(m[i]);
+            __m512 const far_r2 = _mm512_set1_ps(far);
+            __m512 const one = _mm512_set1_ps(1.0f);
+
+            while (j + lanes <= n) {
+                size_t const fold_end = std::min(n, j + mixed_fold);
+                __m512 sx = _mm512_setzero_ps();
+                __m512 sy = _mm512_setzero_ps();
+                __m512 sz = _mm512_setzero_ps();
+                [[maybe_unused]] __m512 sp = _mm512_setzero_ps();
+
+                for (; j + lanes <= fold_end; j += lanes) {
+                    __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + j), xi);
+                    __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + j), yi);
+                    __m512 dz = _mm512_sub_ps(_mm512_loadu_ps(z + j), zi);
+                    __m512 r2 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)),
+                                              _mm512_mul_ps(dz, dz));
+                    __mmask16 is_far = _mm512_cmp_ps_mask(r2, far_r2, _CMP_GT_OQ);
+                    __m512 r = _mm512_sqrt_ps(r2);
+                    __m512 rr3 = _mm512_maskz_div_ps(is_far, one, _mm512_mul_ps(r2, r));
+                    __m512 mj = _mm512_loadu_ps(m + j);
+
+                    if constexpr (WithPot) {
+                        sp = _mm512_add_ps(sp, _mm512_mul_ps(mj, _mm512_mul_ps(rr3, r2)));
+                    }
+
+                    dx = _mm512_mul_ps(dx, rr3);
+                    dy = _mm512_mul_ps(dy, rr3);
+                    dz = _mm512_mul_ps(dz, rr3);
+
+                    sx = _mm512_add_ps(sx, _mm512_mul_ps(dx, mj));
+                    sy = _mm512_add_ps(sy, _mm512_mul_ps(dy, mj));
+                    sz = _mm512_add_ps(sz, _mm512_mul_ps(dz, mj));
+
+                    _mm512_storeu_ps(lax + j, _mm512_sub_ps(_mm512_loadu_ps(lax + j), _mm512_mul_ps(dx, mi)));
+                    _mm512_storeu_ps(lay + j, _mm512_sub_ps(_mm512_loadu_ps(lay + j), _mm512_mul_ps(dy, mi)));
+                    _mm512_storeu_ps(laz + j, _mm512_sub_ps(_mm512_loadu_ps(laz + j), _mm512_mul_ps(dz, mi)));
+
+                    for (unsigned near = static_cast<unsigned>(~is_far) & 0xFFFFu; near != 0; near &= near - 1) {
+                        mixed_near_pair<WithPot>(s, i, j + __builtin_ctz(near), ax, ay, az, axi, ayi, azi, pot_i);
+                    }
+                }
+                axi += _mm512_reduce_add_ps(sx);
+                ayi += _mm512_reduce_add_ps(sy);
+                azi += _mm512_reduce_add_ps(sz);
+                if constexpr (WithPot) {
+                    pot_i += _mm512_reduce_add_ps(sp);
+                }
+            }
+            return j;
+        }
+#pragma GCC diagnostic pop
+#endif
+
+        /**
+         * @brief Vectorized part of the i-th row of the mixed precision kernel, in the widest variant `cpu::isa()`
+         * allows. The far pairs of a SIMD block are evaluated in single precision, the near pairs, masked out of the
+         * block, one by one in T.
+         *
+         * @return The first j that is left for the scalar remainder loop.
+         */
+        template <bool WithPot, typename T>
+        inline size_t newtonian_mixed_row_simd(SoAScratch<T> const &s, size_t i, size_t j, float far, float *lax,
+                                               float *lay, float *laz, T *ax, T *ay, T *az, T &axi, T &ayi, T &azi,
+                                               T &pot_i) {
+            switch (cpu::isa()) {
+#if defined(SPACEHUB_AVX512_KERNEL)
+                case cpu::Isa::AVX512:
+                    return newtonian_mixed_row_avx512<WithPot>(s, i, j, far, lax, lay, laz, ax, ay, az, axi, ayi, azi,
+                                                               pot_i);
+#endif
+#if defined(SPACEHUB_AVX2_KERNEL)
+                case cpu::Isa::AVX2:
+                    return newtonian_mixed_row_avx2<WithPot>(s, i, j, far, lax, lay, laz, ax, ay, az, axi, ayi, azi,
+                                                             pot_i);
+#endif
+                default:
+                    return j;
+            }
+        }
+
+        template <bool WithPot, typename T>
+        T newtonian_mixed_rows(SoAScratch<T> const &s, size_t row_begin, size_t row_end, size_t offset, T far_r2,
+                               T *ax, T *ay, T *az) {
+            size_t const n = s.size();
+            float const *x = s.lo_x.data();
+            float const *y = s.lo_y.data();
+            float const *z = s.lo_z.data();
+            float const *m = s.lo_m.data();
+            float const far = far_r2 < std::numeric_limits<float>::max() ? static_cast<float>(far_r2)
+                                                                          : std::numeric_limits<float>::infinity();
+
+            std::vector<float> lo_acc(3 * n, 0.0f);
+            float *lax = lo_acc.data();
+            float *lay = lax + n;
+            float *laz = lay + n;
+
+            T pot = 0;
+            for (size_t i0 = row_begin; i0 < row_end; i0 += mixed_row_block) {
+                size_t const i1 = std::min(row_end, i0 + mixed_row_block);
+
+                for (size_t i = i0; i < i1; ++i) {
+                    T axi = 0, ayi = 0, azi = 0, pot_i = 0;
+                    size_t j = newtonian_mixed_row_simd<WithPot>(s, i, i + offset, far, lax, lay, laz, ax, ay, az,
+                                                                 axi, ayi, azi, pot_i);
+                    for (; j < n; ++j) {
+                        float dx = x[j] - x[i];
+                        float dy = y[j] - y[i];
+                        float dz = z[j] - z[i];
+                        float r2 = dx * dx + dy * dy + dz * dz;
+                        if (r2 > far) {
+                            float rr3 = 1.0f / (r2 * std::sqrt(r2));
+                            if constexpr (WithPot) {
+                                pot_i += m[j] * rr3 * r2;
+                            }
+                            dx *= rr3, dy *= rr3, dz *= rr3;
+                            axi += dx * m[j], ayi += dy * m[j], azi += dz * m[j];
+                            lax[j] -= dx * m[i], lay[j] -= dy * m[i], laz[j] -= dz * m[i];
+                        } else {
+                            mixed_near_pair<WithPot>(s, i, j, ax, ay, az, axi, ayi, azi, pot_i);
+                        }
+                    }
+                    ax[i] += axi, ay[i] += ayi, az[i] += azi;
+                    if constexpr (WithPot) {
+                        pot -= s.m[i] * pot_i;
+                    }
+                }
+
+                for (size_t j = i0 + offset; j < n; ++j) {
+                    ax[j] += lax[j], ay[j] += lay[j], az[j] += laz[j];
+                    lax[j] = lay[j] = laz[j] = 0;
+                }
+            }
+            return pot;
+        }
+
+        /**
+         * @brief Split the rows of the pair triangle into `tiles` consecutive ranges with similar pair numbers.
+         *
+         * @return Row boundaries, tile t covers rows [bound[t], bound[t+1]).
+         */
+        inline std::vector<size_t> balanced_rows(size_t n, size_t offset, size_t tiles) {
+            auto pairs_in_row = [=](size_t i) { return i + offset < n ? n - i - offset : 0; };
+            size_t total = 0;
+            for (size_t i = 0; i < n; ++i) total += pairs_in_row(i);
+
+            std::vector<size_t> bound(tiles + 1, n);
+            bound[0] = 0;
+            size_t t = 1, acc = 0;
+            for (size_t i = 0; i < n && t < tiles; ++i) {
+                acc += pairs_in_row(i);
+                while (t < tiles && acc * tiles >= total * t) {
+                    bound[t++] = i + 1;
+                }
+            }
+            return bound;
+        }
+
+        /**
+         * @brief Run `rows(row_begin, row_end, ax, ay, az)` over the pair triangle, in parallel tiles above
+         * `parallel_threshold` particles, and accumulate the accelerations into the scratch.
+         *
+         * @return The sum of the values returned by `rows`.
+         */
+        template <typename T, typename Rows>
+        T tiled_pair_rows(SoAScratch<T> &s, size_t offset, Rows &&rows) {
+            size_t const n = s.size();
+
+            if (n < parallel_threshold) {
+                return rows(0, n, s.ax.data(), s.ay.data(), s.az.data());
+            }
+
+            auto const bound = balanced_rows(n, offset, parallel_tiles);
+            s.tile_acc.assign(3 * n * parallel_tiles, 0);
+            std::array<T, parallel_tiles> partial{};
+
+            multi_thread::parallel_for_tasks(parallel_tiles, [&](size_t t) {
+                T *buf = s.tile_acc.data() + 3 * n * t;
+                partial[t] = rows(bound[t], bound[t + 1], buf, buf + n, buf + 2 * n);
+            });
+
+            size_t const chunk = (n + parallel_tiles - 1) / parallel_tiles;
+            multi_thread::parallel_for_tasks(parallel_tiles, [&](size_t c) {
+                size_t const end = std::min(n, (c + 1) * chunk);
+                for (size_t t = 0; t < parallel_tiles; ++t) {
+                    T const *buf = s.tile_acc.data() + 3 * n * t;
+                    for (size_t k = c * chunk; k < end; ++k) {
+                        s.ax[k] += buf[k], s.ay[k] += buf[k + n], s.az[k] += buf[k + 2 * n];
+                    }
+                }
+            });
+
+            T sum = 0;
+            for (auto p : partial) sum += p;
+            return sum;
+        }
+    }  // namespace details
+
+    template <bool WithPot, typename T>
+    T newtonian_pair_acc(SoAScratch<T> &s, size_t offset) {
+        if (use_newton_rsqrt<T>()) {
+            return details::tiled_pair_rows(s, offset, [&](size_t begin, size_t end, T *ax, T *ay, T *az) {
+                return details::newtonian_pair_rows<WithPot, true>(s, begin, end, offset, ax, ay, az);
+            });
+        } else {
+            return details::tiled_pair_rows(s, offset, [&](size_t begin, size_t end, T *ax, T *ay, T *az) {
+                return details::newtonian_pair_rows<WithPot, false>(s, begin, end, offset, ax, ay, az);
+            });
+        }
+    }
+
+    template <bool WithPot, typename T>
+    T newtonian_mixed_pair_acc(SoAScratch<T> &s, T far_r2, size_t offset) {
+        if constexpr (sizeof(T) <= sizeof(float)) {
+            return newtonian_pair_acc<WithPot>(s, offset);
+        } else {
+            s.gather_low_precision();
+            return details::tiled_pair_rows(s, offset, [&](size_t begin, size_t end, T *ax, T *ay, T *az) {
+                return details::newtonian_mixed_rows<WithPot>(s, begin, end, offset, far_r2, ax, ay, az);
+            });
+        }
+    }
+
+    template <typename T>
+    T newtonian_pair_pot(SoAScratch<T> const &s, size_t offset) {
+        size_t const n = s.size();
+        bool const newton = use_newton_rsqrt<T>();
+        auto rows = [&](size_t begin, size_t end) {
+            return newton ? details::newtonian_pot_rows<true>(s, begin, end, offset)
+                          : details::newtonian_pot_rows<false>(s, begin, end, offset);
+        };
+
+        if (n < parallel_threshold) {
+            return rows(0, n);
+        }
+
+        auto const bound = details::balanced_rows(n, offset, parallel_tiles);
+        std::array<T, parallel_tiles> partial{};
+
+        multi_thread::parallel_for_tasks(parallel_tiles, [&](size_t t) { partial[t] = rows(bound[t], bound[t + 1]); });
+
+        T pot = 0;
+        for (auto p : partial) pot += p;
+        return pot;
+    }
+}  // namespace hub::force::kernel
@@ -24,9 +24,24 @@ License
  */
 #pragma once
 
+#include <vector>
+
 #include "../dev-tools.hpp"
+#include "../macros.hpp"
 #include "../spacehub-concepts.hpp"
+#include "pair-loop.hpp"
 namespace hub::force {
+    /*---------------------------------------------------------------------------*\
+         Class Tidal Declaration
+    \*---------------------------------------------------------------------------*/
+
+    /**
+     * @brief Equilibrium tide with constant time lag.
+     *
+     * Only particles with a non-zero apsidal constant raise tides. They are collected together with their k*R^5 at
+     * the beginning of every evaluation, and only their pairs with the other particles are walked(see
+     * `force::for_each_active_pair`).
+     */
     class Tidal {
        public:
         constexpr static bool vel_dependent{true};
@@ -34,77 +49,47 @@ namespace hub::force {
         // Type members
         template <typename Particles>
         static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
-
-       private:
-        CREATE_METHOD_CHECK(chain_pos);
-
-        CREATE_METHOD_CHECK(chain_vel);
-
-        CREATE_METHOD_CHECK(index);
     };
 
+    /*---------------------------------------------------------------------------*\
+         Class Tidal Implementation
+    \*---------------------------------------------------------------------------*/
     template <typename Particles>
     void Tidal::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
-        size_t num = particles.number();
-        auto const &p = particles.pos();
-        auto const &v = particles.vel();
+        using Scalar = typename Particles::Scalar;
+
         auto const &m = particles.mass();
         auto const &k = particles.tide_apsidal_const();
         auto const &tau = particles.tide_lag_time();
         auto const &rad = particles.radius();
+        size_t num = particles.number();
 
-        auto force = [&](auto const &dr, auto const &dv, auto i, auto j) {
-            if (k[i] != 0 || k[j] != 0) {
-                auto r = norm(dr);
-                auto r2 = r * r;
-                auto r4 = r2 * r2;
-                auto r8 = r4 * r4;
-                if (k[i] != 0) {
-                    auto rad2 = rad[i] * rad[i];
-                    auto rad4 = rad2 * rad2;
-                    auto rad5 = rad4 * rad[i];
-                    auto coef = 3 * consts::G * k[i] * rad5 * m[j] * m[j] * (1 + 3 * tau[i] * dot(dv, dr) / r2) / r8;
-                    acceleration[i] += coef / m[i] * dr;
-                    acceleration[j] -= coef / m[j] * dr;
-                }
-                if (k[j] != 0) {
-                    auto rad2 = rad[j] * rad[j];
-                    auto rad4 = rad2 * rad2;
-                    auto rad5 = rad4 * rad[j];
-                    auto coef = 3 * consts::G * k[j] * rad5 * m[i] * m[i] * (1 + 3 * tau[j] * dot(dv, dr) / r2) / r8;
-                    acceleration[i] += coef / m[i] * dr;
-                    acceleration[j] -= coef / m[j] * dr;
-                }
-            }
-        };
-
-        if constexpr (HAS_METHOD(Particles, chain_pos) && HAS_METHOD(Particles, index) &&
-                      HAS_METHOD(Particles, chain_vel)) {
-            auto const &ch_p = particles.chain_pos();
-            auto const &ch_v = particles.chain_vel();
-            auto const &idx = particles.index();
-
-            size_t size = particles.number();
-
-            for (size_t i = 0; i < size; ++i) {
-                for (size_t j = i + 3; j < size; ++j) {
-                    force(p[idx[j]] - p[idx[i]], v[idx[j]] - v[idx[i]], idx[i], idx[j]);
-                }
-            }
+        static thread_local std::vector<size_t> active;
+        static thread_local std::vector<Scalar> k_rad5;
 
-            for (size_t i = 0; i < size - 2; ++i) {
-                force(ch_p[i] + ch_p[i + 1], ch_v[i] + ch_v[i + 1], idx[i], idx[i + 2]);
+        active.clear();
+        k_rad5.resize(num);
+        for (size_t i = 0; i < num; ++i) {
+            if (k[i] != 0) {
+                auto rad2 = rad[i] * rad[i];
+                auto rad4 = rad2 * rad2;
+                k_rad5[i] = 3 * consts::G * k[i] * rad4 * rad[i];
+                active.push_back(i);
             }
+        }
 
-            for (size_t i = 0; i < size - 1; ++i) {
-                force(ch_p[i], ch_v[i], idx[i], idx[i + 1]);
-            }
-        } else {
-            for (size_t i = 0; i < num; ++i) {
-                for (size_t j = i + 1; j < num; ++j) {
-                    force(p[j] - p[i], v[j] - v[i], i, j);
-                }
-            }
+        if (active.empty()) {
+            return;
         }
+
+        for_each_active_pair<true>(particles, active, [&](auto const &pair) {
+            auto i = pair.i;
+            auto j = pair.j;
+            auto inv_r2 = pair.inv_r * pair.inv_r;
+            auto inv_r4 = inv_r2 * inv_r2;
+            auto coef = k_rad5[i] * m[j] * m[j] * (1 + 3 * tau[i] * dot(pair.dv, pair.dr) * inv_r2) * inv_r4 * inv_r4;
+            acceleration[i] += coef / m[i] * pair.dr;
+            acceleration[j] -= coef / m[j] * pair.dr;
+        });
     }
 }  // namespace hub::force
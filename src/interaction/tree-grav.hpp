@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file tree-grav.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <type_traits>
+
+#include "../dev-tools.hpp"
+#include "../multi-thread/multi-thread.hpp"
+#include "../particle-system/octree.hpp"
+#include "../spacehub-concepts.hpp"
+#include "soa-kernel.hpp"
+/**
+ * @namespace hub::force
+ * Documentation for hub
+ */
+namespace hub::force {
+    /*---------------------------------------------------------------------------*\
+         Class TreeGrav Declaration
+    \*---------------------------------------------------------------------------*/
+
+    /**
+     * @brief Barnes-Hut tree gravity with monopole and quadrupole cell moments.
+     *
+     * Drop-in replacement of `NewtonianGrav` as the internal force of `force::Interactions` for large N. The octree
+     * is fully rebuilt every `rebuild_interval` evaluations, the evaluations in between only refit the cell moments
+     * to the current positions. The tree is kept per thread and rebuilt whenever the evaluated system changes,
+     * identified by its `layout_key()` (see `force::LayoutKey`) or, for the containers without one, by its address
+     * and particle number. A system changes its key when it reorders its particles(see
+     * `particles::SpaceFillingOrder`), which forces a rebuild since the leaves hold storage indices.
+     *
+     * @note The cell acceptance makes the force only piecewise smooth. Use it with the symplectic methods
+     * (e.g. `methods::Sym4`) rather than the extrapolation methods.
+     */
+    class TreeGrav {
+       public:
+        /**
+         * @brief Is this force velocity dependent?
+         *
+         */
+        constexpr static bool vel_dependent{false};
+
+        /**
+         * @brief Opening angle. Cells with b_max < opening_angle * distance are treated as multipoles. 0 gives the
+         * direct summation.
+         */
+        inline static double opening_angle{0.5};
+
+        /**
+         * @brief Number of force evaluations between two full rebuilds of the tree.
+         */
+        inline static size_t rebuild_interval{16};
+
+        /**
+         * @brief Add the tree acceleration to existing 3D vector array.
+         *
+         * @note this method ADD acceleration TO input 'acceleration'.
+         *
+         * @tparam Particles Particle system type satisfy concept particle system.
+         * @param[in] particles Particle system that is used to evaluated the acceleration.
+         * @param[in,out] acceleration 3D vector array to be updated.
+         */
+        template <typename Particles>
+        static void add_acc_to(Particles const &particles, typename Particles::VectorArray &acceleration);
+
+       private:
+        CREATE_METHOD_CHECK(layout_key);
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class TreeGrav Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename Particles>
+    void TreeGrav::add_acc_to(const Particles &particles, typename Particles::VectorArray &acceleration) {
+        using Scalar = typename Particles::Scalar;
+        static_assert(std::is_floating_point_v<Scalar>, "TreeGrav requires a floating point scalar type!");
+
+        static thread_local octree::Octree<Scalar> tree;
+        static thread_local size_t eval_since_build{0};
+        static thread_local size_t tree_key{0};
+        static thread_local void const *tree_owner{nullptr};
+
+        size_t const num = particles.number();
+        auto const &p = particles.pos();
+        auto const &m = particles.mass();
+
+        size_t key{0};
+        if constexpr (HAS_METHOD(Particles, layout_key)) {
+            key = particles.layout_key();
+        }
+        void const *owner = &particles;
+
+        if (key != tree_key || owner != tree_owner || tree.number() != num ||
+            ++eval_since_build >= rebuild_interval) {
+            tree.build(p, m);
+            tree_key = key;
+            tree_owner = owner;
+            eval_since_build = 0;
+        } else {
+            tree.refit(p, m);
+        }
+
+        auto const &order = tree.order();
+        auto const theta = static_cast<Scalar>(opening_angle);
+        size_t const tasks = num < kernel::parallel_threshold ? 1 : kernel::parallel_tiles;
+        size_t const chunk = (num + tasks - 1) / tasks;
+
+        // walk the particles in tree order, neighbouring walks visit the same cells
+        multi_thread::parallel_for_tasks(tasks, [&](size_t t) {
+            size_t const end = std::min(num, (t + 1) * chunk);
+            for (size_t k = t * chunk; k < end; ++k) {
+                size_t i = order[k];
+                acceleration[i] += tree.acc(i, p, m, theta);
+            }
+        });
+    }
+}  // namespace hub::force
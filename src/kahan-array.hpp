@@ -0,0 +1,298 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file kahan-array.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "kahan-number.hpp"
+#include "small-vector.hpp"
+
+namespace hub {
+    /*---------------------------------------------------------------------------*\
+         Class KahanArray Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Array of `Kahan` numbers stored as two separate streams, `real[]` and `err[]`.
+     *
+     * Used as the `StateScalarArray` of the `Kahan` type systems(the `_Plus` methods). An array of `Kahan` interleaves
+     * the value and the compensation of every element, so the compensated updates of `calc::array_advance` load and
+     * store strided pairs. With the two streams the updates are plain element-wise loops that the compiler
+     * vectorizes(see the `KahanArray` overloads in `core-computation.hpp`).
+     *
+     * Element access goes through the proxy `KahanArray::reference`, which reads as a `Kahan` and applies `+=`/`-=`
+     * as the `Kahan` operators do, so the generic code written for `Container<Kahan<T>>` works unchanged and gives
+     * the same results bit for bit.
+     *
+     * @tparam T Scalar type of the streams.
+     */
+    template <typename T>
+    class KahanArray {
+       public:
+        using value_type = Kahan<T>;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using Stream = llvm::SmallVector<T, 16>;
+
+        /**
+         * @brief Proxy of an element of the array.
+         */
+        class reference {
+           public:
+            reference(T &real, T &err) : real_{&real}, err_{&err} {}
+
+            reference(reference const &) = default;
+
+            inline operator value_type() const {
+                value_type k;
+                k.real = *real_, k.err = *err_;
+                return k;
+            }
+
+            inline operator T() const { return *real_; }
+
+            inline reference &operator=(reference const &rhs) {
+                *real_ = *rhs.real_, *err_ = *rhs.err_;
+                return *this;
+            }
+
+            inline reference &operator=(value_type const &rhs) {
+                *real_ = rhs.real, *err_ = rhs.err;
+                return *this;
+            }
+
+            inline reference &operator+=(value_type const &rhs) {
+                T add = rhs.real - *err_;
+                T sum = *real_ + add;
+                *err_ = (sum - *real_) - add;
+                *real_ = sum;
+                return *this;
+            }
+
+            inline reference &operator-=(value_type const &rhs) {
+                T add = -rhs.real - *err_;
+                T sum = *real_ + add;
+                *err_ = (sum - *real_) - add;
+                *real_ = sum;
+                return *this;
+            }
+
+            inline reference &operator*=(value_type const &rhs) {
+                *real_ *= rhs.real;
+                return *this;
+            }
+
+            inline reference &operator/=(value_type const &rhs) {
+                *real_ /= rhs.real;
+                return *this;
+            }
+
+            friend void swap(reference a, reference b) {
+                std::swap(*a.real_, *b.real_);
+                std::swap(*a.err_, *b.err_);
+            }
+
+           private:
+            T *real_;
+            T *err_;
+        };
+
+        using const_reference = value_type;
+
+        /**
+         * @brief Random access iterator over the elements, dereferenced to `reference`(or `value_type` if `Const`).
+         */
+        template <bool Const>
+        class Iterator {
+           public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Kahan<T>;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, value_type, typename KahanArray::reference>;
+            using pointer = void;
+            using Owner = std::conditional_t<Const, KahanArray const, KahanArray>;
+
+            Iterator() = default;
+
+            Iterator(Owner *array, difference_type i) : array_{array}, i_{i} {}
+
+            operator Iterator<true>() const { return Iterator<true>{array_, i_}; }
+
+            inline reference operator*() const { return (*array_)[i_]; }
+
+            inline reference operator[](difference_type n) const { return (*array_)[i_ + n]; }
+
+            inline Iterator &operator++() { return ++i_, *this; }
+
+            inline Iterator operator++(int) { return Iterator{array_, i_++}; }
+
+            inline Iterator &operator--() { return --i_, *this; }
+
+            inline Iterator operator--(int) { return Iterator{array_, i_--}; }
+
+            inline Iterator &operator+=(difference_type n) { return i_ += n, *this; }
+
+            inline Iterator &operator-=(difference_type n) { return i_ -= n, *this; }
+
+            friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+
+            friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+
+            friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+            friend difference_type operator-(Iterator const &a, Iterator const &b) { return a.i_ - b.i_; }
+
+            friend bool operator==(Iterator const &a, Iterator const &b) { return a.i_ == b.i_; }
+
+            friend bool operator!=(Iterator const &a, Iterator const &b) { return a.i_ != b.i_; }
+
+            friend bool operator<(Iterator const &a, Iterator const &b) { return a.i_ < b.i_; }
+
+            friend bool operator>(Iterator const &a, Iterator const &b) { return a.i_ > b.i_; }
+
+            friend bool operator<=(Iterator const &a, Iterator const &b) { return a.i_ <= b.i_; }
+
+            friend bool operator>=(Iterator const &a, Iterator const &b) { return a.i_ >= b.i_; }
+
+           private:
+            Owner *array_{nullptr};
+            difference_type i_{0};
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        KahanArray() = default;
+
+        explicit KahanArray(size_t n) : real_(n, T{0}), err_(n, T{0}) {}
+
+        KahanArray(size_t n, value_type const &value) : real_(n, value.real), err_(n, value.err) {}
+
+        KahanArray(std::initializer_list<value_type> list) {
+            reserve(list.size());
+            for (auto const &k : list) {
+                push_back(k);
+            }
+        }
+
+        [[nodiscard]] inline size_t size() const noexcept { return real_.size(); }
+
+        [[nodiscard]] inline bool empty() const noexcept { return real_.empty(); }
+
+        inline void resize(size_t n) { real_.resize(n, T{0}), err_.resize(n, T{0}); }
+
+        inline void reserve(size_t n) { real_.reserve(n), err_.reserve(n); }
+
+        inline void clear() noexcept { real_.clear(), err_.clear(); }
+
+        inline void assign(size_t n, value_type const &value) { real_.assign(n, value.real), err_.assign(n, value.err); }
+
+        inline void push_back(value_type const &value) { real_.push_back(value.real), err_.push_back(value.err); }
+
+        template <typename... Args>
+        inline reference emplace_back(Args &&... args) {
+            push_back(value_type(std::forward<Args>(args)...));
+            return back();
+        }
+
+        inline reference operator[](size_t i) noexcept { return reference{real_[i], err_[i]}; }
+
+        inline value_type operator[](size_t i) const noexcept {
+            value_type k;
+            k.real = real_[i], k.err = err_[i];
+            return k;
+        }
+
+        inline reference front() noexcept { return (*this)[0]; }
+
+        inline value_type front() const noexcept { return (*this)[0]; }
+
+        inline reference back() noexcept { return (*this)[size() - 1]; }
+
+        inline value_type back() const noexcept { return (*this)[size() - 1]; }
+
+        inline iterator begin() noexcept { return iterator{this, 0}; }
+
+        inline iterator end() noexcept { return iterator{this, static_cast<difference_type>(size())}; }
+
+        inline const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+
+        inline const_iterator end() const noexcept { return const_iterator{this, static_cast<difference_type>(size())}; }
+
+        /**
+         * @brief The stream of the values.
+         */
+        inline T *real_data() noexcept { return real_.data(); }
+
+        inline T const *real_data() const noexcept { return real_.data(); }
+
+        /**
+         * @brief The stream of the compensations.
+         */
+        inline T *err_data() noexcept { return err_.data(); }
+
+        inline T const *err_data() const noexcept { return err_.data(); }
+
+        friend bool operator==(KahanArray const &lhs, KahanArray const &rhs) {
+            return lhs.real_ == rhs.real_ && lhs.err_ == rhs.err_;
+        }
+
+        friend bool operator!=(KahanArray const &lhs, KahanArray const &rhs) { return !(lhs == rhs); }
+
+       private:
+        Stream real_;
+        Stream err_;
+    };
+
+    /**
+     * @brief Container type of the state scalars: `KahanArray` for `Kahan` numbers, `Array` otherwise.
+     */
+    template <typename StateScalar, typename Array>
+    struct state_array {
+        using type = Array;
+    };
+
+    template <typename T, typename Array>
+    struct state_array<Kahan<T>, Array> {
+        using type = KahanArray<T>;
+    };
+
+    template <typename StateScalar, typename Array>
+    using state_array_t = typename state_array<StateScalar, Array>::type;
+
+    /**
+     * @brief Is the type a `KahanArray`?
+     */
+    template <typename Array>
+    struct is_kahan_array : std::false_type {};
+
+    template <typename T>
+    struct is_kahan_array<KahanArray<T>> : std::true_type {};
+
+    template <typename Array>
+    inline constexpr bool is_kahan_array_v = is_kahan_array<std::decay_t<Array>>::value;
+}  // namespace hub
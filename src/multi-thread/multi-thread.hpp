@@ -26,6 +26,7 @@ License
 
 #include <cstdio>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -35,6 +36,7 @@ License
 
 #include "../IO.hpp"
 #include "../dev-tools.hpp"
+#include "../taskflow/taskflow.hpp"
 
 /**
  * @namespace hub::multi_thread
@@ -55,6 +57,55 @@ namespace hub::multi_thread {
     inline const size_t machine_thread_num =
         (std::thread::hardware_concurrency() > 1) ? std::thread::hardware_concurrency() : 1;
 
+    /**
+     * @brief Process wide taskflow executor with `machine_thread_num` workers, shared by the parallel kernels.
+     *
+     * @return tf::Executor& The executor.
+     */
+    inline tf::Executor &default_executor() {
+        static tf::Executor executor{machine_thread_num};
+        return executor;
+    }
+
+    /**
+     * @brief Can `parallel_for_tasks()` called from this thread spread its tasks over several threads?
+     *
+     * @return bool False on a single core machine or inside a worker of the default executor.
+     */
+    inline bool parallel_available() {
+        auto &executor = default_executor();
+        return executor.num_workers() > 1 && executor.this_worker_id() < 0;
+    }
+
+    /**
+     * @brief Run task(0), ..., task(task_num - 1) on the default executor and wait for all of them.
+     *
+     * The first task runs on the calling thread. If the caller is already a worker of the default executor, all
+     * tasks run in order on the calling thread to avoid blocking the pool on nested parallelism.
+     *
+     * @param[in] task_num Number of tasks.
+     * @param[in] task Callable with signature void(size_t).
+     */
+    template <typename Callable>
+    void parallel_for_tasks(size_t task_num, Callable &&task) {
+        auto &executor = default_executor();
+        if (task_num < 2 || !parallel_available()) {
+            for (size_t t = 0; t < task_num; ++t) {
+                task(t);
+            }
+            return;
+        }
+        std::vector<std::future<void>> futures;
+        futures.reserve(task_num - 1);
+        for (size_t t = 1; t < task_num; ++t) {
+            futures.emplace_back(executor.async([&task, t] { task(t); }));
+        }
+        task(0);
+        for (auto &f : futures) {
+            f.get();
+        }
+    }
+
     template <typename Lambda>
     void multi_threads_loop(size_t total_len, size_t thread_num, Lambda &&task) {
         auto len_pth = total_len / thread_num;
@@ -24,20 +24,32 @@ License
  */
 #pragma once
 
+#include <algorithm>
+#include <any>
 #include <array>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "../core-computation.hpp"
 #include "../integrator/symplectic/symplectic-integrator.hpp"
+#include "../multi-thread/multi-thread.hpp"
 #include "../spacehub-concepts.hpp"
 
+namespace hub::ode {
+    /**
+     * @brief Number of threads that integrate the substep columns of a `BulirschStoer` step in parallel. Each thread
+     * integrates its columns on its own copy of the particle system, so the results are the same as with one thread.
+     * The columns are distributed by their substep numbers(longest first to the least loaded thread), so the
+     * speedup is bounded by the longest column. Defaults to 1, or to all hardware threads if `BS_SUBSTEP_PARALLEL` is
+     * defined.
+     */
 #ifdef BS_SUBSTEP_PARALLEL
-#include "../taskflow/taskflow.hpp"
+    inline size_t substep_threads{multi_thread::machine_thread_num};
+#else
+    inline size_t substep_threads{1};
 #endif
 
-namespace hub::ode {
-
     /*---------------------------------------------------------------------------*\
          Class BulirschStoerConsts Declaration
     \*---------------------------------------------------------------------------*/
@@ -65,7 +77,11 @@ namespace hub::ode {
 
         constexpr inline Scalar table_coef(size_t i, size_t j) const { return extrap_coef_[at(i, j)]; };
 
-        constexpr explicit BulirschStoerConsts();
+        /**
+         * @param[in] even_steps Use the substep numbers 2, 4, 6, ... instead of the default sequence. The middle of
+         * the step is then a substep boundary of every column(see `BulirschStoer::set_dense_output`).
+         */
+        constexpr explicit BulirschStoerConsts(bool even_steps = false);
 
        private:
         inline size_t at(size_t i, size_t j) const { return i * MaxIter + j; };
@@ -102,6 +118,12 @@ namespace hub::ode {
 
         static constexpr size_t max_try_num{100};
 
+        /** @brief Number of variables per block of the fused extrapolation and error sweep(see `extrapolate_error`).*/
+        static constexpr size_t extrap_block{256};
+
+        /** @brief Maximum number of terms of the dense output interpolant(see `dense_output`).*/
+        static constexpr size_t dense_terms{2 * max_depth + 7};
+
         BulirschStoer();
 
         template <CONCEPT_PARTICLE_SYSTEM U>
@@ -116,19 +138,75 @@ namespace hub::ode {
 
         Scalar reject_rate() { return static_cast<Scalar>(rej_num_) / static_cast<Scalar>(iter_num_); };
 
+        /**
+         * @brief Keep the data of every accepted step for `dense_output`. Off by default, since it copies the particle
+         * system at every accepted step and switches to the substep sequence 2, 4, 6, ..., which costs more per step
+         * than the default one but puts the middle of the step on a substep boundary of every column.
+         */
+        void set_dense_output(bool on) { consts_ = BSConsts{on}, dense_output_ = on, dense_ready_ = false; };
+
+        /**
+         * @brief Is the dense output of the last accepted step available?
+         */
+        [[nodiscard]] bool dense_output_ready() const { return dense_ready_; };
+
+        /**
+         * @brief Physical time at the start of the last accepted step.
+         */
+        [[nodiscard]] Scalar dense_begin_time() const { return dense_t0_; };
+
+        /**
+         * @brief Physical time at the end of the last accepted step.
+         */
+        [[nodiscard]] Scalar dense_end_time() const { return dense_t1_; };
+
+        /**
+         * @brief Interpolate the state of the last accepted step to a physical time and write it to `particles`.
+         *
+         * The interpolant follows Hairer & Wanner(Solving ODEs I, II.9): a polynomial in the step variable that
+         * matches the state and the derivative at both ends of the step, and the derivatives of order 0 to n_k at the
+         * middle of the step, where n_k is the substep number of the accepted column k. The derivatives at the middle
+         * are central differences of the substep boundaries of each column, extrapolated over all the columns that
+         * resolve them, so the order of the interpolant grows with the order of the step. The derivatives at the ends
+         * are evaluated on the first call for a step(two force evaluations). For regularized systems the step variable
+         * of `time` is found by Newton iteration on the time component.
+         *
+         * @param[out] particles Particle system to write. It is a copy of the system of the step, so the chain index
+         * may differ from the current one.
+         * @param[in] time Physical time, clamped into [dense_begin_time(), dense_end_time()].
+         */
+        template <CONCEPT_PARTICLE_SYSTEM U>
+        void dense_output(U &particles, Scalar time);
+
        private:
         void check_variable_size();
 
         inline size_t at(size_t i, size_t j) const { return consts_.at(i, j); };
 
         template <CONCEPT_PARTICLE_SYSTEM U>
-        void integrate_by_n_steps(U &particles, Scalar macro_step_size, size_t steps);
+        void integrate_by_n_steps(U &particles, Scalar macro_step_size, size_t steps,
+                                  std::vector<ScalarArray> *mid = nullptr);
+
+        template <CONCEPT_PARTICLE_SYSTEM U, typename Columns>
+        void integrate_columns(U const &particles, Columns &columns, Scalar macro_step_size, size_t last,
+                               size_t threads);
 
         void integrate_by_n_steps(std::function<void(StateScalarArray const &, StateScalarArray &, Scalar)> func,
                                   StateScalarArray &data_out, Scalar &time, Scalar step_size, size_t steps);
 
         void extrapolate(size_t k);
 
+        Scalar extrapolate_error(size_t k);
+
+        template <CONCEPT_PARTICLE_SYSTEM U>
+        void save_dense_output(U const &particles, size_t k, Scalar macro_step_size);
+
+        static Scalar central_difference_weight(size_t order, long r);
+
+        void dense_weights(Scalar theta, std::array<Scalar, dense_terms> &w, std::array<Scalar, dense_terms> &dw) const;
+
+        void dense_increment(Scalar theta, ScalarArray &delta);
+
         inline bool in_converged_window(size_t k);
 
         inline size_t allowed(size_t i) const;
@@ -140,6 +218,8 @@ namespace hub::ode {
         Scalar get_next_step_len(size_t k_new, size_t k) const;
 
        private:
+        CREATE_METHOD_CHECK(accumulate_error);
+
         using EvaluateFun = std::function<void(StateScalarArray const &, StateScalarArray &, Scalar)>;
         /** @brief The constant coef for BS extrapolation*/
         BSConsts consts_;
@@ -177,24 +257,54 @@ namespace hub::ode {
 
         bool first_step_{true};
 
-#ifdef BS_SUBSTEP_PARALLEL
-        tf::Executor executor{1};
-#endif
+        /** @brief Derivatives(times the step size) of order 0 to n at the middle of the step of the columns with n
+         * substeps, if `dense_output_`.*/
+        std::array<std::vector<ScalarArray>, max_depth + 1> mid_list_;
+
+        /** @brief Copy of the particle system of the last accepted step.*/
+        std::any dense_system_;
+
+        /** @brief State at the start of the last accepted step.*/
+        StateScalarArray dense_y0_{0};
+
+        /** @brief Coefficients of the interpolant of the last accepted step: the derivatives(times the step size) of
+         * order 0 to `dense_order_` at the middle, then the four terms that match the ends.*/
+        std::array<ScalarArray, dense_terms> dense_data_;
+
+        StateScalarArray dense_state_{0};
+
+        ScalarArray dense_delta_;
+
+        ScalarArray dense_slope_;
+
+        Scalar dense_h_{0};
+
+        Scalar dense_t0_{0};
+
+        Scalar dense_t1_{0};
+
+        size_t dense_order_{0};
+
+        bool dense_output_{false};
+
+        bool dense_ready_{false};
+
+        bool dense_derivs_{false};
     };
 
     /*---------------------------------------------------------------------------*\
          Class BulirschStoerConsts Implementation
     \*---------------------------------------------------------------------------*/
     template <typename Scalar, size_t MaxIter, bool IsKDK>
-    constexpr BulirschStoerConsts<Scalar, MaxIter, IsKDK>::BulirschStoerConsts() {
+    constexpr BulirschStoerConsts<Scalar, MaxIter, IsKDK>::BulirschStoerConsts(bool even_steps) {
         // static_assert(MaxIter <= 11, " Iteration depth cannot be larger than9");
 
         std::array<size_t, 11> seq = {1, 2, 3, 5, 8, 12, 17, 25, 36, 51, 73};  // better sequence
 
         for (size_t i = 0; i < MaxIter; ++i) {
-            // h_[i] = 2 * (i + 1);
-
-            if constexpr (MaxIter <= 11) {
+            if (even_steps) {
+                h_[i] = 2 * (i + 1);
+            } else if constexpr (MaxIter <= 11) {
                 h_[i] = seq[i];
             } else {
                 h_[i] = (i + 1);
@@ -251,9 +361,7 @@ namespace hub::ode {
                 size_t result_order = 2 * k + 1;
                 integrate_by_n_steps(func, extrap_list_[k], time, iter_h, consts_.h(k));
 
-                extrapolate(k);
-
-                Scalar error = err_checker_.error(input_, extrap_list_[1], extrap_list_[0]);
+                Scalar error = extrapolate_error(k);
 
                 ideal_step_size_[k] = iter_h * step_ctrl_.next(result_order, error);
 
@@ -291,44 +399,32 @@ namespace hub::ode {
         auto const &dy = particles.increment();
         particles.collect_increment(true);
 
-#ifdef BS_SUBSTEP_PARALLEL
-        static const auto integrate_with_stride = [&](auto &ptc, size_t start, size_t stride) {
-            auto const &dy = ptc.increment();
-
-            for (int p = start; p >= 0; p -= stride) {
-                ptc.read_from_scalar_array(input_);
-                ptc.clear_increment();
-                integrate_by_n_steps(ptc, iter_h, consts_.h(p));
-                std::copy(dy.begin(), dy.end(), extrap_list_[p].begin());
-            }
-        };
-#endif
+        // Particle systems of the substep columns in the parallel mode.
+        static thread_local std::array<std::unique_ptr<U>, max_depth + 1> columns;
 
         for (size_t i = 0; i < max_try_num; ++i) {
             iter_num_++;
 
-#ifdef BS_SUBSTEP_PARALLEL
-            executor.silent_async(integrate_with_stride, particles, ideal_rank_, 2);
-            integrate_with_stride(particles, ideal_rank_ + 1, 2);
-            executor.wait_for_all();
-#else
-            particles.clear_increment();
-            integrate_by_n_steps(particles, iter_h, consts_.h(0));
-            std::copy(dy.begin(), dy.end(), extrap_list_[0].begin());
-#endif
+            size_t const last = ideal_rank_ + 1;
+            size_t const threads = std::min(substep_threads, last + 1);
+            if (threads > 1) {
+                integrate_columns(particles, columns, iter_h, last, threads);
+            } else {
+                particles.clear_increment();
+                integrate_by_n_steps(particles, iter_h, consts_.h(0), dense_output_ ? &mid_list_[0] : nullptr);
+                std::copy(dy.begin(), dy.end(), extrap_list_[0].begin());
+            }
 
-            for (size_t k = 1; k <= ideal_rank_ + 1; ++k) {
+            size_t k = 1;
+            for (; k <= last; ++k) {
                 size_t result_order = 2 * k + 1;
-#ifdef BS_SUBSTEP_PARALLEL
-
-#else
-                particles.read_from_scalar_array(input_);
-                particles.clear_increment();
-                integrate_by_n_steps(particles, iter_h, consts_.h(k));
-                std::copy(dy.begin(), dy.end(), extrap_list_[k].begin());
-#endif
-                extrapolate(k);  // extrapolate results and save it to extrap_list_[0];
-                Scalar error = err_checker_.error(input_, extrap_list_[1], extrap_list_[0]);
+                if (threads <= 1) {
+                    particles.read_from_scalar_array(input_);
+                    particles.clear_increment();
+                    integrate_by_n_steps(particles, iter_h, consts_.h(k), dense_output_ ? &mid_list_[k] : nullptr);
+                    std::copy(dy.begin(), dy.end(), extrap_list_[k].begin());
+                }
+                Scalar error = extrapolate_error(k);  // extrapolate results and save it to extrap_list_[0];
                 ideal_step_size_[k] = iter_h * step_ctrl_.next(result_order, error);
                 cost_per_len_[k] = consts_.cost(k) / ideal_step_size_[k];
                 // hub::print_csv(std::cout, k, ideal_rank_, error, ideal_step_size_[k], cost_per_len_[k], '\n');
@@ -336,9 +432,18 @@ namespace hub::ode {
                     if (error <= 1.0) {
                         last_error_ = error;
                         step_reject_ = false;
+                        if (threads > 1) {
+                            particles = *columns[k];
+                        }
+                        if (dense_output_) {
+                            dense_y0_ = input_;
+                        }
                         calc::array_advance(input_, extrap_list_[0]);
                         particles.read_from_scalar_array(input_);
                         particles.collect_increment(false);  // turn off the increment collection
+                        if (dense_output_) {
+                            save_dense_output(particles, k, iter_h);
+                        }
 
                         Scalar new_h = set_next_iteration(k);
                         first_step_ = false;
@@ -352,6 +457,10 @@ namespace hub::ode {
                     }
                 }
             }
+            // The serial mode leaves the particle system in the state of the last integrated column.
+            if (threads > 1) {
+                particles = *columns[std::min(k, last)];
+            }
             particles.read_from_scalar_array(input_);
         }
         spacehub_abort("Reach max iteration loop number!");
@@ -381,29 +490,94 @@ namespace hub::ode {
     template <CONCEPT_PARTICLE_SYSTEM U>
     void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::integrate_by_n_steps(U &particles,
                                                                                                 Scalar macro_step_size,
-                                                                                                size_t steps) {
-        size_t num_drift = steps;
-        Scalar h = macro_step_size / num_drift;
-
-        if constexpr (std::is_same_v<Integrator, integrator::LeapFrogDKD<TypeSet>>) {
-            particles.drift(0.5 * h);
-            for (size_t i = 1; i < num_drift; i++) {
+                                                                                                size_t steps,
+                                                                                                std::vector<ScalarArray> *mid) {
+        Scalar h = macro_step_size / steps;
+
+        auto leapfrog = [&](size_t num_drift) {
+            if constexpr (std::is_same_v<Integrator, integrator::LeapFrogDKD<TypeSet>>) {
+                particles.drift(0.5 * h);
+                for (size_t i = 1; i < num_drift; i++) {
+                    particles.kick(h);
+                    particles.drift(h);
+                }
                 particles.kick(h);
+                particles.drift(0.5 * h);
+            } else if constexpr (std::is_same_v<Integrator, integrator::LeapFrogKDK<TypeSet>>) {
+                particles.kick(0.5 * h);
+                for (size_t i = 1; i < num_drift; i++) {
+                    particles.drift(h);
+                    particles.kick(h);
+                }
                 particles.drift(h);
+                particles.kick(0.5 * h);
+            } else {
+                static_assert(true, "Bulirsch-Stoer Undefined embedded integration method");
             }
-            particles.kick(h);
-            particles.drift(0.5 * h);
-        } else if constexpr (std::is_same_v<Integrator, integrator::LeapFrogKDK<TypeSet>>) {
-            particles.kick(0.5 * h);
-            for (size_t i = 1; i < num_drift; i++) {
-                particles.drift(h);
-                particles.kick(h);
+        };
+
+        if (mid != nullptr) {
+            // The states at the substep boundaries of the symmetric leapfrog extrapolate like the end state, and so do
+            // their central differences around the middle of the step(even `steps`). The difference of order p is
+            // accumulated boundary by boundary, scaled by steps^p to the derivative times the macro step size.
+            mid->resize(steps + 1);
+            for (auto &v : *mid) {
+                v.resize(var_num_);
+                calc::array_set_zero(v);
+            }
+            auto const &dy = particles.increment();
+            for (size_t m = 1; m <= steps; ++m) {
+                leapfrog(1);
+                long const r = static_cast<long>(m) - static_cast<long>(steps / 2);
+                Scalar scale{1};
+                for (size_t p = 0; p <= steps; ++p, scale *= static_cast<Scalar>(steps)) {
+                    Scalar const c = central_difference_weight(p, r) * scale;
+                    if (c != 0) {
+                        auto &v = (*mid)[p];
+                        cpu::for_each_index(var_num_, [&](size_t i) { v[i] += c * dy[i]; });
+                    }
+                }
             }
-            particles.drift(h);
-            particles.kick(0.5 * h);
         } else {
-            static_assert(true, "Bulirsch-Stoer Undefined embedded integration method");
+            leapfrog(steps);
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    template <CONCEPT_PARTICLE_SYSTEM U, typename Columns>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::integrate_columns(U const &particles,
+                                                                                             Columns &columns,
+                                                                                             Scalar macro_step_size,
+                                                                                             size_t last,
+                                                                                             size_t threads) {
+        // Longest processing time first: the substep numbers increase with the column, so the columns are handed out
+        // from the last one, each to the thread with the fewest substeps so far.
+        std::array<size_t, max_depth + 1> owner{};
+        std::array<size_t, max_depth + 1> load{};
+        for (size_t c = last + 1; c-- > 0;) {
+            auto const least = std::min_element(load.begin(), load.begin() + threads);
+            owner[c] = static_cast<size_t>(least - load.begin());
+            *least += consts_.h(c);
         }
+
+        multi_thread::parallel_for_tasks(threads, [&](size_t t) {
+            for (size_t c = 0; c <= last; ++c) {
+                if (owner[c] != t) continue;
+                auto &column = columns[c];
+                if (column) {
+                    *column = particles;
+                } else {
+                    column = std::make_unique<U>(particles);
+                }
+                if (c > 0) {
+                    column->read_from_scalar_array(input_);
+                }
+                column->clear_increment();
+                integrate_by_n_steps(*column, macro_step_size, consts_.h(c), dense_output_ ? &mid_list_[c] : nullptr);
+                auto const &dy = column->increment();
+                std::copy(dy.begin(), dy.end(), extrap_list_[c].begin());
+            }
+        });
     }
 
     template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
@@ -432,12 +606,241 @@ namespace hub::ode {
     template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
     void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::extrapolate(size_t k) {
         for (size_t j = k; j > 0; --j) {
-            //#pragma omp parallel for
-            for (size_t i = 0; i < var_num_; ++i) {
-                extrap_list_[j - 1][i] =
-                    extrap_list_[j][i] + (extrap_list_[j][i] - extrap_list_[j - 1][i]) * consts_.table_coef(k, k - j);
+            auto &lo = extrap_list_[j - 1];
+            auto const &hi = extrap_list_[j];
+            Scalar const coef = consts_.table_coef(k, k - j);
+            cpu::for_each_index(var_num_, [&](size_t i) { lo[i] = hi[i] + (hi[i] - lo[i]) * coef; });
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    auto BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::extrapolate_error(size_t k) -> Scalar {
+        if constexpr (HAS_METHOD(ErrEstimator, accumulate_error, Scalar &, StateScalarArray const &,
+                                 ScalarArray const &, ScalarArray const &, size_t, size_t)) {
+            // The whole Neville update of a block is done while the block of every column is in cache, and the
+            // error of the block is accumulated right after, instead of k + 1 sweeps over the full table.
+            std::array<Scalar, max_depth + 1> coef;
+            for (size_t j = k; j > 0; --j) {
+                coef[j] = consts_.table_coef(k, k - j);
             }
+            Scalar acc{0};
+            for (size_t begin = 0; begin < var_num_; begin += extrap_block) {
+                size_t const len = std::min(extrap_block, var_num_ - begin);
+                for (size_t j = k; j > 0; --j) {
+                    auto *lo = extrap_list_[j - 1].data() + begin;
+                    auto const *hi = extrap_list_[j].data() + begin;
+                    Scalar const c = coef[j];
+                    cpu::for_each_index(len, [&](size_t i) { lo[i] = hi[i] + (hi[i] - lo[i]) * c; });
+                }
+                err_checker_.accumulate_error(acc, input_, extrap_list_[1], extrap_list_[0], begin, begin + len);
+            }
+            return err_checker_.finish_error(acc, var_num_);
+        } else {
+            extrapolate(k);
+            return err_checker_.error(input_, extrap_list_[1], extrap_list_[0]);
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    template <CONCEPT_PARTICLE_SYSTEM U>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::save_dense_output(U const &particles,
+                                                                                             size_t k,
+                                                                                             Scalar macro_step_size) {
+        // Aitken-Neville over the columns that resolve each order, the same recursion as `extrapolate` on the
+        // subsequence. Column c resolves the orders up to its substep number.
+        size_t const order = consts_.h(k);
+        size_t first = 0;
+        for (size_t p = 0; p <= order; ++p) {
+            while (consts_.h(first) < p) {
+                ++first;
+            }
+            for (size_t j = 1; j <= k - first; ++j) {
+                for (size_t i = k; i >= first + j; --i) {
+                    Scalar const ni = static_cast<Scalar>(consts_.h(i));
+                    Scalar const nj = static_cast<Scalar>(consts_.h(i - j));
+                    Scalar const coef = nj * nj / (ni * ni - nj * nj);
+                    auto &hi = mid_list_[i][p];
+                    auto const &lo = mid_list_[i - 1][p];
+                    cpu::for_each_index(var_num_, [&](size_t x) { hi[x] = hi[x] + (hi[x] - lo[x]) * coef; });
+                }
+            }
+            std::swap(dense_data_[p], mid_list_[k][p]);
+        }
+        for (size_t j = order + 1; j < order + 5; ++j) {
+            dense_data_[j].resize(var_num_);
+        }
+        std::copy_n(extrap_list_[0].begin(), var_num_, dense_data_[order + 1].begin());
+
+        if (auto *sys = std::any_cast<U>(&dense_system_)) {
+            *sys = particles;
+        } else {
+            dense_system_ = particles;
+        }
+        dense_h_ = macro_step_size;
+        dense_t1_ = static_cast<Scalar>(particles.time());
+        dense_t0_ = static_cast<Scalar>(dense_y0_[particles.time_offset()]);
+        dense_order_ = order;
+        dense_ready_ = true;
+        dense_derivs_ = false;
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    auto BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::central_difference_weight(size_t order,
+                                                                                                     long r)
+        -> Scalar {
+        // Weight of the point r of the central difference of `order` at 0, the mean of the two differences at -1/2
+        // and 1/2 for odd orders.
+        auto binomial = [](long n, long i) {
+            if (i < 0 || i > n) return Scalar{0};
+            Scalar c{1};
+            for (long j = 1; j <= i; ++j) {
+                c = c * static_cast<Scalar>(n - i + j) / static_cast<Scalar>(j);
+            }
+            return c;
+        };
+        auto sign = [](long i) { return i % 2 == 0 ? Scalar{1} : Scalar{-1}; };
+        long const q = static_cast<long>(order / 2);
+        if (order % 2 == 0) {
+            return sign(q - r) * binomial(2 * q, q - r);
+        } else {
+            return 0.5 * (sign(q + 1 - r) * binomial(2 * q + 1, q + 1 - r) + sign(q - r) * binomial(2 * q + 1, q - r));
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::dense_weights(
+        Scalar theta, std::array<Scalar, dense_terms> &w, std::array<Scalar, dense_terms> &dw) const {
+        // Taylor terms s^p/p! around the middle, s = theta - 1/2, then the terms sigma^(n + 1 + j), j = 0..3, with
+        // sigma = 2s, which vanish to order n at the middle and match the ends.
+        size_t const n = dense_order_;
+        Scalar const s = theta - 0.5;
+        w[0] = 1;
+        dw[0] = 0;
+        for (size_t p = 1; p <= n; ++p) {
+            dw[p] = w[p - 1];
+            w[p] = w[p - 1] * s / static_cast<Scalar>(p);
+        }
+        Scalar const sigma = 2 * s;
+        Scalar pow{1};
+        for (size_t p = 0; p < n; ++p) {
+            pow *= sigma;
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            dw[n + 1 + j] = 2 * static_cast<Scalar>(n + 1 + j) * pow;
+            pow *= sigma;
+            w[n + 1 + j] = pow;
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::dense_increment(Scalar theta,
+                                                                                           ScalarArray &delta) {
+        std::array<Scalar, dense_terms> w;
+        std::array<Scalar, dense_terms> dw;
+        dense_weights(theta, w, dw);
+        auto const &d = dense_data_;
+        size_t const terms = dense_order_ + 5;
+        delta.resize(var_num_);
+        cpu::for_each_index(var_num_, [&](size_t i) {
+            Scalar sum{0};
+            for (size_t j = 0; j < terms; ++j) {
+                sum += w[j] * d[j][i];
+            }
+            delta[i] = sum;
+        });
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
+    template <CONCEPT_PARTICLE_SYSTEM U>
+    void BulirschStoer<Integrator, ErrEstimator, StepController, MaxIter>::dense_output(U &particles, Scalar time) {
+        if (!dense_ready_) {
+            spacehub_abort("No dense output available, call 'set_dense_output(true)' before the integration!");
+        }
+        auto *sys = std::any_cast<U>(&dense_system_);
+        if (sys == nullptr) {
+            spacehub_abort("The dense output was saved for a different particle system type!");
+        }
+        auto &d = dense_data_;
+        size_t const n = dense_order_;
+        size_t const terms = n + 5;
+
+        if (!dense_derivs_) {
+            auto eval_derivative = [&](ScalarArray const *inc, ScalarArray &f) {
+                dense_state_ = dense_y0_;
+                if (inc != nullptr) {
+                    calc::array_advance(dense_state_, *inc);
+                }
+                sys->read_from_scalar_array(dense_state_);
+                sys->evaluate_general_derivative(f);
+                calc::array_scale(f, f, dense_h_);
+            };
+            // d[n + 1] holds the increment to the end.
+            eval_derivative(nullptr, d[n + 2]);
+            eval_derivative(&d[n + 1], d[n + 3]);
+
+            // Taylor part T and its slope at s = -1/2 and 1/2.
+            std::array<Scalar, dense_terms> w0, dw0, w1, dw1;
+            dense_weights(0, w0, dw0);
+            dense_weights(1, w1, dw1);
+            cpu::for_each_index(var_num_, [&](size_t i) {
+                Scalar t0{0}, t1{0}, dt0{0}, dt1{0};
+                for (size_t p = 0; p <= n; ++p) {
+                    t0 += w0[p] * d[p][i];
+                    t1 += w1[p] * d[p][i];
+                    dt0 += dw0[p] * d[p][i];
+                    dt1 += dw1[p] * d[p][i];
+                }
+                // Residuals of the values and the slopes(in sigma) at the ends, split into even and odd parts. The
+                // terms sigma^(n+1) and sigma^(n+3) are odd(n even), sigma^(n+2) and sigma^(n+4) even.
+                Scalar const r0 = -t0;
+                Scalar const r1 = d[n + 1][i] - t1;
+                Scalar const s0 = 0.5 * (d[n + 2][i] - dt0);
+                Scalar const s1 = 0.5 * (d[n + 3][i] - dt1);
+                Scalar const even = 0.5 * (r1 + r0);
+                Scalar const odd = 0.5 * (r1 - r0);
+                Scalar const slope_even = 0.5 * (s1 + s0);
+                Scalar const slope_odd = 0.5 * (s1 - s0);
+                auto const p = static_cast<Scalar>(n + 1);
+                Scalar const b2 = (slope_even - p * odd) / 2;
+                Scalar const b3 = (slope_odd - (p + 1) * even) / 2;
+                d[n + 1][i] = odd - b2;
+                d[n + 2][i] = even - b3;
+                d[n + 3][i] = b2;
+                d[n + 4][i] = b3;
+            });
+            dense_derivs_ = true;
+        }
+
+        using std::abs;
+        size_t const t_idx = sys->time_offset();
+        std::array<Scalar, dense_terms> w;
+        std::array<Scalar, dense_terms> dw;
+        Scalar const span = dense_t1_ - dense_t0_;
+        Scalar theta = span != 0 ? (time - dense_t0_) / span : Scalar{1};
+        theta = math::in_range(Scalar{0}, theta, Scalar{1});
+        // Newton iteration on the time component; the time is linear in the step variable without regularization.
+        for (size_t iter = 0; iter < 50; ++iter) {
+            dense_weights(theta, w, dw);
+            Scalar t = dense_t0_;
+            Scalar dt = 0;
+            for (size_t j = 0; j < terms; ++j) {
+                t += w[j] * d[j][t_idx];
+                dt += dw[j] * d[j][t_idx];
+            }
+            if (dt == 0) break;
+            Scalar step = (time - t) / dt;
+            theta = math::in_range(Scalar{0}, theta + step, Scalar{1});
+            if (abs(step) <= 4 * math::epsilon_v<Scalar>) break;
+        }
+
+        dense_increment(theta, dense_delta_);
+        dense_state_ = dense_y0_;
+        calc::array_advance(dense_state_, dense_delta_);
+        sys->read_from_scalar_array(dense_state_);
+        if (theta > 0 && theta < 1) {
+            sys->time() = time;
         }
+        particles = *sys;
     }
 
     template <typename Integrator, typename ErrEstimator, typename StepController, size_t MaxIter>
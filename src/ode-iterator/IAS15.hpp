@@ -24,7 +24,11 @@ License
  */
 #pragma once
 
+#include <any>
+#include <vector>
+
 #include "../dev-tools.hpp"
+#include "../double-double.hpp"
 #include "../integrator/Gauss-Radau.hpp"
 #include "../math.hpp"
 
@@ -36,6 +40,9 @@ namespace hub::ode {
     /**
      * @brief IAS15 iterator see details in https://arxiv.org/abs/1409.4779 .
      *
+     * Works with `GaussRadau`, which expands the derivatives of the whole state, and with `GaussRadau2nd`, which
+     * expands the accelerations only as the original IAS15 does.
+     *
      * @tparam Integrator
      * @tparam ErrEstimator
      * @tparam StepController
@@ -44,7 +51,8 @@ namespace hub::ode {
     class IAS15 {
        public:
         SPACEHUB_USING_TYPE_SYSTEM_OF(Integrator);
-        static_assert(std::is_same_v<Integrator, integrator::GaussRadau<TypeSet>>,
+        static_assert(std::is_same_v<Integrator, integrator::GaussRadau<TypeSet>> ||
+                          std::is_same_v<Integrator, integrator::GaussRadau2nd<TypeSet>>,
                       "IAS15 iterator only works with Gauss-Radau integrator!");
 
         IAS15();
@@ -52,6 +60,62 @@ namespace hub::ode {
         template <typename U>
         Scalar iterate(U& particles, Scalar macro_step_size);
 
+        /**
+         * @brief Keep the B table and the particle system of every accepted step for `interpolate` and
+         * `dense_output`. Off by default, since it copies both at every accepted step. It takes no extra force
+         * evaluation.
+         */
+        void set_dense_output(bool on) { dense_output_ = on, dense_ready_ = false; };
+
+        /**
+         * @brief Is the dense output of the last accepted step available?
+         */
+        [[nodiscard]] bool dense_output_ready() const { return dense_ready_; };
+
+        /**
+         * @brief Physical time at the start of the last accepted step.
+         */
+        [[nodiscard]] Scalar dense_begin_time() const { return dense_t0_; };
+
+        /**
+         * @brief Physical time at the end of the last accepted step.
+         */
+        [[nodiscard]] Scalar dense_end_time() const { return dense_t1_; };
+
+        /**
+         * @brief Evaluate the polynomial of the B table of the last accepted step at a fraction of the step and
+         * write the state to `particles`.
+         *
+         * @param[out] particles Particle system to write. It is a copy of the system of the step, so the chain index
+         * may differ from the current one.
+         * @param[in] fraction Fraction of the step variable, clamped into [0, 1].
+         */
+        template <typename U>
+        void interpolate(U& particles, Scalar fraction);
+
+        /**
+         * @brief Interpolate the state of the last accepted step to a physical time and write it to `particles`. For
+         * regularized systems the fraction of `time` is found by Newton iteration on the time component of the
+         * polynomial.
+         *
+         * @param[out] particles Particle system to write.
+         * @param[in] time Physical time, clamped into [dense_begin_time(), dense_end_time()].
+         */
+        template <typename U>
+        void dense_output(U& particles, Scalar time);
+
+        /**
+         * @brief Permute the predicted B table after the particle system reordered its storage, so the prediction
+         * of the next step stays with its particles(see `system::SimpleSystem::reorder_delta`).
+         *
+         * @param[in] particles Particle system in the new order.
+         * @param[in] order Particle k is particle order[k] of the last step.
+         */
+        template <typename U>
+        void permute(U const& particles, std::vector<size_t> const& order) {
+            integrator_.permute(particles, order);
+        };
+
        private:
         inline void reset_PC_iteration();
 
@@ -65,8 +129,19 @@ namespace hub::ode {
         ErrEstimator PC_err_checker_;
         Scalar last_PC_error_{math::max_value<Scalar>::value};
         static constexpr size_t max_iter_{30};
+        // Tolerances of the predictor-corrector convergence and of the step error, tightened for `dd_real`.
+        static constexpr bool double_double_{std::is_same_v<Scalar, dd_real>};
+        static constexpr double PC_rtol_{double_double_ ? 1e-28 : 1e-16};
+        static constexpr double step_rtol_{double_double_ ? 1e-16 : 5e-10};
         bool warmed_up{false};
 
+        /** @brief Copy of the particle system of the last accepted step.*/
+        std::any dense_system_;
+        Scalar dense_t0_{0};
+        Scalar dense_t1_{0};
+        bool dense_output_{false};
+        bool dense_ready_{false};
+
         CREATE_STATIC_MEMBER_CHECK(regu_type);
         CREATE_METHOD_CHECK(chain_pos);
         CREATE_METHOD_CHECK(chain_vel);
@@ -78,7 +153,7 @@ namespace hub::ode {
     template <typename Integrator, typename ErrEstimator, typename StepController>
     IAS15<Integrator, ErrEstimator, StepController>::IAS15() {
         PC_err_checker_.set_atol(0);
-        PC_err_checker_.set_rtol(1e-16);
+        PC_err_checker_.set_rtol(PC_rtol_);
         step_ctrl_.set_safe_guards(0.85, 1.0);
         step_ctrl_.set_limiter(0.02, 4.0);
     }
@@ -95,6 +170,17 @@ namespace hub::ode {
                 // print_csv(std::cout, k, error, iter_h, '\n');
                 if (new_step_ratio > step_ctrl_.limiter_min()) {
                     integrator_.evaluate(particles, iter_h);
+                    if (dense_output_) {
+                        integrator_.save_step(iter_h);
+                        if (auto* sys = std::any_cast<U>(&dense_system_)) {
+                            *sys = particles;
+                        } else {
+                            dense_system_ = particles;
+                        }
+                        dense_t0_ = static_cast<Scalar>(integrator_.saved_y0()[particles.time_offset()]);
+                        dense_t1_ = static_cast<Scalar>(particles.time());
+                        dense_ready_ = true;
+                    }
                     new_step_ratio = step_ctrl_.limiter(new_step_ratio);
                     integrator_.predict(new_step_ratio);
                     warmed_up = true;
@@ -114,6 +200,53 @@ namespace hub::ode {
         spacehub_abort("Exceed the max iteration number");
     }
 
+    template <typename Integrator, typename ErrEstimator, typename StepController>
+    template <typename U>
+    void IAS15<Integrator, ErrEstimator, StepController>::interpolate(U& particles, Scalar fraction) {
+        if (!dense_ready_) {
+            spacehub_abort("No dense output available, call 'set_dense_output(true)' before the integration!");
+        }
+        auto* sys = std::any_cast<U>(&dense_system_);
+        if (sys == nullptr) {
+            spacehub_abort("The dense output was saved for a different particle system type!");
+        }
+        fraction = math::in_range(Scalar{0}, fraction, Scalar{1});
+        particles = *sys;
+        if (fraction < 1) {
+            integrator_.interpolate(particles, fraction);
+        }
+    }
+
+    template <typename Integrator, typename ErrEstimator, typename StepController>
+    template <typename U>
+    void IAS15<Integrator, ErrEstimator, StepController>::dense_output(U& particles, Scalar time) {
+        if (!dense_ready_) {
+            spacehub_abort("No dense output available, call 'set_dense_output(true)' before the integration!");
+        }
+        auto* sys = std::any_cast<U>(&dense_system_);
+        if (sys == nullptr) {
+            spacehub_abort("The dense output was saved for a different particle system type!");
+        }
+        using std::abs;
+        size_t const t_idx = sys->time_offset();
+        Scalar const span = dense_t1_ - dense_t0_;
+        Scalar theta = span != 0 ? (time - dense_t0_) / span : Scalar{1};
+        theta = math::in_range(Scalar{0}, theta, Scalar{1});
+        // Newton iteration on the time component; the time is linear in the step variable without regularization.
+        for (size_t iter = 0; iter < 50 && theta > 0 && theta < 1; ++iter) {
+            Scalar dt = 0;
+            Scalar t = static_cast<Scalar>(integrator_.interpolate_component(t_idx, theta, dt));
+            if (dt == 0) break;
+            Scalar step = (time - t) / dt;
+            theta = math::in_range(Scalar{0}, theta + step, Scalar{1});
+            if (abs(step) <= 4 * math::epsilon_v<Scalar>) break;
+        }
+        interpolate(particles, theta);
+        if (theta > 0 && theta < 1) {
+            particles.time() = time;
+        }
+    }
+
     template <typename Integrator, typename ErrEstimator, typename StepController>
     void IAS15<Integrator, ErrEstimator, StepController>::reset_PC_iteration() {
         last_PC_error_ = math::max_value<Scalar>::value;
@@ -136,7 +269,6 @@ namespace hub::ode {
     auto IAS15<Integrator, ErrEstimator, StepController>::calc_step_error(Array1 const& dy_h, Array2 const& b6,
                                                                           U const& ptc, Scalar step_size) const
         -> Scalar {
-        static Scalar step_rtol_{5e-10};
         Scalar max_diff = 0;
         Scalar max_scale = 0;
         size_t size = dy_h.size();
@@ -149,7 +281,7 @@ namespace hub::ode {
         Scalar dt2 = dt * dt;
         std::vector<bool> mask(size, false);
 
-        if constexpr (!HAS_STATIC_MEMBER(U, regu_type)) {
+        if constexpr (!HAS_STATIC_MEMBER(U, regu_type) && !Integrator::second_order) {
             mask[0] = true;
         }
 
@@ -160,7 +292,12 @@ namespace hub::ode {
             } else {
                 slow_varing = norm2(ptc.pos(i)) * 1e-12 > norm2(ptc.vel(i)) * dt2;
             }
-            if (slow_varing) {
+            if constexpr (Integrator::second_order) {
+                // The B table of the second order form only holds the accelerations.
+                if (slow_varing) {
+                    mask[3 * i] = mask[3 * i + 1] = mask[3 * i + 2] = true;
+                }
+            } else if (slow_varing) {
                 mask[pos_offset + 3 * i] = mask[pos_offset + 3 * i + 1] = mask[pos_offset + 3 * i + 2] = true;
                 mask[vel_offset + 3 * i] = mask[vel_offset + 3 * i + 1] = mask[vel_offset + 3 * i + 2] = true;
                 if constexpr (U::ext_vel_dep) {
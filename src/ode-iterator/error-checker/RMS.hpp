@@ -56,6 +56,16 @@ namespace hub::ode {
         template <typename Array1, typename Array2, typename Array3>
         Scalar error(Array1 const &y0, Array2 const &y1, Array3 const &y1_prime);
 
+        /**
+         * @brief Accumulate the squared errors of the elements [begin, end) into `acc`(starting from 0). Accumulating
+         * the blocks in order and calling `finish_error` gives `error(y0, y1, y1_prime)` bit for bit.
+         */
+        template <typename Array1, typename Array2, typename Array3>
+        void accumulate_error(Scalar &acc, Array1 const &y0, Array2 const &y1, Array3 const &y1_prime, size_t begin,
+                              size_t end) const;
+
+        Scalar finish_error(Scalar acc, size_t size) const;
+
        private:
         Scalar atol_{1e-13};
 
@@ -77,11 +87,18 @@ namespace hub::ode {
     template <typename TypeSystem>
     template <typename Array1, typename Array2, typename Array3>
     auto RMS<TypeSystem>::error(const Array1 &y0, const Array2 &y1, const Array3 &y1_prime) -> Scalar {
-        size_t const size = y0.size();
         Scalar error = 0;
+        accumulate_error(error, y0, y1, y1_prime, 0, y0.size());
+        return finish_error(error, y0.size());
+    }
 
+    template <typename TypeSystem>
+    template <typename Array1, typename Array2, typename Array3>
+    void RMS<TypeSystem>::accumulate_error(Scalar &acc, const Array1 &y0, const Array2 &y1, const Array3 &y1_prime,
+                                           size_t begin, size_t end) const {
+        Scalar error = acc;
         if constexpr (std::is_same_v<raw_type_t<typename Array1::value_type>, raw_type_t<Scalar>>) {
-            for (size_t i = 0; i < size; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 Scalar scale = std::max(fabs(y0[i]), fabs(y1[i])) * rtol_ + atol_;
                 if (scale == 0) {
                     continue;
@@ -90,7 +107,7 @@ namespace hub::ode {
                 error += r * r;
             }
         } else if constexpr (std::is_same_v<typename Array1::value_type, Vec3<Scalar>>) {
-            for (size_t i = 0; i < size; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 auto scale = vec_max(vec_abs(y0[i]), vec_abs(y1[i])) * rtol_ + atol_;
                 if (scale == 0) {
                     continue;
@@ -105,7 +122,12 @@ namespace hub::ode {
         } else {
             spacehub_abort("Unsupported array type!");
         }
-        return sqrt(error / size);
+        acc = error;
+    }
+
+    template <typename TypeSystem>
+    auto RMS<TypeSystem>::finish_error(Scalar acc, size_t size) const -> Scalar {
+        return sqrt(acc / size);
     }
 
     template <typename TypeSystem>
@@ -57,6 +57,16 @@ namespace hub::ode {
         template <typename Array1, typename Array2>
         Scalar error(Array1 const &y0, Array2 const &diff);
 
+        /**
+         * @brief Accumulate the error of the elements [begin, end) into `acc`(starting from 0). `error(y0, y1,
+         * y1_prime)` equals `finish_error` of the accumulation over all elements, in any blocking.
+         */
+        template <typename Array1, typename Array2, typename Array3>
+        void accumulate_error(Scalar &acc, Array1 const &y0, Array2 const &y1, Array3 const &y1_prime, size_t begin,
+                              size_t end) const;
+
+        Scalar finish_error(Scalar acc, size_t size) const;
+
        private:
         Scalar atol_{1e-13};
 
@@ -80,16 +90,24 @@ namespace hub::ode {
     template <typename TypeSystem>
     template <typename Array1, typename Array2, typename Array3>
     auto WorstOffender<TypeSystem>::error(const Array1 &y0, const Array2 &y1, const Array3 &y1_prime) -> Scalar {
-        size_t const size = y0.size();
         Scalar max_err = 0;
+        accumulate_error(max_err, y0, y1, y1_prime, 0, y0.size());
+        return finish_error(max_err, y0.size());
+    }
+
+    template <typename TypeSystem>
+    template <typename Array1, typename Array2, typename Array3>
+    void WorstOffender<TypeSystem>::accumulate_error(Scalar &acc, const Array1 &y0, const Array2 &y1,
+                                                     const Array3 &y1_prime, size_t begin, size_t end) const {
+        Scalar max_err = acc;
         if constexpr (std::is_same_v<raw_type_t<typename Array1::value_type>, raw_type_t<Scalar>>) {
-            for (size_t i = 0; i < size; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 Scalar scale = std::max(fabs(y1[i]), fabs(y0[i]));
                 // Scalar scale = fabs(y0[i]) + fabs((y1[i] - y0[i]));
                 max_err = math::max(max_err, fabs(y1_prime[i] - y1[i]) / (atol_ + scale * rtol_));
             }
         } else if constexpr (std::is_same_v<typename Array1::value_type, Vec3<Scalar>>) {
-            for (size_t i = 0; i < size; ++i) {
+            for (size_t i = begin; i < end; ++i) {
                 Scalar scale = std::max(max_abs(y1[i]), max_abs(y0[i]));
                 // Scalar scale = fabs(y0[i]) + fabs((y1[i] - y0[i]));
                 max_err = math::max(max_err, max_abs(y1_prime[i] - y1[i]) / (atol_ + scale * rtol_));
@@ -97,7 +115,12 @@ namespace hub::ode {
         } else {
             spacehub_abort("Unsupported array type!");
         }
-        return max_err;
+        acc = max_err;
+    }
+
+    template <typename TypeSystem>
+    auto WorstOffender<TypeSystem>::finish_error(Scalar acc, size_t) const -> Scalar {
+        return acc;
     }
 
     template <typename TypeSystem>
@@ -24,6 +24,8 @@ License
  */
 #pragma once
 
+#include <utility>
+
 #include "../type-class.hpp"
 #include "chain.hpp"
 #include "regu-system.hpp"
@@ -76,6 +78,46 @@ namespace hub::system {
 
         Scalar step_scale() const { return regu_.regu_function(*this); };
 
+        /**
+         * @brief Is the potential energy evaluated as a by-product of the last force pass still valid, i.e. the
+         * positions have not been advanced since?
+         */
+        [[nodiscard]] bool potential_cached() const { return accels_.potential_valid(); };
+
+        /**
+         * @brief Potential energy evaluated as a by-product of the last force pass (see `potential_cached()`).
+         */
+        [[nodiscard]] Scalar cached_potential() const { return accels_.potential(); };
+
+        /**
+         * @brief Compact pair list rebuilt every step(see `force::CompactPairs`).
+         */
+        SPACEHUB_READ_ACCESSOR(force::CompactPairs, compact_pairs, accels_.compact_pairs());
+
+        /**
+         * @brief Writable positions and masses. Taking them clears the cached potential energy(see
+         * `potential_cached()`).
+         */
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, StateVectorArray, pos, accels_.potential_valid() = false);
+
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, ScalarArray, mass, accels_.potential_valid() = false);
+
+        /**
+         * @brief Key of the current storage layout(see `force::LayoutKey`).
+         */
+        [[nodiscard]] size_t layout_key() const { return accels_.layout_key().id(); };
+
+        /**
+         * @brief Relative tolerance of the run passed to the forces(see `force::InteractionData::rtol`).
+         */
+        SPACEHUB_STD_ACCESSOR(double, force_rtol, accels_.rtol());
+
+        /**
+         * @brief Chain ordered SoA copy of the positions, velocities and masses for the far pair loops(see
+         * `ChainOrdered`).
+         */
+        SPACEHUB_READ_ACCESSOR(ChainOrdered<Scalar>, chain_ordered, ordered_);
+
         template <typename GenVectorArray>
         void evaluate_acc(GenVectorArray &acceleration) const;
 
@@ -173,6 +215,8 @@ namespace hub::system {
 
         IdxArray new_index_;
 
+        ChainOrdered<Scalar> ordered_;
+
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
 
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> chain_aux_vel_;
@@ -202,6 +246,7 @@ namespace hub::system {
         Chain::calc_chain_index(this->pos(), index_);
         Chain::calc_chain(this->pos(), chain_pos(), index());
         Chain::calc_chain(this->vel(), chain_vel(), index());
+        ordered_.update(*this, index_);
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
             chain_aux_vel_ = chain_vel_;
@@ -220,6 +265,8 @@ namespace hub::system {
     void ARchainSystem<Particles, Interactions, RegType>::drift(Scalar step_size) {
         Scalar phy_time = regu_.eval_pos_phy_time(*this, step_size);
         chain_advance(this->pos(), chain_pos(), chain_vel(), phy_time);
+        ordered_.update_pos(this->pos(), index_);
+        accels_.potential_valid() = false;
         this->time() += phy_time;
         sync_time_increment(phy_time);
         sync_pos_increment(chain_vel(), phy_time);
@@ -227,11 +274,11 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::kick(Scalar step_size) {
+        eval_vel_indep_acc();
+
         Scalar phy_time = regu_.eval_vel_phy_time(*this, step_size);
         Scalar half_time = 0.5 * phy_time;
 
-        eval_vel_indep_acc();
-
         if constexpr (Interactions::ext_vel_dep) {
             kick_real_vel(half_time);
             kick_pseu_vel(phy_time);
@@ -244,6 +291,7 @@ namespace hub::system {
                 advance_bindE(this->vel(), accels_.ext_vel_indep_acc(), half_time);
             }
             chain_advance(this->vel(), chain_vel(), chain_acc_, phy_time);
+            ordered_.update_vel(this->vel(), index_);
             sync_vel_increment(chain_acc_, phy_time);
             if constexpr (Interactions::ext_vel_indep) {
                 advance_bindE(this->vel(), accels_.ext_vel_indep_acc(), half_time);
@@ -254,6 +302,11 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::pre_iter_process() {
+        // masses (and coordinates) may have been changed through the public accessors since the last step
+        ordered_.update(*this, index_);
+        if constexpr (Interactions::compact_pairs) {
+            accels_.compact_pairs().rebuild(*this);
+        }
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
             chain_aux_vel_ = chain_vel_;
@@ -262,13 +315,15 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::post_iter_process() {
-        Chain::calc_chain_index(this->pos(), new_index_);
-        if (new_index_ != index_) {
+        new_index_ = index_;
+        if (Chain::update_chain_index(std::as_const(*this).pos(), new_index_)) {
             Chain::update_chain(chain_pos_, this->pos(), index_, new_index_);
-            Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), new_index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_pos_, this->pos(), new_index_);
             Chain::update_chain(chain_vel_, this->vel(), index_, new_index_);
-            Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), new_index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_vel_, this->vel(), new_index_);
             index_ = new_index_;
+            ordered_.update(*this, index_);
+            accels_.potential_valid() = false;
         }
     }
 
@@ -296,12 +351,12 @@ namespace hub::system {
         dy_dh.clear();
         dy_dh.reserve(this->variable_number());
 
+        accels_.eval_newtonian_acc(*this, accels_.newtonian_acc());
+
         Scalar pos_regu = regu_.eval_pos_phy_time(*this, 1);
         Scalar vel_regu = regu_.eval_vel_phy_time(*this, 1);
 
         dy_dh.emplace_back(pos_regu);
-
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
         if constexpr (Interactions::ext_vel_indep || Interactions::ext_vel_dep) {
             Interactions::eval_extra_acc(*this, accels_.acc());
             calc::array_add(accels_.acc(), accels_.acc(), accels_.newtonian_acc());
@@ -383,14 +438,17 @@ namespace hub::system {
             load_to_coords(pos_begin, pos_end, chain_pos_);
             load_to_coords(vel_begin, vel_end, chain_vel_);
 
-            Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), index());
-            Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), index());
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_pos_, this->pos(), index());
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_vel_, this->vel(), index());
+            ordered_.update_pos(this->pos(), index_);
+            ordered_.update_vel(this->vel(), index_);
+            accels_.potential_valid() = false;
 
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
                 load_to_coords(aux_vel_begin, aux_vel_end, chain_aux_vel_);
-                Chain::calc_cartesian(this->mass(), chain_aux_vel_, aux_vel_, index_);
+                Chain::calc_cartesian(std::as_const(*this).mass(), chain_aux_vel_, aux_vel_, index_);
             }
 
             omega() = *(begin + omega_offset());
@@ -423,12 +481,12 @@ namespace hub::system {
                                                                         Array3 const &chain_increment,
                                                                         Scalar phy_time) {
         calc::array_advance(chain_var, chain_increment, phy_time);
-        Chain::calc_cartesian(this->mass(), chain_var, var, index());
+        Chain::calc_cartesian(std::as_const(*this).mass(), chain_var, var, index());
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void ARchainSystem<Particles, Interactions, RegType>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        accels_.eval_newtonian_acc(*this, accels_.newtonian_acc());
 
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
@@ -442,7 +500,7 @@ namespace hub::system {
     auto ARchainSystem<Particles, Interactions, RegType>::calc_domega_dt(StateVectorArray const &velocity,
                                                                          VectorArray const &d_omega_dr) -> Scalar {
         if constexpr (regu_type == ReguType::TTL) {
-            return calc::coord_contract_to_scalar(this->mass(), velocity, d_omega_dr);
+            return calc::coord_contract_to_scalar(std::as_const(*this).mass(), velocity, d_omega_dr);
         } else {
             return 0;
         }
@@ -452,7 +510,7 @@ namespace hub::system {
     auto ARchainSystem<Particles, Interactions, RegType>::calc_dbindE_dt(StateVectorArray const &velocity,
                                                                          VectorArray const &d_bindE_dr) -> Scalar {
         if constexpr ((Interactions::ext_vel_indep || Interactions::ext_vel_dep) && regu_type == ReguType::LogH) {
-            return -calc::coord_contract_to_scalar(this->mass(), velocity, d_bindE_dr);
+            return -calc::coord_contract_to_scalar(std::as_const(*this).mass(), velocity, d_bindE_dr);
         } else {
             return 0;
         }
@@ -497,6 +555,7 @@ namespace hub::system {
     void ARchainSystem<Particles, Interactions, RegType>::kick_real_vel(Scalar phy_time) {
         std::swap(aux_vel_, this->vel());
         std::swap(chain_aux_vel_, chain_vel());
+        ordered_.update_vel(this->vel(), index_);
         Interactions::eval_extra_vel_dep_acc(*this, accels_.ext_vel_dep_acc());
         std::swap(aux_vel_, this->vel());
         std::swap(chain_aux_vel_, chain_vel());
@@ -504,6 +563,7 @@ namespace hub::system {
 
         Chain::calc_chain(accels_.acc(), chain_acc_, index());
         chain_advance(this->vel(), chain_vel(), chain_acc_, phy_time);
+        ordered_.update_vel(this->vel(), index_);
         sync_vel_increment(chain_acc_, phy_time);
     }
 }  // namespace hub::system
@@ -25,9 +25,11 @@ License
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include "../core-computation.hpp"
 #include "../interaction/interaction.hpp"
+#include "../particles/space-filling-curve.hpp"
 #include "../spacehub-concepts.hpp"
 #include "../type-class.hpp"
 namespace hub::system {
@@ -61,6 +63,40 @@ namespace hub::system {
 
         Scalar step_scale() const { return 1.0; };
 
+        /**
+         * @brief Is the potential energy evaluated as a by-product of the last force pass still valid, i.e. the
+         * positions have not been advanced since?
+         */
+        [[nodiscard]] bool potential_cached() const { return accels_.potential_valid(); };
+
+        /**
+         * @brief Potential energy evaluated as a by-product of the last force pass (see `potential_cached()`).
+         */
+        [[nodiscard]] Scalar cached_potential() const { return accels_.potential(); };
+
+        /**
+         * @brief Compact pair list rebuilt every step(see `force::CompactPairs`).
+         */
+        SPACEHUB_READ_ACCESSOR(force::CompactPairs, compact_pairs, accels_.compact_pairs());
+
+        /**
+         * @brief Writable positions and masses. Taking them clears the cached potential energy(see
+         * `potential_cached()`).
+         */
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, StateVectorArray, pos, accels_.potential_valid() = false);
+
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, ScalarArray, mass, accels_.potential_valid() = false);
+
+        /**
+         * @brief Key of the current storage layout(see `force::LayoutKey`).
+         */
+        [[nodiscard]] size_t layout_key() const { return accels_.layout_key().id(); };
+
+        /**
+         * @brief Relative tolerance of the run passed to the forces(see `force::InteractionData::rtol`).
+         */
+        SPACEHUB_STD_ACCESSOR(double, force_rtol, accels_.rtol());
+
         /**
          *
          * @tparam STL
@@ -91,11 +127,25 @@ namespace hub::system {
         void kick(Scalar step_size);
 
         /**
-         *
+         * @brief Rebuild the per step data and move the particles into the order along
+         * `particles::SpaceFillingOrder::curve` for the step. The order is recomputed every
+         * `particles::SpaceFillingOrder::interval` steps.
          */
         void pre_iter_process();
 
-        void post_iter_process(){};
+        /**
+         * @brief Move the particles back into the order they were given in, so that particle i is the same particle
+         * between the steps whatever the curve order of the step was.
+         */
+        void post_iter_process();
+
+        /**
+         * @brief Permutation of the storage of the step relative to the storage of the previous step, empty if the
+         * order did not change in the last `pre_iter_process()`. Particle k of the step was particle
+         * `reorder_delta()[k]` of the previous step. Iterators that carry per variable state over steps(e.g. the
+         * predicted B tables of `ode::IAS15`) permute it with this.
+         */
+        SPACEHUB_READ_ACCESSOR(std::vector<size_t>, reorder_delta, reorder_delta_);
 
         /**
          * @brief
@@ -169,6 +219,14 @@ namespace hub::system {
 
         void sync_time_increment(Scalar phy_time);
 
+        void enter_curve_order();
+
+        void leave_curve_order();
+
+        CREATE_METHOD_CHECK(reorder);
+
+        constexpr static bool reorderable{HAS_METHOD(Particles, reorder, std::vector<size_t> const &)};
+
         // Private members
 
         force::InteractionData<Interactions, VectorArray> accels_;
@@ -178,6 +236,18 @@ namespace hub::system {
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
 
         bool sync_increment_{false};
+
+        size_t step_count_{0};
+
+        /** @brief Particle k of the step is particle curve_order_[k] of the given order. Empty if not reordered.*/
+        std::vector<size_t> curve_order_;
+
+        std::vector<size_t> curve_inverse_;
+
+        std::vector<size_t> reorder_delta_;
+
+        /** @brief Key of the storage layout that is not the current one(see `force::LayoutKey`).*/
+        force::LayoutKey curve_key_;
     };
 }  // namespace hub::system
 
@@ -208,6 +278,7 @@ namespace hub::system {
 
             load_to_coords(pos_begin, pos_end, this->pos());
             load_to_coords(vel_begin, vel_end, this->vel());
+            accels_.potential_valid() = false;
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
@@ -224,7 +295,7 @@ namespace hub::system {
         y.clear();
         y.reserve(this->variable_number());
         y.emplace_back(this->time());
-        add_coords_to(y, this->pos());
+        add_coords_to(y, std::as_const(*this).pos());
         add_coords_to(y, this->vel());
         if constexpr (Interactions::ext_vel_dep) {
             add_coords_to(y, aux_vel_);
@@ -238,7 +309,7 @@ namespace hub::system {
         dy_dh.reserve(this->variable_number());
         dy_dh.emplace_back(1);              // dt/dh
         add_coords_to(dy_dh, this->vel());  // dp/dh
-        Interactions::eval_acc(*this, this->accels_.acc());
+        this->accels_.eval_acc(*this, this->accels_.acc());
         add_coords_to(dy_dh, this->accels_.acc());  // dv/dh
         if constexpr (Interactions::ext_vel_dep) {
             add_coords_to(dy_dh, this->accels_.acc());  // dw/dh
@@ -252,11 +323,66 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::pre_iter_process() {
+        if constexpr (reorderable) {
+            enter_curve_order();
+        }
+        if constexpr (Interactions::compact_pairs) {
+            accels_.compact_pairs().rebuild(*this);
+        }
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
         }
     }
 
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void SimpleSystem<Particles, Interactions>::post_iter_process() {
+        if constexpr (reorderable) {
+            leave_curve_order();
+        }
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void SimpleSystem<Particles, Interactions>::enter_curve_order() {
+        using Order = particles::SpaceFillingOrder;
+        reorder_delta_.clear();
+        if (Order::curve == particles::SpaceFillingCurve::None || this->number() < Order::min_number) {
+            // the state carried over by the iterator is still in the last curve order
+            reorder_delta_.swap(curve_inverse_);
+            curve_order_.clear();
+            curve_inverse_.clear();
+            return;
+        }
+        size_t const num = this->number();
+        if (step_count_++ % std::max(Order::interval, size_t{1}) == 0) {
+            static thread_local std::vector<size_t> order;
+            Order::sort(std::as_const(*this).pos(), num, Order::curve, order);
+            reorder_delta_.resize(num);
+            for (size_t k = 0; k < num; ++k) {
+                reorder_delta_[k] = curve_inverse_.empty() ? order[k] : curve_inverse_[order[k]];
+            }
+            curve_order_ = order;
+            curve_inverse_.resize(num);
+            for (size_t k = 0; k < num; ++k) {
+                curve_inverse_[order[k]] = k;
+            }
+            curve_key_.renew();
+        }
+        this->reorder(curve_order_);
+        accels_.layout_key().swap(curve_key_);
+    }
+
+    template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
+    void SimpleSystem<Particles, Interactions>::leave_curve_order() {
+        if (curve_order_.empty()) {
+            return;
+        }
+        this->reorder(curve_inverse_);
+        accels_.layout_key().swap(curve_key_);
+        if constexpr (Interactions::compact_pairs) {
+            accels_.compact_pairs().rebuild(*this);
+        }
+    }
+
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::kick(Scalar step_size) {
         if constexpr (Interactions::ext_vel_dep) {
@@ -268,7 +394,7 @@ namespace hub::system {
             kick_pseu_vel(step_size);
             kick_real_vel(half_step);
         } else {
-            Interactions::eval_acc(*this, accels_.acc());
+            accels_.eval_acc(*this, accels_.acc());
             calc::array_advance(this->vel(), accels_.acc(), step_size);
             sync_vel_increment(accels_.acc(), step_size);
         }
@@ -278,6 +404,7 @@ namespace hub::system {
     void SimpleSystem<Particles, Interactions>::drift(Scalar step_size) {
         this->time() += step_size;
         calc::array_advance(this->pos(), this->vel(), step_size);
+        accels_.potential_valid() = false;
         sync_time_increment(step_size);
         sync_pos_increment(this->vel(), step_size);
     }
@@ -308,7 +435,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void SimpleSystem<Particles, Interactions>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.tot_vel_indep_acc());
+        accels_.eval_newtonian_acc(*this, accels_.tot_vel_indep_acc());
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
             calc::array_add(accels_.tot_vel_indep_acc(), accels_.tot_vel_indep_acc(), accels_.ext_vel_indep_acc());
@@ -25,6 +25,7 @@ License
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include "../core-computation.hpp"
 #include "../type-class.hpp"
@@ -71,6 +72,46 @@ namespace hub::system {
 
         Scalar step_scale() const { return 1.0; };
 
+        /**
+         * @brief Is the potential energy evaluated as a by-product of the last force pass still valid, i.e. the
+         * positions have not been advanced since?
+         */
+        [[nodiscard]] bool potential_cached() const { return accels_.potential_valid(); };
+
+        /**
+         * @brief Potential energy evaluated as a by-product of the last force pass (see `potential_cached()`).
+         */
+        [[nodiscard]] Scalar cached_potential() const { return accels_.potential(); };
+
+        /**
+         * @brief Compact pair list rebuilt every step(see `force::CompactPairs`).
+         */
+        SPACEHUB_READ_ACCESSOR(force::CompactPairs, compact_pairs, accels_.compact_pairs());
+
+        /**
+         * @brief Writable positions and masses. Taking them clears the cached potential energy(see
+         * `potential_cached()`).
+         */
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, StateVectorArray, pos, accels_.potential_valid() = false);
+
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, ScalarArray, mass, accels_.potential_valid() = false);
+
+        /**
+         * @brief Key of the current storage layout(see `force::LayoutKey`).
+         */
+        [[nodiscard]] size_t layout_key() const { return accels_.layout_key().id(); };
+
+        /**
+         * @brief Relative tolerance of the run passed to the forces(see `force::InteractionData::rtol`).
+         */
+        SPACEHUB_STD_ACCESSOR(double, force_rtol, accels_.rtol());
+
+        /**
+         * @brief Chain ordered SoA copy of the positions, velocities and masses for the far pair loops(see
+         * `ChainOrdered`).
+         */
+        SPACEHUB_READ_ACCESSOR(ChainOrdered<Scalar>, chain_ordered, ordered_);
+
         template <typename GenVectorArray>
         void evaluate_acc(GenVectorArray &acceleration) const;
 
@@ -143,6 +184,7 @@ namespace hub::system {
         StateScalarArray increment_;
         IdxArray index_;
         IdxArray new_index_;
+        ChainOrdered<Scalar> ordered_;
 
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> aux_vel_;
         std::conditional_t<Interactions::ext_vel_dep, StateVectorArray, Empty> chain_aux_vel_;
@@ -167,6 +209,7 @@ namespace hub::system {
         Chain::calc_chain_index(this->pos(), index_);
         Chain::calc_chain(this->pos(), chain_pos(), index_);
         Chain::calc_chain(this->vel(), chain_vel(), index_);
+        ordered_.update(*this, index_);
 
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
@@ -184,6 +227,8 @@ namespace hub::system {
     void ChainSystem<Particles, Interactions>::drift(Scalar step_size) {
         this->time() += step_size;
         chain_advance(this->pos(), chain_pos(), chain_vel(), step_size);
+        ordered_.update_pos(this->pos(), index_);
+        accels_.potential_valid() = false;
         sync_time_increment(step_size);
         sync_pos_increment(chain_vel(), step_size);
     }
@@ -199,15 +244,21 @@ namespace hub::system {
             kick_pseu_vel(step_size);
             kick_real_vel(half_step);
         } else {
-            Interactions::eval_acc(*this, accels_.acc());
+            accels_.eval_acc(*this, accels_.acc());
             Chain::calc_chain(accels_.acc(), chain_acc_, index());
             chain_advance(this->vel(), chain_vel(), chain_acc_, step_size);
+            ordered_.update_vel(this->vel(), index_);
             sync_vel_increment(chain_acc_, step_size);
         }
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::pre_iter_process() {
+        // masses (and coordinates) may have been changed through the public accessors since the last step
+        ordered_.update(*this, index_);
+        if constexpr (Interactions::compact_pairs) {
+            accels_.compact_pairs().rebuild(*this);
+        }
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
             chain_aux_vel_ = chain_vel_;
@@ -216,13 +267,15 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::post_iter_process() {
-        Chain::calc_chain_index(this->pos(), new_index_);
-        if (new_index_ != index_) {
+        new_index_ = index_;
+        if (Chain::update_chain_index(std::as_const(*this).pos(), new_index_)) {
             Chain::update_chain(chain_pos_, this->pos(), index_, new_index_);
-            Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), new_index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_pos_, this->pos(), new_index_);
             Chain::update_chain(chain_vel_, this->vel(), index_, new_index_);
-            Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), new_index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_vel_, this->vel(), new_index_);
             index_ = new_index_;
+            ordered_.update(*this, index_);
+            accels_.potential_valid() = false;
         }
     }
 
@@ -246,7 +299,7 @@ namespace hub::system {
         dy_dh.reserve(this->variable_number());
         dy_dh.emplace_back(1);             // dt/dt
         add_coords_to(dy_dh, chain_vel_);  // dX/dt
-        evaluate_acc(this->accels_.acc());
+        this->accels_.eval_acc(*this, this->accels_.acc());
         Chain::calc_chain(this->accels_.acc(), chain_acc_, index());
         add_coords_to(dy_dh, chain_acc_);  // dV/dt
         if constexpr (Interactions::ext_vel_dep) {
@@ -268,13 +321,16 @@ namespace hub::system {
             load_to_coords(pos_begin, pos_end, chain_pos_);
             load_to_coords(vel_begin, vel_end, chain_vel_);
 
-            Chain::calc_cartesian(this->mass(), chain_pos_, this->pos(), index_);
-            Chain::calc_cartesian(this->mass(), chain_vel_, this->vel(), index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_pos_, this->pos(), index_);
+            Chain::calc_cartesian(std::as_const(*this).mass(), chain_vel_, this->vel(), index_);
+            ordered_.update_pos(this->pos(), index_);
+            ordered_.update_vel(this->vel(), index_);
+            accels_.potential_valid() = false;
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
                 load_to_coords(aux_vel_begin, aux_vel_end, chain_aux_vel_);
-                Chain::calc_cartesian(this->mass(), chain_aux_vel_, aux_vel_, index_);
+                Chain::calc_cartesian(std::as_const(*this).mass(), chain_aux_vel_, aux_vel_, index_);
             }
         } else {
             spacehub_abort("Wrong input array size!");
@@ -303,12 +359,12 @@ namespace hub::system {
     void ChainSystem<Particles, Interactions>::chain_advance(Array1 &var, Array2 &chain_var, Array3 &chain_increment,
                                                              Scalar step_size) {
         calc::array_advance(chain_var, chain_increment, step_size);
-        Chain::calc_cartesian(this->mass(), chain_var, var, index());
+        Chain::calc_cartesian(std::as_const(*this).mass(), chain_var, var, index());
     }
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions>
     void ChainSystem<Particles, Interactions>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.tot_vel_indep_acc());
+        accels_.eval_newtonian_acc(*this, accels_.tot_vel_indep_acc());
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
             calc::array_add(accels_.tot_vel_indep_acc(), accels_.tot_vel_indep_acc(), accels_.ext_vel_indep_acc());
@@ -328,6 +384,7 @@ namespace hub::system {
     void ChainSystem<Particles, Interactions>::kick_real_vel(Scalar step_size) {
         std::swap(aux_vel_, this->vel());
         std::swap(chain_aux_vel_, chain_vel());
+        ordered_.update_vel(this->vel(), index_);
         Interactions::eval_extra_vel_dep_acc(*this, accels_.ext_vel_dep_acc());
         std::swap(aux_vel_, this->vel());
         std::swap(chain_aux_vel_, chain_vel());
@@ -335,6 +392,7 @@ namespace hub::system {
         calc::array_add(accels_.acc(), accels_.tot_vel_indep_acc(), accels_.ext_vel_dep_acc());
         Chain::calc_chain(accels_.acc(), chain_acc_, index());
         chain_advance(this->vel(), chain_vel(), chain_acc_, step_size);
+        ordered_.update_vel(this->vel(), index_);
         sync_vel_increment(chain_acc_, step_size);
     }
 
@@ -25,60 +25,126 @@ License
 #pragma once
 
 #include <algorithm>
-#include <list>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <vector>
 
 #include "../core-computation.hpp"
+#include "../type-class.hpp"
 
 namespace hub {
 
     /*---------------------------------------------------------------------------*\
-          Class Chain Declaration
+          Class ChainSearchTree Declaration
     \*---------------------------------------------------------------------------*/
     /**
-     * @brief Static class for chain coordinates transformation.
+     * @brief k-d tree for the nearest neighbour queries of the chain construction.
      *
+     * The tree is balanced over a fixed point set. Points can be removed. A removed point is skipped by later queries,
+     * and subtrees with no remaining points are pruned.
      */
-    class Chain {
+    class ChainSearchTree {
        public:
         /**
-         * @brief Node used to create chain index.
+         * @brief Result of a nearest neighbour query.
          */
-        struct Node {
-            /**
-             * @brief Relative distance between two particles.
-             */
-            double r;
-            /**
-             * @brief The index of the first particle.
-             */
-            size_t i;
+        struct Neighbour {
             /**
-             * @brief The index of the second particle.
+             * @brief Index of the neighbour, `npos` if no point remains.
              */
             size_t j;
             /**
-             * @brief Flag indicates if this node has been added to the chain.
+             * @brief Squared distance to the neighbour.
              */
-            bool avail;
+            double r2;
         };
 
+        static constexpr size_t npos{std::numeric_limits<size_t>::max()};
+
+        /**
+         * @brief Build the tree over `pos` with all points present.
+         */
+        template <typename VectorArray>
+        void build(VectorArray const &pos);
+
+        /**
+         * @brief Remove the i-th point from later queries.
+         */
+        void remove(size_t i);
+
+        /**
+         * @brief Nearest remaining point to the i-th point, other than the i-th point itself.
+         */
+        [[nodiscard]] Neighbour nearest(size_t i) const;
+
+       private:
+        void build(size_t lo, size_t hi, size_t depth);
+
+        void search(size_t lo, size_t hi, double const *q, size_t self, Neighbour &best) const;
+
+        std::vector<double> x_, y_, z_;
+        std::vector<size_t> order_;
+        std::vector<size_t> slot_;
+        std::vector<size_t> alive_;
+        std::vector<unsigned char> axis_;
+        std::vector<bool> removed_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class Chain Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Static class for chain coordinates transformation.
+     *
+     */
+    class Chain {
+       public:
         // Constructors
         SPACEHUB_MAKE_CONSTRUCTORS(Chain, default, default, default, default, default);
 
         /**
-         * @brief Calculate the chain index.
+         * @brief Maximum number of local re-links `update_chain_index()` applies in one call before it rebuilds the
+         * chain.
+         */
+        inline static size_t max_local_relinks{8};
+
+        /**
+         * @brief Calculate the chain index from scratch.
+         *
+         * The chain starts from the closest pair and grows by adding the particle nearest to either end, with the
+         * nearest neighbours found in a k-d tree(see `ChainSearchTree`), O(N log N).
          *
          * @tparam VectorArray Type of the Structure of Array coordinates.
          * @tparam IdxArray Type of the index array.
          * @param[in] pos Input position in Cartesian coordinates.
          * @param[out] index Output index array.
-         * @note The memory hub of the index need to be allocated in advance. The size of pos and index need to be the
-         * same.
          */
         template <typename VectorArray, typename IdxArray>
         static void calc_chain_index(VectorArray const &pos, IdxArray &index);
 
+        /**
+         * @brief Update an existing chain index to the current positions.
+         *
+         * The validity test looks for non-chained pairs closer to each other than to any of their chain neighbours.
+         * The greedy construction of `calc_chain_index()` never leaves such a pair. A sweep along x finds them, each
+         * particle looking no further than its shorter chain link. The order from the previous call is re-sorted by
+         * insertion sort. If linking a pair by reversing a chain segment (a 2-opt move) makes the chain shorter, that
+         * move is applied in place. If no 2-opt move does, or after `max_local_relinks` moves in one call, the chain
+         * is rebuilt by `calc_chain_index()`. In the common case with an unchanged or nearly unchanged chain this
+         * costs O(N), since the shorter link of a particle is of the order of its neighbour distance.
+         *
+         * Systems with less than four particles are always rebuilt.
+         *
+         * @tparam VectorArray Type of the Structure of Array coordinates.
+         * @tparam IdxArray Type of the index array.
+         * @param[in] pos Input position in Cartesian coordinates.
+         * @param[in,out] index The chain index array.
+         * @return bool Has the index changed?
+         */
+        template <typename VectorArray, typename IdxArray>
+        static bool update_chain_index(VectorArray const &pos, IdxArray &index);
+
         /**
          * @brief Update the chain coordinates from old index array to new index array.
          *
@@ -131,19 +197,21 @@ namespace hub {
         static constexpr bool bijective_transfer{true};
 
        private:
-        template <typename T>
-        static bool not_in_list(std::list<T> &list, T var);
-
-        template <typename InsertOpt>
-        static bool try_insert(std::list<size_t> &list, size_t &chain_end, Node &n, size_t idx, InsertOpt insert);
-
-        static bool try_add_to_chain(std::list<size_t> &list, size_t &head, size_t &tail, Node &n);
+        /**
+         * @brief Chain segment [first, last] to be reversed by a local re-link.
+         */
+        struct Relink {
+            size_t first;
+            size_t last;
+        };
 
-        template <typename VectorArray, typename Container>
-        static void create_distances_array(VectorArray const &pos, Container &vec);
+        /**
+         * @brief Outcome of the validity test in `find_relink()`.
+         */
+        enum class Violation { none, relink, rebuild };
 
-        template <typename IdxArray>
-        static void create_index_from_dist_array(std::vector<Node> &dist, IdxArray &idx, size_t num);
+        template <typename VectorArray, typename IdxArray>
+        static Violation find_relink(VectorArray const &pos, IdxArray const &index, Relink &relink);
 
         template <typename VectorArray>
         static auto get_new_node(VectorArray const &chain, size_t head, size_t tail) ->
@@ -158,15 +226,346 @@ namespace hub {
         CREATE_MEMBER_CHECK(err);
     };
 
+    /*---------------------------------------------------------------------------*\
+          Class ChainOrdered Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Chain ordered structure-of-arrays copy of the positions, velocities and masses of a chain system.
+     *
+     * Slot k holds particle index[k], so the far pairs (j >= i + 3) of the chain walk unit-stride data instead of
+     * gathering p[index[j]] - p[index[i]]. The owner system refreshes the whole copy in `pre_iter_process()` and when
+     * the chain index changes, and the positions/velocities whenever it updates the Cartesian coordinates.
+     *
+     * @tparam T Scalar type of the copy.
+     */
+    template <typename T>
+    struct ChainOrdered {
+        std::vector<T> x, y, z, vx, vy, vz, m;
+
+        /**
+         * @brief Number of particles in the copy.
+         */
+        [[nodiscard]] inline size_t size() const { return m.size(); }
+
+        template <typename ScalarArray, typename IdxArray>
+        void update_mass(ScalarArray const &mass, IdxArray const &index);
+
+        template <typename VectorArray, typename IdxArray>
+        void update_pos(VectorArray const &pos, IdxArray const &index);
+
+        template <typename VectorArray, typename IdxArray>
+        void update_vel(VectorArray const &vel, IdxArray const &index);
+
+        /**
+         * @brief Refresh masses, positions and velocities.
+         */
+        template <typename Particles, typename IdxArray>
+        void update(Particles const &particles, IdxArray const &index);
+    };
+
+    /*---------------------------------------------------------------------------*\
+          Class ChainOrdered Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T>
+    template <typename ScalarArray, typename IdxArray>
+    void ChainOrdered<T>::update_mass(const ScalarArray &mass, const IdxArray &index) {
+        size_t const n = index.size();
+        m.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            m[k] = static_cast<T>(mass[index[k]]);
+        }
+    }
+
+    template <typename T>
+    template <typename VectorArray, typename IdxArray>
+    void ChainOrdered<T>::update_pos(const VectorArray &pos, const IdxArray &index) {
+        size_t const n = index.size();
+        x.resize(n), y.resize(n), z.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            x[k] = static_cast<T>(pos[index[k]].x);
+            y[k] = static_cast<T>(pos[index[k]].y);
+            z[k] = static_cast<T>(pos[index[k]].z);
+        }
+    }
+
+    template <typename T>
+    template <typename VectorArray, typename IdxArray>
+    void ChainOrdered<T>::update_vel(const VectorArray &vel, const IdxArray &index) {
+        size_t const n = index.size();
+        vx.resize(n), vy.resize(n), vz.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            vx[k] = static_cast<T>(vel[index[k]].x);
+            vy[k] = static_cast<T>(vel[index[k]].y);
+            vz[k] = static_cast<T>(vel[index[k]].z);
+        }
+    }
+
+    template <typename T>
+    template <typename Particles, typename IdxArray>
+    void ChainOrdered<T>::update(const Particles &particles, const IdxArray &index) {
+        update_mass(particles.mass(), index);
+        update_pos(particles.pos(), index);
+        update_vel(particles.vel(), index);
+    }
+
+    /*---------------------------------------------------------------------------*\
+          Class ChainSearchTree Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename VectorArray>
+    void ChainSearchTree::build(const VectorArray &pos) {
+        size_t const num = pos.size();
+        order_.resize(num);
+        std::iota(order_.begin(), order_.end(), 0);
+        x_.resize(num), y_.resize(num), z_.resize(num);
+        slot_.resize(num), alive_.resize(num), axis_.resize(num);
+        removed_.assign(num, false);
+        for (size_t i = 0; i < num; ++i) {
+            x_[i] = static_cast<double>(pos[i].x);
+            y_[i] = static_cast<double>(pos[i].y);
+            z_[i] = static_cast<double>(pos[i].z);
+        }
+        build(0, num, 0);
+        // move the coordinates into tree order for the queries
+        std::vector<double> buf(num);
+        for (auto *coord : {&x_, &y_, &z_}) {
+            for (size_t k = 0; k < num; ++k) {
+                buf[k] = (*coord)[order_[k]];
+            }
+            coord->swap(buf);
+        }
+        for (size_t k = 0; k < num; ++k) {
+            slot_[order_[k]] = k;
+        }
+    }
+
+    inline void ChainSearchTree::build(size_t lo, size_t hi, size_t depth) {
+        if (lo >= hi) return;
+        size_t mid = lo + (hi - lo) / 2;
+        auto const &coord = depth % 3 == 0 ? x_ : (depth % 3 == 1 ? y_ : z_);
+        std::nth_element(order_.begin() + lo, order_.begin() + mid, order_.begin() + hi,
+                         [&](size_t a, size_t b) { return coord[a] < coord[b]; });
+        axis_[mid] = static_cast<unsigned char>(depth % 3);
+        alive_[mid] = hi - lo;
+        build(lo, mid, depth + 1);
+        build(mid + 1, hi, depth + 1);
+    }
+
+    inline void ChainSearchTree::remove(size_t i) {
+        size_t k = slot_[i];
+        if (removed_[k]) return;
+        removed_[k] = true;
+        size_t lo = 0;
+        size_t hi = order_.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            alive_[mid]--;
+            if (k == mid) {
+                break;
+            } else if (k < mid) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+    }
+
+    inline auto ChainSearchTree::nearest(size_t i) const -> Neighbour {
+        size_t k = slot_[i];
+        double const q[3] = {x_[k], y_[k], z_[k]};
+        Neighbour best{npos, std::numeric_limits<double>::infinity()};
+        search(0, order_.size(), q, k, best);
+        return best;
+    }
+
+    inline void ChainSearchTree::search(size_t lo, size_t hi, double const *q, size_t self, Neighbour &best) const {
+        if (lo >= hi) return;
+        size_t mid = lo + (hi - lo) / 2;
+        if (alive_[mid] == 0) return;
+
+        if (!removed_[mid] && mid != self) {
+            double dx = x_[mid] - q[0];
+            double dy = y_[mid] - q[1];
+            double dz = z_[mid] - q[2];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < best.r2 || (r2 == best.r2 && order_[mid] < best.j)) {
+                best = Neighbour{order_[mid], r2};
+            }
+        }
+
+        double p[3] = {x_[mid], y_[mid], z_[mid]};
+        double diff = q[axis_[mid]] - p[axis_[mid]];
+        if (diff < 0) {
+            search(lo, mid, q, self, best);
+            if (diff * diff <= best.r2) search(mid + 1, hi, q, self, best);
+        } else {
+            search(mid + 1, hi, q, self, best);
+            if (diff * diff <= best.r2) search(lo, mid, q, self, best);
+        }
+    }
+
     /*---------------------------------------------------------------------------*\
           Class Chain Implementation
     \*---------------------------------------------------------------------------*/
     template <typename VectorArray, typename IdxArray>
     void Chain::calc_chain_index(VectorArray const &pos, IdxArray &index) {
-        std::vector<Node> dist;
-        create_distances_array(pos, dist);
-        std::sort(dist.begin(), dist.end(), [&](Node const &ni, Node const &nj) { return (ni.r < nj.r); });
-        create_index_from_dist_array(dist, index, pos.size());
+        size_t const num = pos.size();
+        static thread_local std::vector<size_t> chain;
+        chain.assign(2 * num + 1, 0);
+        size_t head = num;
+        size_t tail = num;
+
+        if (num < 2) {
+            chain[head] = 0;
+        } else {
+            static thread_local ChainSearchTree tree;
+            tree.build(pos);
+
+            ChainSearchTree::Neighbour closest{ChainSearchTree::npos, std::numeric_limits<double>::infinity()};
+            size_t first = 0;
+            for (size_t i = 0; i < num; ++i) {
+                auto n = tree.nearest(i);
+                if (n.r2 < closest.r2) {
+                    closest = n;
+                    first = i;
+                }
+            }
+
+            chain[head] = std::min(first, closest.j);
+            chain[++tail] = std::max(first, closest.j);
+            tree.remove(chain[head]);
+            tree.remove(chain[tail]);
+
+            auto near_head = tree.nearest(chain[head]);
+            auto near_tail = tree.nearest(chain[tail]);
+            for (size_t chained = 2; chained < num; ++chained) {
+                if (near_head.r2 <= near_tail.r2) {
+                    size_t k = near_head.j;
+                    chain[--head] = k;
+                    tree.remove(k);
+                    near_head = tree.nearest(k);
+                    if (near_tail.j == k) {
+                        near_tail = tree.nearest(chain[tail]);
+                    }
+                } else {
+                    size_t k = near_tail.j;
+                    chain[++tail] = k;
+                    tree.remove(k);
+                    near_tail = tree.nearest(k);
+                    if (near_head.j == k) {
+                        near_head = tree.nearest(chain[head]);
+                    }
+                }
+            }
+        }
+
+        index.clear();
+        for (size_t k = head; k <= tail && num > 0; ++k) {
+            index.emplace_back(chain[k]);
+        }
+    }
+
+    template <typename VectorArray, typename IdxArray>
+    bool Chain::update_chain_index(VectorArray const &pos, IdxArray &index) {
+        size_t const num = pos.size();
+        if (num < 4 || index.size() != num) {
+            IdxArray old = index;
+            calc_chain_index(pos, index);
+            return old != index;
+        }
+
+        Relink relink{};
+        IdxArray old;
+        size_t relinks = 0;
+        for (auto v = find_relink(pos, index, relink); v != Violation::none; v = find_relink(pos, index, relink)) {
+            if (relinks == 0) {
+                old = index;
+            }
+            if (v == Violation::rebuild || relinks == max_local_relinks) {
+                calc_chain_index(pos, index);
+                return old != index;
+            }
+            std::reverse(index.begin() + relink.first, index.begin() + relink.last + 1);
+            ++relinks;
+        }
+        return relinks > 0;
+    }
+
+    template <typename VectorArray, typename IdxArray>
+    auto Chain::find_relink(VectorArray const &pos, IdxArray const &index, Relink &relink) -> Violation {
+        size_t const num = pos.size();
+        static thread_local std::vector<size_t> rank;
+        static thread_local std::vector<double> x, link, reach;
+        static thread_local std::vector<size_t> order;
+
+        rank.resize(num), x.resize(num), link.resize(num - 1);
+        reach.assign(num, std::numeric_limits<double>::infinity());
+        for (size_t k = 0; k < num; ++k) {
+            rank[index[k]] = k;
+            x[k] = static_cast<double>(pos[k].x);
+        }
+
+        auto dist = [&](size_t i, size_t j) -> double {
+            double dx = static_cast<double>(pos[j].x - pos[i].x);
+            double dy = static_cast<double>(pos[j].y - pos[i].y);
+            double dz = static_cast<double>(pos[j].z - pos[i].z);
+            return std::sqrt(dx * dx + dy * dy + dz * dz);
+        };
+
+        for (size_t k = 0; k < num - 1; ++k) {
+            link[k] = dist(index[k], index[k + 1]);
+            reach[index[k]] = std::min(reach[index[k]], link[k]);
+            reach[index[k + 1]] = std::min(reach[index[k + 1]], link[k]);
+        }
+
+        // the order along x of the last call is nearly sorted, so the insertion sort is O(N) in the common case
+        if (order.size() != num) {
+            order.resize(num);
+            std::iota(order.begin(), order.end(), 0);
+        }
+        for (size_t s = 1; s < num; ++s) {
+            size_t key = order[s];
+            size_t t = s;
+            for (; t > 0 && x[order[t - 1]] > x[key]; --t) {
+                order[t] = order[t - 1];
+            }
+            order[t] = key;
+        }
+
+        // gain of linking chain positions p < q by reversing [p + 1, q] or [p, q - 1]
+        auto try_pair = [&](size_t a, size_t b) -> Violation {
+            size_t p = std::min(rank[a], rank[b]);
+            size_t q = std::max(rank[a], rank[b]);
+            if (q - p < 2) return Violation::none;
+
+            double r = dist(a, b);
+            if (r >= reach[a] || r >= reach[b]) return Violation::none;
+
+            double old_tail = link[p] + (q + 1 < num ? link[q] : 0.0);
+            double new_tail = r + (q + 1 < num ? dist(index[p + 1], index[q + 1]) : 0.0);
+            double old_head = (p > 0 ? link[p - 1] : 0.0) + link[q - 1];
+            double new_head = (p > 0 ? dist(index[p - 1], index[q - 1]) : 0.0) + r;
+
+            double gain_tail = old_tail - new_tail;
+            double gain_head = old_head - new_head;
+            constexpr double tol = 1e-12;
+            if (gain_tail >= gain_head && gain_tail > tol * old_tail) {
+                relink = Relink{p + 1, q};
+                return Violation::relink;
+            } else if (gain_head > tol * old_head) {
+                relink = Relink{p, q - 1};
+                return Violation::relink;
+            }
+            return Violation::rebuild;
+        };
+
+        // a violating pair is closer than the shorter link of either end, so looking ahead along x is enough
+        for (size_t s = 0; s < num; ++s) {
+            size_t a = order[s];
+            for (size_t t = s + 1; t < num && x[order[t]] - x[a] < reach[a]; ++t) {
+                if (auto v = try_pair(a, order[t]); v != Violation::none) return v;
+            }
+        }
+        return Violation::none;
     }
 
     template <typename VectorArray, typename IdxArray>
@@ -180,11 +579,15 @@ namespace hub {
         VectorArray new_chain;
         new_chain.reserve(size);
 
-        auto get_idx = [&](auto var) -> auto { return std::find(idx.begin(), idx.end(), var) - idx.begin(); };
+        static thread_local std::vector<size_t> rank;
+        rank.resize(size);
+        for (size_t k = 0; k < size; ++k) {
+            rank[idx[k]] = k;
+        }
 
         for (size_t i = 0; i < size - 1; ++i) {
-            auto first = get_idx(new_idx[i]);
-            auto last = get_idx(new_idx[i + 1]);
+            auto first = rank[new_idx[i]];
+            auto last = rank[new_idx[i + 1]];
             new_chain.emplace_back(get_new_node(chain, first, last));
         }
 
@@ -211,79 +614,6 @@ namespace hub {
         to_chain(cartesian, chain, index);
     }
 
-    template <typename T>
-    bool Chain::not_in_list(std::list<T> &list, T var) {
-        return list.end() == std::find(list.begin(), list.end(), var);
-    }
-
-    template <typename InsertOpt>
-    bool Chain::try_insert(std::list<size_t> &list, size_t &chain_end, Chain::Node &n, size_t idx, InsertOpt insert) {
-        n.avail = false;
-        if (not_in_list(list, idx)) {
-            insert(idx);
-            chain_end = idx;
-            return true;
-        } else {
-            return false;
-        }
-    }
-
-    bool Chain::try_add_to_chain(std::list<size_t> &list, size_t &head, size_t &tail, Chain::Node &n) {
-        if (head == n.i) {
-            return try_insert(list, head, n, n.j, [&](size_t idx) { list.emplace_front(idx); });
-        } else if (head == n.j) {
-            return try_insert(list, head, n, n.i, [&](size_t idx) { list.emplace_front(idx); });
-        } else if (tail == n.i) {
-            return try_insert(list, tail, n, n.j, [&](size_t idx) { list.emplace_back(idx); });
-        } else if (tail == n.j) {
-            return try_insert(list, tail, n, n.i, [&](size_t idx) { list.emplace_back(idx); });
-        }
-        return false;
-    }
-
-    template <typename VectorArray, typename Container>
-    void Chain::create_distances_array(VectorArray const &pos, Container &vec) {
-        size_t num = pos.size();
-        vec.reserve(num * (num - 1));
-        for (size_t i = 0; i < num; ++i) {
-            for (size_t j = i + 1; j < num; ++j) {
-                decltype(pos[j]) dr = (pos[j] - pos[i]);
-                decltype(dr.x) r2 = dr.x * dr.x + dr.y * dr.y + dr.z * dr.z;
-                vec.emplace_back(Node{r2, i, j, true});
-            }
-        }
-    }
-
-    template <typename IdxArray>
-    void Chain::create_index_from_dist_array(std::vector<Node> &dist, IdxArray &idx, size_t num) {
-        auto head = dist[0].i;
-        auto tail = dist[0].j;
-        dist[0].avail = false;
-
-        std::list<size_t> idx_list{head, tail};
-
-        size_t chained_num = 1;
-
-        size_t dist_size = dist.size();
-        for (size_t k = 1; k < dist_size; ++k) {
-            if (dist[k].avail) {
-                if (try_add_to_chain(idx_list, head, tail, dist[k])) {
-                    chained_num++;
-                    if (chained_num == num) {
-                        break;
-                    } else {
-                        k = 1;
-                    }
-                }
-            }
-        }
-
-        idx.clear();
-        for (auto &l : idx_list) {
-            idx.emplace_back(l);
-        }
-    }
-
     template <typename VectorArray>
     auto Chain::get_new_node(VectorArray const &chain, size_t head, size_t tail) -> typename VectorArray::value_type {
         using Vector = typename VectorArray::value_type;
@@ -333,9 +663,14 @@ namespace hub {
         } else {
             chain[size - 1] = cartesian[index[0]];
         }
+        if constexpr (unrolled_size_v<Array> != 0) {
+            static_for<0, unrolled_size_v<Array> - 1>(
+                [&](auto i) { chain[i] = cartesian[index[i + 1]] - cartesian[index[i]]; });
+        } else {
 #pragma GCC ivdep
-        for (size_t i = 0; i < size - 1; ++i) {
-            chain[i] = cartesian[index[i + 1]] - cartesian[index[i]];
+            for (size_t i = 0; i < size - 1; ++i) {
+                chain[i] = cartesian[index[i + 1]] - cartesian[index[i]];
+            }
         }
     }
 
@@ -348,8 +683,13 @@ namespace hub {
         } else {
             cartesian[index[0]] = chain[size - 1];
         }
-        for (size_t i = 1; i < size; ++i) {
-            cartesian[index[i]] = cartesian[index[i - 1]] + chain[i - 1];
+        if constexpr (unrolled_size_v<Array> != 0) {
+            static_for<1, unrolled_size_v<Array>>(
+                [&](auto i) { cartesian[index[i]] = cartesian[index[i - 1]] + chain[i - 1]; });
+        } else {
+            for (size_t i = 1; i < size; ++i) {
+                cartesian[index[i]] = cartesian[index[i - 1]] + chain[i - 1];
+            }
         }
     }
 }  // namespace hub
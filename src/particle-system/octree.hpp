@@ -1,109 +1,377 @@
-//
-// Created by 王艺涵 on 4/15/19.
-//
-
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file octree.hpp
+ *
+ * Header file.
+ */
 #pragma once
 
-#include <memory>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
 
+#include "../vector/vector3.hpp"
+/**
+ * @namespace hub::octree
+ * Barnes-Hut octree with monopole and quadrupole cell moments.
+ */
 namespace hub::octree {
 
+    /*---------------------------------------------------------------------------*\
+         Class Node Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Octree cell.
+     *
+     * @tparam T Floating point type.
+     */
     template <typename T>
-    class Node {
-        T *data{nullptr};
-        std::unique_ptr<Node> flu{nullptr};
-        std::unique_ptr<Node> fld{nullptr};
-        std::unique_ptr<Node> fru{nullptr};
-        std::unique_ptr<Node> frd{nullptr};
-        std::unique_ptr<Node> blu{nullptr};
-        std::unique_ptr<Node> bld{nullptr};
-        std::unique_ptr<Node> bru{nullptr};
-        std::unique_ptr<Node> brd{nullptr};
-    };
+    struct Node {
+        using Vector = Vec3<T>;
 
-    enum class region { flu, fld, fru, frd, blu, bld, bru, brd };
+        /**
+         * @brief Geometric center of the cell at the last build.
+         */
+        Vector center;
 
-    template <typename T>
+        /**
+         * @brief Center of mass of the particles in the cell.
+         */
+        Vector com;
+
+        /**
+         * @brief Traceless quadrupole about `com`, stored as (xx, xy, xz, yy, yz, zz).
+         */
+        std::array<T, 6> quad{0, 0, 0, 0, 0, 0};
+
+        /**
+         * @brief Half side length of the cell at the last build.
+         */
+        T half{0};
+
+        /**
+         * @brief Total mass of the particles in the cell.
+         */
+        T mass{0};
+
+        /**
+         * @brief Upper bound of the distance between `com` and any particle in the cell.
+         */
+        T b_max{0};
+
+        /**
+         * @brief Indices of the child cells in the node array, -1 for empty octants.
+         */
+        std::array<int, 8> child{-1, -1, -1, -1, -1, -1, -1, -1};
+
+        /**
+         * @brief Range [begin, end) of the particles of this cell in `Octree::order()`.
+         */
+        size_t begin{0}, end{0};
+
+        /**
+         * @brief Is this cell a leaf?
+         */
+        bool leaf{true};
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Octree Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Barnes-Hut octree over a set of point masses.
+     *
+     * The cells are stored in a flat array in pre-order (parents before children) and every cell owns a
+     * contiguous range of the particle permutation `order()`. `build()` creates the topology from scratch,
+     * `refit()` keeps the topology and only recomputes the cell moments and bounding radii from the current
+     * positions, which stays correct (but becomes less efficient) as particles drift away from their cells.
+     *
+     * @tparam T Floating point type.
+     * @tparam LeafCapacity Maximum number of particles in a leaf.
+     */
+    template <typename T, size_t LeafCapacity = 8>
     class Octree {
        public:
         using value_type = T;
+        using Vector = Vec3<T>;
+
+        /**
+         * @brief Maximum number of particles in a leaf.
+         */
+        static constexpr size_t leaf_capacity{LeafCapacity};
+
+        /**
+         * @brief Maximum depth of the tree. Cells at this depth become leaves regardless of their size.
+         */
+        static constexpr size_t max_depth{48};
+
+        /**
+         * @brief Build the tree from scratch.
+         *
+         * @param[in] pos Position array.
+         * @param[in] mass Mass array.
+         */
+        template <typename VectorArray, typename ScalarArray>
+        void build(VectorArray const &pos, ScalarArray const &mass);
+
+        /**
+         * @brief Recompute the cell moments with the current positions, keeping the tree topology.
+         *
+         * @param[in] pos Position array. Must have the same particle number as the last `build()`.
+         * @param[in] mass Mass array.
+         */
+        template <typename VectorArray, typename ScalarArray>
+        void refit(VectorArray const &pos, ScalarArray const &mass);
+
+        /**
+         * @brief Acceleration of the i-th particle.
+         *
+         * A cell is accepted if its bounding sphere seen from the particle is smaller than the opening angle, i.e.
+         * b_max < theta * d. Accepted cells contribute their monopole and quadrupole, the particles of opened
+         * leaves are summed directly. theta = 0 reduces to the direct summation.
+         *
+         * @param[in] i Index of the particle.
+         * @param[in] pos Position array.
+         * @param[in] mass Mass array.
+         * @param[in] theta Opening angle.
+         * @return Vector The acceleration.
+         */
+        template <typename VectorArray, typename ScalarArray>
+        Vector acc(size_t i, VectorArray const &pos, ScalarArray const &mass, T theta) const;
+
+        /**
+         * @brief Number of particles in the tree.
+         */
+        [[nodiscard]] inline size_t number() const { return order_.size(); }
+
+        /**
+         * @brief Particle indices ordered by cells.
+         */
+        [[nodiscard]] inline std::vector<size_t> const &order() const { return order_; }
+
+        /**
+         * @brief The cells, root first.
+         */
+        [[nodiscard]] inline std::vector<Node<T>> const &nodes() const { return nodes_; }
+
+       private:
+        template <typename VectorArray>
+        int build_node(VectorArray const &pos, Vector const &center, T half, size_t begin, size_t end,
+                       size_t depth);
+
+        template <typename VectorArray, typename ScalarArray>
+        void calc_moments(Node<T> &node, VectorArray const &pos, ScalarArray const &mass);
+
+        static inline size_t octant(Vector const &center, Vector const &p) {
+            return static_cast<size_t>(p.x > center.x) | (static_cast<size_t>(p.y > center.y) << 1) |
+                   (static_cast<size_t>(p.z > center.z) << 2);
+        }
+
+        std::vector<Node<T>> nodes_;
+
+        std::vector<size_t> order_;
+
+        std::vector<size_t> buffer_;
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class Octree Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename T, size_t LeafCapacity>
+    template <typename VectorArray, typename ScalarArray>
+    void Octree<T, LeafCapacity>::build(const VectorArray &pos, const ScalarArray &mass) {
+        size_t const n = mass.size();
+        nodes_.clear();
+        order_.resize(n);
+        buffer_.resize(n);
+        for (size_t i = 0; i < n; ++i) order_[i] = i;
 
-        template <typename ParticleIterable>
-        Octree(STL &stl) {
-            for (auto &d : stl) {
-                insert();
+        if (n == 0) return;
+
+        Vector low{static_cast<T>(pos[0].x), static_cast<T>(pos[0].y), static_cast<T>(pos[0].z)};
+        Vector high = low;
+        for (size_t i = 1; i < n; ++i) {
+            low.x = std::min(low.x, static_cast<T>(pos[i].x)), high.x = std::max(high.x, static_cast<T>(pos[i].x));
+            low.y = std::min(low.y, static_cast<T>(pos[i].y)), high.y = std::max(high.y, static_cast<T>(pos[i].y));
+            low.z = std::min(low.z, static_cast<T>(pos[i].z)), high.z = std::max(high.z, static_cast<T>(pos[i].z));
+        }
+        Vector center = (low + high) * 0.5;
+        T half = std::max({high.x - low.x, high.y - low.y, high.z - low.z}) * 0.5;
+
+        build_node(pos, center, half, 0, n, 0);
+        refit(pos, mass);
+    }
+
+    template <typename T, size_t LeafCapacity>
+    template <typename VectorArray>
+    int Octree<T, LeafCapacity>::build_node(const VectorArray &pos, const Vector &center, T half, size_t begin, size_t end,
+                              size_t depth) {
+        int const id = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[id].center = center;
+        nodes_[id].half = half;
+        nodes_[id].begin = begin;
+        nodes_[id].end = end;
+
+        if (end - begin <= leaf_capacity || depth >= max_depth) {
+            return id;
+        }
+        nodes_[id].leaf = false;
+
+        auto p_of = [&](size_t k) {
+            return Vector{static_cast<T>(pos[k].x), static_cast<T>(pos[k].y), static_cast<T>(pos[k].z)};
+        };
+
+        // counting sort of the particle range by octant
+        std::array<size_t, 9> offset{};
+        for (size_t k = begin; k < end; ++k) {
+            offset[octant(center, p_of(order_[k])) + 1]++;
+        }
+        for (size_t oct = 0; oct < 8; ++oct) {
+            offset[oct + 1] += offset[oct];
+        }
+        std::array<size_t, 8> cursor;
+        std::copy(offset.begin(), offset.begin() + 8, cursor.begin());
+        for (size_t k = begin; k < end; ++k) {
+            buffer_[begin + cursor[octant(center, p_of(order_[k]))]++] = order_[k];
+        }
+        std::copy(buffer_.begin() + begin, buffer_.begin() + end, order_.begin() + begin);
+
+        T const quarter = half * 0.5;
+        for (size_t oct = 0; oct < 8; ++oct) {
+            if (offset[oct + 1] > offset[oct]) {
+                Vector sub{center.x + ((oct & 1) ? quarter : -quarter), center.y + ((oct & 2) ? quarter : -quarter),
+                           center.z + ((oct & 4) ? quarter : -quarter)};
+                int child = build_node(pos, sub, quarter, begin + offset[oct], begin + offset[oct + 1], depth + 1);
+                nodes_[id].child[oct] = child;
             }
         }
+        return id;
+    }
 
-       private:
-        void insert(std::unique_ptr<Node<T>> &node, T const &data) {
-            if (node == nullptr) {
-                node = std::make_unique<Node<T>>();
-                node.data = &data;
-            } else {
-                auto loc = get_region(node.data->pos, data.pos);
-                switch (loc) {
-                    case region::flu:
-                        insert(node.flu, data);
-                        break;
-                    case region::fld:
-                        insert(node.fld, data);
-                        break;
-                    case region::fru:
-                        insert(node.fru, data);
-                        break;
-                    case region::frd:
-                        insert(node.frd, data);
-                        break;
-                    case region::blu:
-                        insert(node.blu, data);
-                        break;
-                    case region::bld:
-                        insert(node.bld, data);
-                        break;
-                    case region::bru:
-                        insert(node.bru, data);
-                        break;
-                    case region::brd:
-                        insert(node.brd, data);
-                        break;
-                }
+    template <typename T, size_t LeafCapacity>
+    template <typename VectorArray, typename ScalarArray>
+    void Octree<T, LeafCapacity>::refit(const VectorArray &pos, const ScalarArray &mass) {
+        // children always have larger indices than their parents
+        for (size_t k = nodes_.size(); k-- > 0;) {
+            calc_moments(nodes_[k], pos, mass);
+        }
+    }
+
+    template <typename T, size_t LeafCapacity>
+    template <typename VectorArray, typename ScalarArray>
+    void Octree<T, LeafCapacity>::calc_moments(Node<T> &node, const VectorArray &pos, const ScalarArray &mass) {
+        auto add_quad = [](std::array<T, 6> &q, T m, Vector const &d) {
+            T d2 = norm2(d);
+            q[0] += m * (3 * d.x * d.x - d2);
+            q[1] += m * 3 * d.x * d.y;
+            q[2] += m * 3 * d.x * d.z;
+            q[3] += m * (3 * d.y * d.y - d2);
+            q[4] += m * 3 * d.y * d.z;
+            q[5] += m * (3 * d.z * d.z - d2);
+        };
+
+        node.mass = 0;
+        node.com = Vector{0, 0, 0};
+        node.quad.fill(0);
+        node.b_max = 0;
+
+        if (node.leaf) {
+            for (size_t k = node.begin; k < node.end; ++k) {
+                size_t i = order_[k];
+                T m = static_cast<T>(mass[i]);
+                node.mass += m;
+                node.com += Vector{static_cast<T>(pos[i].x), static_cast<T>(pos[i].y), static_cast<T>(pos[i].z)} * m;
+            }
+            if (node.mass > 0) node.com /= node.mass;
+
+            for (size_t k = node.begin; k < node.end; ++k) {
+                size_t i = order_[k];
+                Vector d =
+                    Vector{static_cast<T>(pos[i].x), static_cast<T>(pos[i].y), static_cast<T>(pos[i].z)} - node.com;
+                add_quad(node.quad, static_cast<T>(mass[i]), d);
+                node.b_max = std::max(node.b_max, norm(d));
+            }
+        } else {
+            for (int c : node.child) {
+                if (c < 0) continue;
+                auto const &sub = nodes_[c];
+                node.mass += sub.mass;
+                node.com += sub.com * sub.mass;
+            }
+            if (node.mass > 0) node.com /= node.mass;
+
+            for (int c : node.child) {
+                if (c < 0) continue;
+                auto const &sub = nodes_[c];
+                Vector d = sub.com - node.com;
+                for (size_t q = 0; q < 6; ++q) node.quad[q] += sub.quad[q];
+                add_quad(node.quad, sub.mass, d);
+                node.b_max = std::max(node.b_max, norm(d) + sub.b_max);
             }
         }
+    }
+
+    template <typename T, size_t LeafCapacity>
+    template <typename VectorArray, typename ScalarArray>
+    auto Octree<T, LeafCapacity>::acc(size_t i, const VectorArray &pos, const ScalarArray &mass, T theta) const -> Vector {
+        Vector const x{static_cast<T>(pos[i].x), static_cast<T>(pos[i].y), static_cast<T>(pos[i].z)};
+        Vector a{0, 0, 0};
+        if (nodes_.empty()) return a;
+
+        std::array<int, 8 * max_depth> stack;
+        size_t top = 0;
+        stack[top++] = 0;
 
-        template <typename Vector>
-        region get_region(Vector const &loc, Vector const &p) {
-            if (p.x > loc.x) {
-                if (p.y > loc.y) {
-                    if (p.z > loc.z) {
-                        return region::fru;
-                    } else {
-                        return region::frd;
-                    }
-                } else {
-                    if (p.z > loc.z) {
-                        return region::flu;
-                    } else {
-                        return region::fld;
-                    }
+        while (top > 0) {
+            auto const &node = nodes_[stack[--top]];
+            Vector dr = x - node.com;
+            T r2 = norm2(dr);
+
+            if (node.b_max * node.b_max < theta * theta * r2) {
+                T r = std::sqrt(r2);
+                T rr2 = 1 / r2;
+                T rr3 = rr2 / r;
+                T rr5 = rr3 * rr2;
+                auto const &q = node.quad;
+                Vector q_dr{q[0] * dr.x + q[1] * dr.y + q[2] * dr.z, q[1] * dr.x + q[3] * dr.y + q[4] * dr.z,
+                            q[2] * dr.x + q[4] * dr.y + q[5] * dr.z};
+                T dr_q_dr = dot(dr, q_dr);
+                a += q_dr * rr5 - dr * (node.mass * rr3 + 2.5 * dr_q_dr * rr5 * rr2);
+            } else if (node.leaf) {
+                for (size_t k = node.begin; k < node.end; ++k) {
+                    size_t j = order_[k];
+                    if (j == i) continue;
+                    Vector d =
+                        Vector{static_cast<T>(pos[j].x), static_cast<T>(pos[j].y), static_cast<T>(pos[j].z)} - x;
+                    T r = norm(d);
+                    a += d * (static_cast<T>(mass[j]) / (r * r * r));
                 }
             } else {
-                if (p.y > loc.y) {
-                    if (p.z > loc.z) {
-                        return region::bru;
-                    } else {
-                        return region::brd;
-                    }
-                } else {
-                    if (p.z > loc.z) {
-                        return region::blu;
-                    } else {
-                        return region::bld;
-                    }
+                for (int c : node.child) {
+                    if (c >= 0) stack[top++] = c;
                 }
             }
         }
-
-        std::unique_ptr<Node<T>> root{nullptr};
-    };
+        return a;
+    }
 }  // namespace hub::octree
@@ -25,6 +25,7 @@ License
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 #include "../core-computation.hpp"
 #include "../interaction/interaction.hpp"
@@ -40,9 +41,15 @@ namespace hub::system {
         Class Regularization Declaration
     \*---------------------------------------------------------------------------*/
     /**
+     * @brief Time transformation of the regularized systems.
      *
-     * @tparam
-     * @tparam Type
+     * The regularization function Omega is the newtonian binding energy -U, so its gradient dOmega/dr_i is m_i times
+     * the newtonian acceleration. Both come out of the force pass of the owner system: the gradient is the
+     * `newtonian_acc()` of its `InteractionData` and Omega is the potential energy cached by the same pass (see
+     * `potential_cached()`), so a kick walks the particle pairs once.
+     *
+     * @tparam TypeSystem The type system in spaceHub(hub::Types).
+     * @tparam Type Regularization type.
      */
     template <typename TypeSystem, ReguType Type = ReguType::LogH>
     class Regularization {
@@ -127,6 +134,40 @@ namespace hub::system {
 
         Scalar step_scale() const { return regu_.regu_function(*this); };
 
+        /**
+         * @brief Is the potential energy evaluated as a by-product of the last force pass still valid, i.e. the
+         * positions have not been advanced since?
+         */
+        [[nodiscard]] bool potential_cached() const { return accels_.potential_valid(); };
+
+        /**
+         * @brief Potential energy evaluated as a by-product of the last force pass (see `potential_cached()`).
+         */
+        [[nodiscard]] Scalar cached_potential() const { return accels_.potential(); };
+
+        /**
+         * @brief Compact pair list rebuilt every step(see `force::CompactPairs`).
+         */
+        SPACEHUB_READ_ACCESSOR(force::CompactPairs, compact_pairs, accels_.compact_pairs());
+
+        /**
+         * @brief Writable positions and masses. Taking them clears the cached potential energy(see
+         * `potential_cached()`).
+         */
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, StateVectorArray, pos, accels_.potential_valid() = false);
+
+        SPACEHUB_INVALIDATING_ARRAY_ACCESSOR(Particles, ScalarArray, mass, accels_.potential_valid() = false);
+
+        /**
+         * @brief Key of the current storage layout(see `force::LayoutKey`).
+         */
+        [[nodiscard]] size_t layout_key() const { return accels_.layout_key().id(); };
+
+        /**
+         * @brief Relative tolerance of the run passed to the forces(see `force::InteractionData::rtol`).
+         */
+        SPACEHUB_STD_ACCESSOR(double, force_rtol, accels_.rtol());
+
         template <typename GenVectorArray>
         void evaluate_acc(GenVectorArray &acceleration) const;
 
@@ -252,6 +293,7 @@ namespace hub::system {
     void RegularizedSystem<Particles, Interactions, RegType>::drift(Scalar step_size) {
         Scalar phy_time = regu_.eval_pos_phy_time(*this, step_size);
         calc::array_advance(this->pos(), this->vel(), phy_time);
+        accels_.potential_valid() = false;
         this->time() += phy_time;
         sync_time_increment(phy_time);
         sync_pos_increment(this->vel(), phy_time);
@@ -259,11 +301,11 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::kick(Scalar step_size) {
+        eval_vel_indep_acc();
+
         Scalar phy_time = regu_.eval_vel_phy_time(*this, step_size);
         Scalar half_time = 0.5 * phy_time;
 
-        eval_vel_indep_acc();
-
         if constexpr (Interactions::ext_vel_dep) {
             kick_real_vel(half_time);
             kick_pseu_vel(phy_time);
@@ -284,6 +326,9 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::pre_iter_process() {
+        if constexpr (Interactions::compact_pairs) {
+            accels_.compact_pairs().rebuild(*this);
+        }
         if constexpr (Interactions::ext_vel_dep) {
             aux_vel_ = this->vel();
         }
@@ -296,7 +341,7 @@ namespace hub::system {
         y.reserve(this->number() * 3 * (2 + static_cast<size_t>(Interactions::ext_vel_dep)) + 3);
         y.emplace_back(this->time());
 
-        add_coords_to(y, this->pos());
+        add_coords_to(y, std::as_const(*this).pos());
         add_coords_to(y, this->vel());
         if constexpr (Interactions::ext_vel_dep) {
             add_coords_to(y, aux_vel_);
@@ -312,13 +357,13 @@ namespace hub::system {
         dy_dh.clear();
         dy_dh.reserve(this->number() * 3 * (2 + static_cast<size_t>(Interactions::ext_vel_dep)) + 3);
 
+        accels_.eval_newtonian_acc(*this, accels_.newtonian_acc());
+
         Scalar pos_regu = regu_.eval_pos_phy_time(*this, 1);
         Scalar vel_regu = regu_.eval_vel_phy_time(*this, 1);
 
         dy_dh.emplace_back(pos_regu);
 
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
-
         if constexpr (Interactions::ext_vel_indep || Interactions::ext_vel_dep) {
             Interactions::eval_extra_acc(*this, accels_.acc());
             calc::array_add(accels_.acc(), accels_.acc(), accels_.newtonian_acc());
@@ -351,6 +396,7 @@ namespace hub::system {
             auto vel_end = begin + auxi_vel_offset();
             load_to_coords(pos_begin, pos_end, this->pos());
             load_to_coords(vel_begin, vel_end, this->vel());
+            accels_.potential_valid() = false;
             if constexpr (Interactions::ext_vel_dep) {
                 auto aux_vel_begin = begin + auxi_vel_offset();
                 auto aux_vel_end = y.end();
@@ -416,7 +462,7 @@ namespace hub::system {
 
     template <CONCEPT_PARTICLES Particles, CONCEPT_INTERACTION Interactions, ReguType RegType>
     void RegularizedSystem<Particles, Interactions, RegType>::eval_vel_indep_acc() {
-        Interactions::eval_newtonian_acc(*this, accels_.newtonian_acc());
+        accels_.eval_newtonian_acc(*this, accels_.newtonian_acc());
 
         if constexpr (Interactions::ext_vel_indep) {
             Interactions::eval_extra_vel_indep_acc(*this, accels_.ext_vel_indep_acc());
@@ -431,7 +477,7 @@ namespace hub::system {
                                                                              VectorArray const &d_omega_dr)
         -> StateScalar {
         if constexpr (regu_type == ReguType::TTL) {
-            return calc::coord_contract_to_scalar(this->mass(), velocity, d_omega_dr);
+            return calc::coord_contract_to_scalar(std::as_const(*this).mass(), velocity, d_omega_dr);
         } else {
             return 0;
         }
@@ -442,7 +488,7 @@ namespace hub::system {
                                                                              VectorArray const &d_bindE_dr)
         -> StateScalar {
         if constexpr ((Interactions::ext_vel_indep || Interactions::ext_vel_dep) && regu_type == ReguType::LogH) {
-            return -calc::coord_contract_to_scalar(this->mass(), velocity, d_bindE_dr);
+            return -calc::coord_contract_to_scalar(std::as_const(*this).mass(), velocity, d_bindE_dr);
         } else {
             return 0;
         }
@@ -499,8 +545,9 @@ namespace hub::system {
     template <typename TypeSystem, ReguType Type>
     template <typename Particles>
     Regularization<TypeSystem, Type>::Regularization(Particles const &particles) {
-        omega_ = capital_omega(particles);
-        bindE_ = -calc::calc_total_energy(particles);
+        auto potential = calc::calc_potential_energy(particles);
+        omega_ = -potential;
+        bindE_ = -(potential + calc::calc_kinetic_energy(particles));
         if constexpr (Type != ReguType::None) {
             scale_ = omega_;
         }
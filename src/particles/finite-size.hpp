@@ -151,6 +151,13 @@ namespace hub::particles {
 
         void clear();
 
+        /**
+         * @brief Move the particle at index order[k] to index k, for all particle properties including `idn`.
+         *
+         * @param[in] order Permutation of [0, number()).
+         */
+        void reorder(std::vector<size_t> const &order);
+
         std::string column_names() const;
 
         std::vector<Particle> to_AoS() const;
@@ -221,6 +228,11 @@ namespace hub::particles {
         active_num_ = 0;
     }
 
+    template <typename TypeSystem>
+    void SizeParticles<TypeSystem>::reorder(std::vector<size_t> const &order) {
+        hub::permute_all(order, pos_, vel_, mass_, radius_, idn_);
+    }
+
     template <typename TypeSystem>
     void SizeParticles<TypeSystem>::resize(size_t new_sz) {
         hub::resize_all(new_sz, pos_, vel_, mass_, radius_, idn_);
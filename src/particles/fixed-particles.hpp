@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file fixed-particles.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include "../IO.hpp"
+#include "../spacehub-concepts.hpp"
+#include "../type-class.hpp"
+#include "point-particles.hpp"
+
+namespace hub::particles {
+    /*---------------------------------------------------------------------------*\
+        Class FixedParticles Declaration
+    \*---------------------------------------------------------------------------*/
+    namespace details {
+        /**
+         * @brief Type system of `TypeSystem` with the per particle arrays replaced by arrays of N elements.
+         */
+        template <typename TypeSystem, size_t N>
+        struct FixedTypes : TypeSystem {
+            using ScalarArray = FixedArray<typename TypeSystem::Scalar, N>;
+
+            using IdxArray = FixedArray<size_t, N>;
+
+            using VectorArray = FixedArray<typename TypeSystem::Vector, N>;
+
+            using StateVectorArray = FixedArray<typename TypeSystem::StateVector, N>;
+        };
+    }  // namespace details
+
+    /**
+     * @brief Structure of Array point particle group with the particle number fixed at compile time.
+     *
+     * The particle arrays are `hub::FixedArray`s backed by `std::array`. Every array type of the particle system built
+     * on top of it (accelerations, chain coordinates, chain index) inherits the fixed size, so the forces, the chain
+     * transforms and the scalar array conversions unroll their loops over the particles completely (up to
+     * `hub::max_unrolled_size` particles). Meant for the few-body scatterings that are integrated billions of times
+     * per ensemble.
+     *
+     * Use it with the methods through `FixedN<N>::template type`, e.g.
+     * `methods::DefaultMethod<force::Interactions<force::NewtonianGrav>, particles::FixedN<3>::template type>`.
+     *
+     * @tparam TypeSystem The type system in spaceHub(hub::Types).
+     * @tparam N The particle number.
+     */
+    template <typename TypeSystem, size_t N>
+    class FixedParticles {
+       public:
+        // Type members
+        using FixedTypes = details::FixedTypes<TypeSystem, N>;
+
+        SPACEHUB_USING_TYPE_SYSTEM_OF(FixedTypes);
+
+        /**
+         * @brief Embedded Particle type.
+         */
+        using Particle = PointParticle<Vector>;
+
+        // Constructors
+        SPACEHUB_MAKE_CONSTRUCTORS(FixedParticles, default, default, default, default, default);
+
+        /**
+         * @brief Construct a new Fixed Particles object
+         *
+         * @tparam STL
+         * @param t
+         * @param particle_set Exactly N particles.
+         */
+        template <CONCEPT_PARTICLE_CONTAINER STL>
+        FixedParticles(Scalar t, STL const &particle_set);
+
+        // Public methods
+        SPACEHUB_STD_ACCESSOR(StateScalar, time, time_);
+
+        SPACEHUB_ARRAY_ACCESSOR(ScalarArray, mass, mass_);
+
+        SPACEHUB_ARRAY_ACCESSOR(IdxArray, idn, idn_);
+
+        SPACEHUB_ARRAY_ACCESSOR(StateVectorArray, pos, pos_);
+
+        SPACEHUB_ARRAY_ACCESSOR(StateVectorArray, vel, vel_);
+
+        void resize(size_t new_sz);
+
+        void reserve(size_t new_cap);
+
+        [[nodiscard]] constexpr size_t number() const { return N; }
+
+        [[nodiscard]] constexpr size_t capacity() const { return N; }
+
+        std::string column_names() const;
+
+        std::vector<Particle> to_AoS() const;
+
+        template <typename U, size_t M>
+        friend std::ostream &operator<<(std::ostream &os, FixedParticles<U, M> const &ps);
+
+       private:
+        // Private members
+        StateVectorArray pos_;
+
+        StateVectorArray vel_;
+
+        ScalarArray mass_;
+
+        IdxArray idn_;
+
+        StateScalar time_{0.0};
+    };
+
+    /**
+     * @brief Adaptor of `FixedParticles` to the `template <typename> typename particle` parameter of the methods.
+     *
+     * @tparam N The particle number.
+     */
+    template <size_t N>
+    struct FixedN {
+        template <typename TypeSystem>
+        using type = FixedParticles<TypeSystem, N>;
+    };
+}  // namespace hub::particles
+
+namespace hub::particles {
+    /*---------------------------------------------------------------------------*\
+        Class FixedParticles Implementation
+    \*---------------------------------------------------------------------------*/
+    template <typename TypeSystem, size_t N>
+    template <CONCEPT_PARTICLE_CONTAINER STL>
+    FixedParticles<TypeSystem, N>::FixedParticles(Scalar t, const STL &particle_set) {
+        if (particle_set.size() != N) {
+            spacehub_abort("The particle number ", particle_set.size(), " does not match the fixed number ", N, "!");
+        }
+        size_t id = 0;
+        for (auto &p : particle_set) {
+            pos_[id] = p.pos;
+            vel_[id] = p.vel;
+            mass_[id] = p.mass;
+            idn_[id] = id;
+            id++;
+        }
+        time_ = t;
+    }
+
+    template <typename TypeSystem, size_t N>
+    void FixedParticles<TypeSystem, N>::resize(size_t new_sz) {
+        if (new_sz != N) {
+            spacehub_abort("Cannot resize a fixed particle group!");
+        }
+    }
+
+    template <typename TypeSystem, size_t N>
+    void FixedParticles<TypeSystem, N>::reserve(size_t new_cap) {
+        if (new_cap > N) {
+            spacehub_abort("Cannot reserve beyond the fixed particle number!");
+        }
+    }
+
+    template <typename TypeSystem, size_t N>
+    std::string FixedParticles<TypeSystem, N>::column_names() const {
+        return "time,id,mass,px,py,pz,vx,vy,vz";
+    }
+
+    template <typename TypeSystem, size_t N>
+    auto FixedParticles<TypeSystem, N>::to_AoS() const -> std::vector<Particle> {
+        std::vector<Particle> ptc;
+        ptc.reserve(N);
+        for (size_t i = 0; i < N; ++i) {
+            ptc.emplace_back(mass_[i], pos_[i], vel_[i]);
+        }
+        return ptc;
+    }
+
+    template <typename TypeSystem, size_t N>
+    std::ostream &operator<<(std::ostream &os, FixedParticles<TypeSystem, N> const &ps) {
+        for (size_t i = 0; i < N; ++i) {
+            hub::print(os, ps.time(), ',', ps.idn(i), ',', ps.mass(i), ',', ps.pos(i), ',', ps.vel(i), '\n');
+        }
+        return os;
+    }
+}  // namespace hub::particles
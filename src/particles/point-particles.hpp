@@ -148,6 +148,13 @@ namespace hub::particles {
 
         void clear();
 
+        /**
+         * @brief Move the particle at index order[k] to index k, for all particle properties including `idn`.
+         *
+         * @param[in] order Permutation of [0, number()).
+         */
+        void reorder(std::vector<size_t> const &order);
+
         std::string column_names() const;
 
         std::vector<Particle> to_AoS() const;
@@ -235,6 +242,11 @@ namespace hub::particles {
         active_num_ = 0;
     }
 
+    template <typename TypeSystem>
+    void PointParticles<TypeSystem>::reorder(std::vector<size_t> const &order) {
+        hub::permute_all(order, pos_, vel_, mass_, idn_);
+    }
+
     template <typename TypeSystem>
     void PointParticles<TypeSystem>::emplace_back(typename PointParticles<TypeSystem>::Particle const &new_particle) {
         pos_.emplace_back(new_particle.pos);
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+/**
+ * @file space-filling-curve.hpp
+ *
+ * Header file.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hub::particles {
+
+    /**
+     * @brief Space filling curves that order the particle storage.
+     */
+    enum class SpaceFillingCurve { None, Morton, Hilbert };
+
+    /*---------------------------------------------------------------------------*\
+         Class SpaceFillingOrder Declaration
+    \*---------------------------------------------------------------------------*/
+    /**
+     * @brief Configuration and keys of the periodic space filling curve reordering of the particle storage.
+     *
+     * Particles that are close in space are moved close in memory, so the pair, tree and collision loops at large N
+     * walk the arrays with far fewer cache misses. The reordering permutes every per-particle array together,
+     * including `idn`, which is the stable identity of a particle across reorders. The systems keep the curve order
+     * only during a step, so the callbacks and the output see the particles in the order they were given. Off by
+     * default.
+     */
+    struct SpaceFillingOrder {
+        /**
+         * @brief Curve used to order the particles. `None` disables the reordering.
+         */
+        inline static SpaceFillingCurve curve{SpaceFillingCurve::None};
+
+        /**
+         * @brief Number of steps between two reorders.
+         */
+        inline static size_t interval{64};
+
+        /**
+         * @brief Particle systems with less particles than this are never reordered.
+         */
+        inline static size_t min_number{256};
+
+        /**
+         * @brief Number of bits per dimension of the quantized positions, 3*bits fit into a 64 bits key.
+         */
+        constexpr static unsigned bits{21};
+
+        /**
+         * @brief Storage order of the particles along the curve.
+         *
+         * @tparam VectorArray 3D vector array type.
+         * @param[in] pos Positions of the particles.
+         * @param[in] num Number of particles.
+         * @param[in] crv Curve to sort along.
+         * @param[out] order order[k] is the current index of the particle that goes to slot k.
+         */
+        template <typename VectorArray>
+        static void sort(VectorArray const &pos, size_t num, SpaceFillingCurve crv, std::vector<size_t> &order);
+
+        /**
+         * @brief Key of the quantized position (x, y, z) with the bits of x, y and z interleaved.
+         */
+        static uint64_t morton_key(uint32_t x, uint32_t y, uint32_t z);
+
+        /**
+         * @brief Key of the quantized position (x, y, z) along the Hilbert curve(Skilling 2004).
+         */
+        static uint64_t hilbert_key(uint32_t x, uint32_t y, uint32_t z);
+
+       private:
+        static uint64_t spread_bits(uint64_t v);
+    };
+
+    /*---------------------------------------------------------------------------*\
+         Class SpaceFillingOrder Implementation
+    \*---------------------------------------------------------------------------*/
+    inline uint64_t SpaceFillingOrder::spread_bits(uint64_t v) {
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffff;
+        v = (v | v << 16) & 0x1f0000ff0000ff;
+        v = (v | v << 8) & 0x100f00f00f00f00f;
+        v = (v | v << 4) & 0x10c30c30c30c30c3;
+        v = (v | v << 2) & 0x1249249249249249;
+        return v;
+    }
+
+    inline uint64_t SpaceFillingOrder::morton_key(uint32_t x, uint32_t y, uint32_t z) {
+        return spread_bits(x) << 2 | spread_bits(y) << 1 | spread_bits(z);
+    }
+
+    inline uint64_t SpaceFillingOrder::hilbert_key(uint32_t x, uint32_t y, uint32_t z) {
+        uint32_t X[3] = {x, y, z};
+        constexpr uint32_t M = 1u << (bits - 1);
+        // inverse undo
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            uint32_t P = Q - 1;
+            for (auto &Xi : X) {
+                if (Xi & Q) {
+                    X[0] ^= P;
+                } else {
+                    uint32_t t = (X[0] ^ Xi) & P;
+                    X[0] ^= t;
+                    Xi ^= t;
+                }
+            }
+        }
+        // gray encode
+        X[1] ^= X[0];
+        X[2] ^= X[1];
+        uint32_t t = 0;
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            if (X[2] & Q) t ^= Q - 1;
+        }
+        return morton_key(X[0] ^ t, X[1] ^ t, X[2] ^ t);
+    }
+
+    template <typename VectorArray>
+    void SpaceFillingOrder::sort(const VectorArray &pos, size_t num, SpaceFillingCurve crv, std::vector<size_t> &order) {
+        order.resize(num);
+        if (num == 0) return;
+
+        double lo[3] = {static_cast<double>(pos[0].x), static_cast<double>(pos[0].y), static_cast<double>(pos[0].z)};
+        double hi[3] = {lo[0], lo[1], lo[2]};
+        for (size_t i = 1; i < num; ++i) {
+            double r[3] = {static_cast<double>(pos[i].x), static_cast<double>(pos[i].y), static_cast<double>(pos[i].z)};
+            for (size_t d = 0; d < 3; ++d) {
+                lo[d] = std::min(lo[d], r[d]);
+                hi[d] = std::max(hi[d], r[d]);
+            }
+        }
+        double span = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+        double scale = span > 0 ? static_cast<double>((1u << bits) - 1) / span : 0;
+
+        std::vector<std::pair<uint64_t, size_t>> keys(num);
+        for (size_t i = 0; i < num; ++i) {
+            auto quantize = [&](auto x, size_t d) {
+                return static_cast<uint32_t>((static_cast<double>(x) - lo[d]) * scale);
+            };
+            uint32_t x = quantize(pos[i].x, 0), y = quantize(pos[i].y, 1), z = quantize(pos[i].z, 2);
+            keys[i] = {crv == SpaceFillingCurve::Hilbert ? hilbert_key(x, y, z) : morton_key(x, y, z), i};
+        }
+        std::sort(keys.begin(), keys.end());
+        for (size_t k = 0; k < num; ++k) {
+            order[k] = keys[k].second;
+        }
+    }
+}  // namespace hub::particles
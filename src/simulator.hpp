@@ -24,6 +24,8 @@ License
  */
 #pragma once
 #include <functional>
+#include <optional>
+#include <vector>
 
 #include "IO.hpp"
 #include "core-computation.hpp"
@@ -185,6 +187,46 @@ namespace hub {
          */
         void add_stop_condition(Scalar end);
 
+        /**
+         * Register a callable object(function pointer, functor, lambda,etc...) to the dense output points, `num`
+         * equally spaced times from `start` to `end`(both included).
+         *
+         * With an ode iterator that provides dense output(see `BulirschStoer::dense_output`), the callable is called
+         * with a copy of the particle system interpolated to each point exactly, without shortening the steps. With
+         * other iterators it is called with the particle system at the first step end at or after each point.
+         *
+         * @tparam Func Callable type that is convertible to member type Callback.
+         * @tparam Args Type of the binding arguments.
+         * @param[in] start Time of the first point.
+         * @param[in] end Time of the last point.
+         * @param[in] num Number of the points.
+         * @param[in] func Callable object.
+         * @param[in] args Binding arguments. If func accepts more than one arguments, you can bind the rest arguments
+         * here.
+         */
+        template <typename Func, typename... Args>
+        void add_dense_operation(Scalar start, Scalar end, size_t num, Func func, Args &&...args);
+
+        /**
+         * Call the dense operation functions registered to the `i`th dense output point.
+         *
+         * @param[in] i Index of the point in `dense_times()`.
+         * @param[in,out] particle_sys The particle system at the point.
+         * @param[in] step_size The current step size.
+         */
+        void dense_operations(size_t i, ParticleSys &particle_sys, Scalar step_size) const;
+
+        /**
+         * Times of all dense output points, in increasing order.
+         */
+        std::vector<Scalar> const &dense_times() const { return dense_times_; }
+
+        /**
+         * Check if any dense operation is set.
+         * @return boolean
+         */
+        bool is_dense_operation_set() const { return dense_times_.size() > 0; }
+
         /**
          * Check if the integration duration time is set.
          * @return boolean
@@ -207,6 +249,13 @@ namespace hub {
 
         std::vector<StopCall> stop_cond_;
 
+        std::vector<Callback> dense_opts_;
+
+        std::vector<Scalar> dense_times_;
+
+        /** @brief Index of the dense operation of each point in `dense_times_`*/
+        std::vector<size_t> dense_opt_index_;
+
         bool is_end_time_set_{false};
 
         CREATE_METHOD_CHECK(operation);
@@ -275,6 +324,12 @@ namespace hub {
         // Private methods
         inline void advance_one_step();
 
+        /**
+         * Call the dense operations of the points from `next` up to `time`, interpolated to each point if the ode
+         * iterator provides dense output. Return the index of the first point after `time`.
+         */
+        size_t dense_operations(RunArgs const &run_args, size_t next, Scalar time);
+
         // Private members
         /** @brief Macro step size for ODE iterator*/
         Scalar step_size_{0.0};
@@ -285,9 +340,22 @@ namespace hub {
         /** @brief ODE Iterator*/
         OdeIterator iterator_;
 
+        /** @brief Particle system interpolated to the dense output points*/
+        std::optional<ParticleSys> dense_particles_;
+
         CREATE_METHOD_CHECK(set_atol);
 
         CREATE_METHOD_CHECK(set_rtol);
+
+        CREATE_METHOD_CHECK(force_rtol);
+
+        CREATE_METHOD_CHECK(set_dense_output);
+
+        CREATE_METHOD_CHECK(dense_output);
+
+        CREATE_METHOD_CHECK(reorder_delta);
+
+        CREATE_METHOD_CHECK(permute);
     };
 
     /*---------------------------------------------------------------------------*\
@@ -353,6 +421,38 @@ namespace hub {
         is_end_time_set_ = true;
     }
 
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    template <typename Func, typename... Args>
+    void RunArgs<ParticleSys>::add_dense_operation(Scalar start, Scalar end, size_t num, Func func, Args &&...args) {
+        size_t opt = dense_opts_.size();
+        dense_opts_.emplace_back(
+            std::bind(func, std::placeholders::_1, std::placeholders::_2, std::forward<Args>(args)...));
+
+        std::vector<std::pair<Scalar, size_t>> points;
+        points.reserve(dense_times_.size() + num);
+        for (size_t i = 0; i < dense_times_.size(); ++i) {
+            points.emplace_back(dense_times_[i], dense_opt_index_[i]);
+        }
+        for (size_t i = 0; i < num; ++i) {
+            Scalar t = num > 1 ? start + (end - start) * static_cast<Scalar>(i) / static_cast<Scalar>(num - 1) : start;
+            points.emplace_back(t, opt);
+        }
+        std::stable_sort(points.begin(), points.end(),
+                         [](auto const &a, auto const &b) { return a.first < b.first; });
+
+        dense_times_.clear();
+        dense_opt_index_.clear();
+        for (auto const &[t, i] : points) {
+            dense_times_.push_back(t);
+            dense_opt_index_.push_back(i);
+        }
+    }
+
+    template <CONCEPT_PARTICLE_SYSTEM ParticleSys>
+    void RunArgs<ParticleSys>::dense_operations(size_t i, ParticleSys &particle_system, Scalar step_size) const {
+        dense_opts_[dense_opt_index_[i]](particle_system, step_size);
+    }
+
     /*---------------------------------------------------------------------------*\
         Class Simulator Implementation
     \*---------------------------------------------------------------------------*/
@@ -404,15 +504,31 @@ namespace hub {
             iterator_.set_rtol(run_args.rtol);
         }
 
+        if constexpr (HAS_METHOD(ParticleSys, force_rtol)) {
+            particles_.force_rtol() = static_cast<double>(run_args.rtol);
+        }
+
         run_args.start_operations(particles_, step_size_);
 
+        auto const &dense_times = run_args.dense_times();
+        size_t dense_next = 0;
+
+        if constexpr (HAS_METHOD(OdeIterator, set_dense_output, bool)) {
+            iterator_.set_dense_output(run_args.is_dense_operation_set());
+        }
+
+        for (; dense_next < dense_times.size() && dense_times[dense_next] <= particles_.time(); ++dense_next) {
+            run_args.dense_operations(dense_next, particles_, step_size_);
+        }
+
         // Dipto's changes here
+        using std::abs;
 
-        for (; std::abs((particles_.time() - end_time) / end_time) > time_rtol_ &&
+        for (; abs((particles_.time() - end_time) / end_time) > time_rtol_ &&
                !run_args.check_stops(particles_, step_size_);) {
             Scalar rest_step = (end_time - particles_.time()) * particles_.step_scale();
 
-            if (std::abs(step_size_) <= std::abs(rest_step)) [[likely]] {
+            if (abs(step_size_) <= abs(rest_step)) [[likely]] {
                 run_args.operations(particles_, step_size_);
                 advance_one_step();
 
@@ -421,14 +537,50 @@ namespace hub {
                 run_args.operations(particles_, step_size_);
                 advance_one_step();
             }
+
+            if (dense_next < dense_times.size() && dense_times[dense_next] <= particles_.time()) [[unlikely]] {
+                dense_next = dense_operations(run_args, dense_next, particles_.time());
+            }
+        }
+
+        if (dense_next < dense_times.size() && abs((particles_.time() - end_time) / end_time) <= time_rtol_) {
+            dense_next = dense_operations(run_args, dense_next, end_time);
         }
+
         run_args.operations(particles_, step_size_);
         run_args.stop_operations(particles_, step_size_);
     }
 
+    template <typename ParticleSys, typename OdeIterator>
+    size_t Simulator<ParticleSys, OdeIterator>::dense_operations(RunArgs const &run_args, size_t next, Scalar time) {
+        auto const &dense_times = run_args.dense_times();
+        for (; next < dense_times.size() && dense_times[next] <= time; ++next) {
+            if constexpr (HAS_METHOD(OdeIterator, dense_output, ParticleSys &, Scalar)) {
+                if (iterator_.dense_output_ready()) {
+                    if (!dense_particles_) {
+                        dense_particles_.emplace(particles_);
+                    }
+                    iterator_.dense_output(*dense_particles_, dense_times[next]);
+                    // the saved system is the one of the step, bring it back to the storage order between the steps
+                    dense_particles_->post_iter_process();
+                    run_args.dense_operations(next, *dense_particles_, step_size_);
+                    continue;
+                }
+            }
+            run_args.dense_operations(next, particles_, step_size_);
+        }
+        return next;
+    }
+
     template <typename ParticleSys, typename OdeIterator>
     inline void Simulator<ParticleSys, OdeIterator>::advance_one_step() {
         particles_.pre_iter_process();
+        if constexpr (HAS_METHOD(ParticleSys, reorder_delta) &&
+                      HAS_METHOD(OdeIterator, permute, ParticleSys const &, std::vector<size_t> const &)) {
+            if (!particles_.reorder_delta().empty()) {
+                iterator_.permute(particles_, particles_.reorder_delta());
+            }
+        }
         step_size_ = iterator_.iterate(particles_, step_size_);
         particles_.post_iter_process();
     }
@@ -49,13 +49,18 @@ License
 
 #include "args-callback/callbacks.hpp"
 #include "args-callback/collision.hpp"
+#include "cpu-dispatch.hpp"
+#include "double-double.hpp"
 #include "integrator/Gauss-Radau.hpp"
 #include "integrator/symplectic/symplectic-integrator.hpp"
 #include "interaction/alpha-disk.hpp"
+#include "interaction/fmm-grav.hpp"
 #include "interaction/magneto-disk.hpp"
+#include "interaction/mixed-newtonian.hpp"
 #include "interaction/newtonian.hpp"
 #include "interaction/post-newtonian.hpp"
 #include "interaction/tidal.hpp"
+#include "interaction/tree-grav.hpp"
 #include "kahan-number.hpp"
 #include "macros.hpp"
 #include "multi-thread/multi-thread.hpp"
@@ -75,8 +80,10 @@ License
 #include "particle-system/chain-system.hpp"
 #include "particle-system/regu-system.hpp"
 #include "particles/drag-particles.hpp"
+#include "particles/fixed-particles.hpp"
 #include "particles/finite-size.hpp"
 #include "particles/point-particles.hpp"
+#include "particles/space-filling-curve.hpp"
 #include "particles/tide-particles.hpp"
 #include "scattering/cross-section.hpp"
 #include "scattering/hierarchical.hpp"
@@ -121,6 +128,7 @@ namespace hub {
             using extended_type = Types<long double, Vec3>;
             using precise_type = Types<double_k, Vec3>;
             using extended_precise_type = Types<long_double_k, Vec3>;
+            using double_double_type = Types<dd_real, Vec3>;
 #ifdef MPFR_VERSION_MAJOR
             using any_bits_type = Types<mpfr::mpreal, Vec3>;  // lazy vec3 will crash due to mpreal implementation.
             using precise_any_bits_type = Types<mpreal_k, Vec3>;
@@ -135,12 +143,16 @@ namespace hub {
             using adaptive_step_ctrl_ext = PIDController<extended_type>;
             using const_step_ctrl_ext = ConstStepController<extended_type>;
 
+            using worst_offender_err_dd = ode::WorstOffender<double_double_type>;
+            using adaptive_step_ctrl_dd = PIDController<double_double_type>;
+
             using const_sym2 = ConstOdeIterator<Symplectic2nd<normal_type>>;
             using const_sym4 = ConstOdeIterator<Symplectic4th<normal_type>>;
             using const_sym6 = ConstOdeIterator<Symplectic6th<normal_type>>;
             using const_sym8 = ConstOdeIterator<Symplectic8th<normal_type>>;
             using const_sym10 = ConstOdeIterator<Symplectic10th<normal_type>>;
             using const_Radau = ConstOdeIterator<GaussRadau<normal_type>>;
+            using const_Radau2nd = ConstOdeIterator<GaussRadau2nd<normal_type>>;
 
             using const_sym2_ext = ConstOdeIterator<Symplectic2nd<extended_type>>;
             using const_sym4_ext = ConstOdeIterator<Symplectic4th<extended_type>>;
@@ -148,6 +160,7 @@ namespace hub {
             using const_sym8_ext = ConstOdeIterator<Symplectic8th<extended_type>>;
             using const_sym10_ext = ConstOdeIterator<Symplectic10th<extended_type>>;
             using const_Radau_ext = ConstOdeIterator<GaussRadau<extended_type>>;
+            using const_Radau2nd_ext = ConstOdeIterator<GaussRadau2nd<extended_type>>;
 
             using const_sym2_plus = ConstOdeIterator<Symplectic2nd<precise_type>>;
             using const_sym4_plus = ConstOdeIterator<Symplectic4th<precise_type>>;
@@ -155,6 +168,7 @@ namespace hub {
             using const_sym8_plus = ConstOdeIterator<Symplectic8th<precise_type>>;
             using const_sym10_plus = ConstOdeIterator<Symplectic10th<precise_type>>;
             using const_Radau_plus = ConstOdeIterator<GaussRadau<precise_type>>;
+            using const_Radau2nd_plus = ConstOdeIterator<GaussRadau2nd<precise_type>>;
 
             using const_sym2_extplus = ConstOdeIterator<Symplectic2nd<extended_precise_type>>;
             using const_sym4_extplus = ConstOdeIterator<Symplectic4th<extended_precise_type>>;
@@ -162,6 +176,15 @@ namespace hub {
             using const_sym8_extplus = ConstOdeIterator<Symplectic8th<extended_precise_type>>;
             using const_sym10_extplus = ConstOdeIterator<Symplectic10th<extended_precise_type>>;
             using const_Radau_extplus = ConstOdeIterator<GaussRadau<extended_precise_type>>;
+            using const_Radau2nd_extplus = ConstOdeIterator<GaussRadau2nd<extended_precise_type>>;
+
+            using const_sym2_dd = ConstOdeIterator<Symplectic2nd<double_double_type>>;
+            using const_sym4_dd = ConstOdeIterator<Symplectic4th<double_double_type>>;
+            using const_sym6_dd = ConstOdeIterator<Symplectic6th<double_double_type>>;
+            using const_sym8_dd = ConstOdeIterator<Symplectic8th<double_double_type>>;
+            using const_sym10_dd = ConstOdeIterator<Symplectic10th<double_double_type>>;
+            using const_Radau_dd = ConstOdeIterator<GaussRadau<double_double_type>>;
+            using const_Radau2nd_dd = ConstOdeIterator<GaussRadau2nd<double_double_type>>;
 
             using BS = BulirschStoer<LeapFrogDKD<normal_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym2 = SequentOdeIterator<Symplectic2nd<normal_type>, worst_offender_err, adaptive_step_ctrl>;
@@ -170,6 +193,7 @@ namespace hub {
             using sym8 = SequentOdeIterator<Symplectic8th<normal_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym10 = SequentOdeIterator<Symplectic10th<normal_type>, worst_offender_err, adaptive_step_ctrl>;
             using Radau = IAS15<GaussRadau<normal_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
+            using Radau2nd = IAS15<GaussRadau2nd<normal_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
 
             using BS_ext = BulirschStoer<LeapFrogDKD<extended_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
             using sym2_ext =
@@ -183,6 +207,8 @@ namespace hub {
             using sym10_ext =
                 SequentOdeIterator<Symplectic10th<extended_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
             using Radau_ext = IAS15<GaussRadau<extended_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
+            using Radau2nd_ext =
+                IAS15<GaussRadau2nd<extended_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
 
             using BS_plus = BulirschStoer<LeapFrogDKD<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym2_plus = SequentOdeIterator<Symplectic2nd<precise_type>, worst_offender_err, adaptive_step_ctrl>;
@@ -191,6 +217,7 @@ namespace hub {
             using sym8_plus = SequentOdeIterator<Symplectic8th<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using sym10_plus = SequentOdeIterator<Symplectic10th<precise_type>, worst_offender_err, adaptive_step_ctrl>;
             using Radau_plus = IAS15<GaussRadau<precise_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
+            using Radau2nd_plus = IAS15<GaussRadau2nd<precise_type>, MaxRatioError<normal_type>, adaptive_step_ctrl>;
 
             using BS_extplus =
                 BulirschStoer<LeapFrogDKD<extended_precise_type>, worst_offender_err_ext, adaptive_step_ctrl_ext>;
@@ -206,6 +233,25 @@ namespace hub {
                                                      adaptive_step_ctrl_ext>;
             using Radau_extplus =
                 IAS15<GaussRadau<extended_precise_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
+            using Radau2nd_extplus =
+                IAS15<GaussRadau2nd<extended_precise_type>, MaxRatioError<extended_type>, adaptive_step_ctrl_ext>;
+
+            using BS_dd =
+                BulirschStoer<LeapFrogDKD<double_double_type>, worst_offender_err_dd, adaptive_step_ctrl_dd, 12>;
+            using sym2_dd = SequentOdeIterator<Symplectic2nd<double_double_type>, worst_offender_err_dd,
+                                               adaptive_step_ctrl_dd>;
+            using sym4_dd = SequentOdeIterator<Symplectic4th<double_double_type>, worst_offender_err_dd,
+                                               adaptive_step_ctrl_dd>;
+            using sym6_dd = SequentOdeIterator<Symplectic6th<double_double_type>, worst_offender_err_dd,
+                                               adaptive_step_ctrl_dd>;
+            using sym8_dd = SequentOdeIterator<Symplectic8th<double_double_type>, worst_offender_err_dd,
+                                               adaptive_step_ctrl_dd>;
+            using sym10_dd = SequentOdeIterator<Symplectic10th<double_double_type>, worst_offender_err_dd,
+                                                adaptive_step_ctrl_dd>;
+            using Radau_dd =
+                IAS15<GaussRadau<double_double_type>, MaxRatioError<double_double_type>, adaptive_step_ctrl_dd>;
+            using Radau2nd_dd =
+                IAS15<GaussRadau2nd<double_double_type>, MaxRatioError<double_double_type>, adaptive_step_ctrl_dd>;
 #ifdef MPFR_VERSION_MAJOR
             using ABits = BulirschStoer<LeapFrogDKD<any_bits_type>, ode::WorstOffender<any_bits_type>,
                                         PIDController<any_bits_type>, 32>;
@@ -228,7 +274,11 @@ namespace hub {
                                                                                                                        \
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
     using NAME##_ExtPlus =                                                                                             \
-        Simulator<system::SYSTEM<particle<details::extended_precise_type>, interactions>, details::ITER##_extplus>;
+        Simulator<system::SYSTEM<particle<details::extended_precise_type>, interactions>, details::ITER##_extplus>;    \
+                                                                                                                       \
+    template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
+    using NAME##_DD =                                                                                                  \
+        Simulator<system::SYSTEM<particle<details::double_double_type>, interactions>, details::ITER##_dd>;
 
 #define DEFINE_CONST_STEP_INTEGRATION_METHOD(NAME, SYSTEM, ITER)                                                  \
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>     \
@@ -246,7 +296,12 @@ namespace hub {
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>     \
     using Const_##NAME##_ExtPlus =                                                                                \
         Simulator<particle_system::SYSTEM<particle<details::extended_precise_type>, interactions>,                \
-                  details::const_##ITER##_extplus>;
+                  details::const_##ITER##_extplus>;                                                               \
+                                                                                                                  \
+    template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>     \
+    using Const_##NAME##_DD =                                                                                     \
+        Simulator<particle_system::SYSTEM<particle<details::double_double_type>, interactions>,                   \
+                  details::const_##ITER##_dd>;
 
 #define DEFINE_INTEGRATION_METHOD(NAME, SYSTEM, ITER)                                                                  \
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
@@ -277,7 +332,15 @@ namespace hub {
                                                                                                                        \
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
     using Const_##NAME##_ExtPlus = Simulator<system::SYSTEM<particle<details::extended_precise_type>, interactions>,   \
-                                             details::const_##ITER##_extplus>;
+                                             details::const_##ITER##_extplus>;                                         \
+                                                                                                                       \
+    template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
+    using NAME##_DD =                                                                                                  \
+        Simulator<system::SYSTEM<particle<details::double_double_type>, interactions>, details::ITER##_dd>;            \
+                                                                                                                       \
+    template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>          \
+    using Const_##NAME##_DD =                                                                                          \
+        Simulator<system::SYSTEM<particle<details::double_double_type>, interactions>, details::const_##ITER##_dd>;
 
 #define DEFINE_ADAPTIVE_ARBITRARY_BIT_METHOD(NAME, SYSTEM, ITER)                                              \
     template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles> \
@@ -355,6 +418,10 @@ namespace hub {
 
         DEFINE_INTEGRATION_METHOD(AR_Radau_Chain, ARchainSystem, Radau)
 
+        DEFINE_INTEGRATION_METHOD(Radau2nd, SimpleSystem, Radau2nd)
+
+        DEFINE_INTEGRATION_METHOD(Chain_Radau2nd, ChainSystem, Radau2nd)
+
         template <typename interactions = DefaultForce, template <typename> typename particle = DefaultParticles>
         using DefaultMethod = methods::AR_Chain_Plus<interactions, particle>;
     }  // namespace methods
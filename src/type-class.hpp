@@ -26,6 +26,7 @@ License
 #include <vector>
 
 #include "dev-tools.hpp"
+#include "kahan-array.hpp"
 #include "small-vector.hpp"
 #include "vector/lazy-vec3.h"
 #include "vector/vector3.hpp"
@@ -36,6 +37,120 @@ namespace hub {
 
     template <typename T>
     using SSO_vec_vector = llvm::SmallVector<T, 5>;
+
+    /**
+     * @brief `std::array` backed container with the vector interface used across the system, for particle arrays of
+     * a particle number N known at compile time.
+     *
+     * `size()` is always N. `resize()` and `reserve()` accept only N, and `clear()` followed by N `emplace_back()`
+     * refills the array from the front, so the code written for the dynamic containers works unchanged while every
+     * loop over the array gets a compile time trip count.
+     *
+     * @tparam T Value type.
+     * @tparam N Number of elements.
+     */
+    template <typename T, size_t N>
+    class FixedArray {
+       public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = T const &;
+        using iterator = T *;
+        using const_iterator = T const *;
+
+        FixedArray() = default;
+
+        explicit FixedArray(size_t n) { DEBUG_MODE_ASSERT(n == N, "FixedArray: size mismatch!"); }
+
+        FixedArray(size_t n, T const &value) {
+            DEBUG_MODE_ASSERT(n == N, "FixedArray: size mismatch!");
+            data_.fill(value);
+        }
+
+        [[nodiscard]] static constexpr size_t size() noexcept { return N; }
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept { return N; }
+
+        [[nodiscard]] static constexpr bool empty() noexcept { return N == 0; }
+
+        inline void resize(size_t n) { DEBUG_MODE_ASSERT(n == N, "FixedArray: size mismatch!"); }
+
+        inline void reserve(size_t n) { DEBUG_MODE_ASSERT(n <= N, "FixedArray: size mismatch!"); }
+
+        inline void assign(size_t n, T const &value) {
+            DEBUG_MODE_ASSERT(n == N, "FixedArray: size mismatch!");
+            data_.fill(value);
+        }
+
+        /**
+         * @brief Restart the `emplace_back()` cursor at the front. The elements are kept.
+         */
+        inline void clear() noexcept { fill_ = 0; }
+
+        template <typename... Args>
+        inline T &emplace_back(Args &&... args) {
+            DEBUG_MODE_ASSERT(fill_ < N, "FixedArray: emplace_back beyond the fixed size!");
+            return data_[fill_++] = T(std::forward<Args>(args)...);
+        }
+
+        inline T &operator[](size_t i) noexcept { return data_[i]; }
+
+        inline T const &operator[](size_t i) const noexcept { return data_[i]; }
+
+        inline T &front() noexcept { return data_[0]; }
+
+        inline T const &front() const noexcept { return data_[0]; }
+
+        inline T &back() noexcept { return data_[N - 1]; }
+
+        inline T const &back() const noexcept { return data_[N - 1]; }
+
+        inline T *data() noexcept { return data_.data(); }
+
+        inline T const *data() const noexcept { return data_.data(); }
+
+        inline iterator begin() noexcept { return data_.data(); }
+
+        inline iterator end() noexcept { return data_.data() + N; }
+
+        inline const_iterator begin() const noexcept { return data_.data(); }
+
+        inline const_iterator end() const noexcept { return data_.data() + N; }
+
+        friend bool operator==(FixedArray const &lhs, FixedArray const &rhs) { return lhs.data_ == rhs.data_; }
+
+        friend bool operator!=(FixedArray const &lhs, FixedArray const &rhs) { return lhs.data_ != rhs.data_; }
+
+       private:
+        std::array<T, N> data_{};
+
+        size_t fill_{0};
+    };
+
+    /**
+     * @brief Compile time size of a container, 0 for containers with a runtime size.
+     */
+    template <typename Array>
+    struct static_size : std::integral_constant<size_t, 0> {};
+
+    template <typename T, size_t N>
+    struct static_size<FixedArray<T, N>> : std::integral_constant<size_t, N> {};
+
+    template <typename Array>
+    inline constexpr size_t static_size_v = static_size<std::decay_t<Array>>::value;
+
+    /**
+     * @brief Largest compile time particle number for which the kernels unroll their loops completely.
+     */
+    inline constexpr size_t max_unrolled_size{16};
+
+    /**
+     * @brief Compile time size of a container if its loops are unrolled, otherwise 0.
+     */
+    template <typename Array>
+    inline constexpr size_t unrolled_size_v = static_size_v<Array> <= max_unrolled_size ? static_size_v<Array> : 0;
+
     /**
       Type system that is used across the Space Hub system. This type class provide all basic type i.e `Scalar`,
       `Vector`, `ScalarArray`, `Coord` and etc,.
@@ -66,7 +181,11 @@ namespace hub {
          */
         using ScalarArray = Container<Scalar>;
 
-        using StateScalarArray = Container<StateScalar>;
+        /**
+         * 1-d array with value type `StateScalar`. Alias of `Container<StateScalar>`, or of the SoA `KahanArray` for
+         * `Kahan` state scalars.
+         */
+        using StateScalarArray = state_array_t<StateScalar, Container<StateScalar>>;
 
         /**
          * 1-d array with value type `int`. Alias of `Container<int>`.
@@ -94,57 +213,73 @@ namespace hub {
         using StateVectorArray = SSO_vec_vector<StateVector>;
     };
 
+    namespace details {
+        /**
+         * @brief Call `func(v)` for every element of a vector array, fully unrolled for the compile time sized arrays.
+         */
+        template <typename VectorArray, typename Func>
+        inline void for_each_coord(VectorArray &var, Func &&func) {
+            if constexpr (unrolled_size_v<VectorArray> != 0) {
+                static_for<0, unrolled_size_v<VectorArray>>([&](auto i) { func(var[i]); });
+            } else {
+                for (auto &v : var) {
+                    func(v);
+                }
+            }
+        }
+    }  // namespace details
+
     template <typename Iter, typename VectorArray>
     void load_to_coords(Iter begin, Iter end, VectorArray& var) {
         size_t len = (end - begin) / 3;
         var.resize(len);
         auto iter = begin;
-        for (auto& v : var) {
+        details::for_each_coord(var, [&](auto& v) {
             v.x = *iter++;
             v.y = *iter++;
             v.z = *iter++;
-        }
+        });
     }
 
     template <typename Iter, typename VectorArray>
     void advance_coords_to(Iter begin, VectorArray const& var) {
         auto iter = begin;
-        for (auto& v : var) {
+        details::for_each_coord(var, [&](auto const& v) {
             *(iter++) += v.x;
             *(iter++) += v.y;
             *(iter++) += v.z;
-        }
+        });
     }
 
     template <typename Iter, typename VectorArray, typename Scalar>
     void advance_scaled_coords_to(Iter begin, VectorArray const& var, Scalar scale) {
         auto iter = begin;
-        for (auto& v : var) {
+        details::for_each_coord(var, [&](auto const& v) {
             *(iter++) += v.x * scale;
             *(iter++) += v.y * scale;
             *(iter++) += v.z * scale;
-        }
+        });
     }
 
     template <typename ScalarArray, typename VectorArray>
     void add_coords_to(ScalarArray& stl, VectorArray const& var) {
         stl.reserve(var.size() * 3 + stl.size());
 
-        for (auto const& v : var) {
+        details::for_each_coord(var, [&](auto const& v) {
             stl.emplace_back(v.x);
             stl.emplace_back(v.y);
             stl.emplace_back(v.z);
-        }
+        });
     }
 
     template <typename ScalarArray, typename VectorArray, typename Scalar>
     void add_scaled_coords_to(ScalarArray& stl, VectorArray const& var, Scalar scale) {
         stl.reserve(var.size() * 3 + stl.size());
-        for (auto const& v : var) {
+        details::for_each_coord(var, [&](auto const& v) {
             stl.emplace_back(v.x * scale);
             stl.emplace_back(v.y * scale);
             stl.emplace_back(v.z * scale);
-        }
+        });
     }
 
 }  // namespace hub
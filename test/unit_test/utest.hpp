@@ -20,6 +20,8 @@ License
 #ifndef SPACEHUB_UTEST_HPP
 #define SPACEHUB_UTEST_HPP
 
+#include <vector>
+
 #include "../../src/math.hpp"
 #include "../../src/rand-generator.hpp"
 using utest_scalar = double;
@@ -30,4 +32,20 @@ constexpr size_t RAND_TEST_NUM = 10000;
 
 #define APPROX(x) Approx(x).epsilon(UTEST_EPSILON).margin(UTEST_EPSILON)
 #define UTEST_RAND hub::random::Uniform(UTEST_LOW, UTEST_HIGH)
+
+/**
+ * Random particles with masses in [0.1, 2.1], positions in [-1, 1]^3 and velocities in [-vel, vel]^3.
+ *
+ * @tparam Particle Particle type constructible from (mass, x, y, z, vx, vy, vz).
+ * @tparam Container Container with `emplace_back(Particle)`, a vector of particles by default.
+ */
+template <typename Particle, typename Container = std::vector<Particle>>
+Container utest_random_particles(size_t n, double vel = 0) {
+    Container ptc;
+    for (size_t i = 0; i < n; ++i) {
+        ptc.emplace_back(Particle{UTEST_RAND + 1.1, UTEST_RAND, UTEST_RAND, UTEST_RAND, vel * UTEST_RAND,
+                                  vel * UTEST_RAND, vel * UTEST_RAND});
+    }
+    return ptc;
+}
 #endif  // SPACEHUB_UTEST_HPP
@@ -19,12 +19,146 @@ License
 \*---------------------------------------------------------------------------*/
 #include "../catch.hpp"
 #include "utest.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/particle-system/archain.hpp"
 #include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/chain-system.hpp"
+#include "../../src/particle-system/regu-system.hpp"
+#include "../../src/particles/point-particles.hpp"
 
 TEST_CASE("Base system") {
     using namespace hub;
     using namespace hub::system;
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using System = SimpleSystem<Particles, force::Interactions<force::NewtonianGrav>>;
 
+    auto particle_set = utest_random_particles<Particle>(5, 1);
 
+    SECTION("potential cached by the force pass") {
+        System sys(0, particle_set);
+        REQUIRE_FALSE(sys.potential_cached());
 
-}
\ No newline at end of file
+        auto expected = calc::calc_potential_energy(Particles(0, particle_set));
+        sys.kick(0);
+        REQUIRE(sys.potential_cached());
+        REQUIRE(calc::calc_potential_energy(sys) == Approx(expected).epsilon(1e-12));
+
+        sys.drift(1e-3);
+        REQUIRE_FALSE(sys.potential_cached());
+        REQUIRE(calc::calc_potential_energy(sys) ==
+                Approx(calc::calc_potential_energy(static_cast<Particles const &>(sys))).epsilon(1e-12));
+    }
+
+    SECTION("writable positions and masses clear the cached potential") {
+        System sys(0, particle_set);
+        auto const &csys = sys;
+        sys.kick(0);
+        REQUIRE(csys.mass(1) > 0);
+        REQUIRE(csys.pos(2).y == csys.pos()[2].y);
+        REQUIRE(sys.potential_cached());
+
+        sys.mass(1) *= 2;
+        REQUIRE_FALSE(sys.potential_cached());
+        REQUIRE(calc::calc_potential_energy(sys) ==
+                Approx(calc::calc_potential_energy(static_cast<Particles const &>(sys))).epsilon(1e-12));
+
+        sys.kick(0);
+        sys.pos(2).y += 0.5;
+        REQUIRE_FALSE(sys.potential_cached());
+        REQUIRE(calc::calc_potential_energy(sys) ==
+                Approx(calc::calc_potential_energy(static_cast<Particles const &>(sys))).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("Regularized system omega from the force pass") {
+    using namespace hub;
+    using namespace hub::system;
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    auto particle_set = utest_random_particles<Particle>(5, 1);
+
+    auto check = [&](auto sys) {
+        sys.drift(1e-4);
+        REQUIRE_FALSE(sys.potential_cached());
+        sys.kick(1e-4);
+        REQUIRE(sys.potential_cached());
+        REQUIRE(sys.step_scale() == Approx(-sys.cached_potential()).epsilon(1e-14));
+        REQUIRE(sys.cached_potential() ==
+                Approx(calc::calc_potential_energy(static_cast<Particles const &>(sys))).epsilon(1e-12));
+    };
+
+    SECTION("regularized system") { check(RegularizedSystem<Particles, Force, ReguType::TTL>(0, particle_set)); }
+
+    SECTION("ARchain system") { check(ARchainSystem<Particles, Force, ReguType::TTL>(0, particle_set)); }
+}
+
+TEST_CASE("Chain ordered copy of the chain systems") {
+    using namespace hub;
+    using namespace hub::system;
+    using Type = Types<utest_scalar>;
+    using Particles = particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    auto check = [&](auto sys) {
+        auto check_mirror = [&]() {
+            auto const &o = sys.chain_ordered();
+            auto const &idx = sys.index();
+            REQUIRE(o.size() == sys.number());
+            for (size_t k = 0; k < sys.number(); ++k) {
+                REQUIRE(o.x[k] == sys.pos()[idx[k]].x);
+                REQUIRE(o.y[k] == sys.pos()[idx[k]].y);
+                REQUIRE(o.z[k] == sys.pos()[idx[k]].z);
+                REQUIRE(o.vx[k] == sys.vel()[idx[k]].x);
+                REQUIRE(o.vy[k] == sys.vel()[idx[k]].y);
+                REQUIRE(o.vz[k] == sys.vel()[idx[k]].z);
+                REQUIRE(o.m[k] == sys.mass()[idx[k]]);
+            }
+        };
+
+        check_mirror();
+        for (size_t step = 0; step < 10; ++step) {
+            sys.pre_iter_process();
+            sys.drift(1e-2);
+            check_mirror();
+            sys.kick(1e-2);
+            check_mirror();
+            sys.post_iter_process();
+            check_mirror();
+        }
+
+        sys.mass(0) *= 2;
+        sys.mass(sys.number() - 1) *= 0.5;
+        sys.pre_iter_process();
+        check_mirror();
+
+        VectorArray acc(sys.number()), expected(sys.number());
+        calc::array_set_zero(acc);
+        calc::array_set_zero(expected);
+        sys.evaluate_acc(acc);
+        force::NewtonianGrav::add_acc_to(static_cast<Particles const &>(sys), expected);
+        for (size_t i = 0; i < sys.number(); ++i) {
+            REQUIRE(acc[i].x == Approx(expected[i].x).epsilon(1e-10));
+            REQUIRE(acc[i].y == Approx(expected[i].y).epsilon(1e-10));
+            REQUIRE(acc[i].z == Approx(expected[i].z).epsilon(1e-10));
+        }
+        REQUIRE(calc::calc_potential_energy(sys) ==
+                Approx(calc::calc_potential_energy(static_cast<Particles const &>(sys))).epsilon(1e-12));
+    };
+
+    for (size_t n : {size_t{5}, size_t{20}}) {
+        auto particle_set = utest_random_particles<Particle>(n, 1);
+
+        SECTION("chain system " + std::to_string(n)) { check(ChainSystem<Particles, Force>(0, particle_set)); }
+
+        SECTION("ARchain system " + std::to_string(n)) {
+            check(ARchainSystem<Particles, Force, ReguType::TTL>(0, particle_set));
+        }
+    }
+}
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../catch.hpp"
+#include "utest.hpp"
+#include "../../src/integrator/symplectic/symplectic-integrator.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/Bulirsch-Stoer.hpp"
+#include "../../src/ode-iterator/error-checker/RMS.hpp"
+#include "../../src/ode-iterator/error-checker/worst-offender.hpp"
+#include "../../src/ode-iterator/step-controller/PID-controller.hpp"
+#include "../../src/particle-system/archain.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/chain-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/simulator.hpp"
+
+namespace {
+    using namespace hub;
+    using Type = Types<utest_scalar>;
+    using Force = force::Interactions<force::NewtonianGrav>;
+
+    template <typename StateType>
+    using BS =
+        ode::BulirschStoer<integrator::LeapFrogDKD<StateType>, ode::WorstOffender<Type>, ode::PIDController<Type>>;
+
+    /**
+     * Integrate the system over a number of steps with the given number of substep threads.
+     */
+    template <typename System, typename StateType, typename ParticleSet>
+    System integrate_with_threads(ParticleSet const &particle_set, size_t threads) {
+        auto const default_threads = ode::substep_threads;
+        ode::substep_threads = threads;
+        BS<StateType> iterator;
+        iterator.set_rtol(1e-13);
+        System sys(0, particle_set);
+        typename System::Scalar h = 1e-3;
+        for (size_t i = 0; i < 50; ++i) {
+            h = iterator.iterate(sys, h);
+        }
+        ode::substep_threads = default_threads;
+        return sys;
+    }
+
+    template <typename System, typename StateType = Type>
+    void check_substep_parallel() {
+        using Particle = typename System::Particle;
+        auto particle_set = utest_random_particles<Particle>(5, 1);
+        auto serial = integrate_with_threads<System, StateType>(particle_set, 1);
+        auto parallel = integrate_with_threads<System, StateType>(particle_set, 4);
+
+        auto same = [](auto const &a, auto const &b) {
+            return static_cast<double>(a.x) == static_cast<double>(b.x) &&
+                   static_cast<double>(a.y) == static_cast<double>(b.y) &&
+                   static_cast<double>(a.z) == static_cast<double>(b.z);
+        };
+        REQUIRE(static_cast<double>(serial.time()) == static_cast<double>(parallel.time()));
+        REQUIRE(static_cast<double>(serial.step_scale()) == static_cast<double>(parallel.step_scale()));
+        for (size_t i = 0; i < particle_set.size(); ++i) {
+            REQUIRE(same(serial.pos(i), parallel.pos(i)));
+            REQUIRE(same(serial.vel(i), parallel.vel(i)));
+        }
+    }
+}  // namespace
+
+TEST_CASE("Bulirsch-Stoer substep parallel") {
+    using Particles = particles::PointParticles<Type>;
+    using PreciseType = Types<double_k>;
+    using PreciseParticles = particles::PointParticles<PreciseType>;
+
+    SECTION("simple system") { check_substep_parallel<system::SimpleSystem<Particles, Force>>(); }
+
+    SECTION("chain system") { check_substep_parallel<system::ChainSystem<Particles, Force>>(); }
+
+    SECTION("regularized chain system") {
+        check_substep_parallel<system::ARchainSystem<PreciseParticles, Force>, PreciseType>();
+    }
+}
+
+TEST_CASE("Error checker blocked accumulation") {
+    using Array = typename Type::ScalarArray;
+    size_t const size = 1000;
+    Array y0(size), y1(size), y1_prime(size);
+    for (size_t i = 0; i < size; ++i) {
+        y0[i] = UTEST_RAND;
+        y1[i] = UTEST_RAND;
+        y1_prime[i] = y1[i] + 1e-10 * UTEST_RAND;
+    }
+
+    auto check = [&](auto checker) {
+        checker.set_atol(1e-14);
+        checker.set_rtol(1e-12);
+        for (size_t block : {size_t{1}, size_t{7}, size_t{256}, size}) {
+            utest_scalar acc{0};
+            for (size_t begin = 0; begin < size; begin += block) {
+                checker.accumulate_error(acc, y0, y1, y1_prime, begin, std::min(begin + block, size));
+            }
+            REQUIRE(checker.finish_error(acc, size) == checker.error(y0, y1, y1_prime));
+        }
+    };
+
+    SECTION("worst offender") { check(ode::WorstOffender<Type>{}); }
+
+    SECTION("RMS") { check(ode::RMS<Type>{}); }
+}
+
+TEST_CASE("Bulirsch-Stoer dense output") {
+    using Particles = particles::PointParticles<Type>;
+    using System = system::SimpleSystem<Particles, Force>;
+    using Simulator = hub::Simulator<System, BS<Type>>;
+    using Particle = typename System::Particle;
+
+    // Keplerian orbit of eccentricity 0.5 starting at the periapsis.
+    std::vector<Particle> particle_set{Particle{1, 0, 0, 0, 0, 0, 0}, Particle{1e-3, 1, 0, 0, 0, sqrt(1.5 * 1.001), 0}};
+    utest_scalar const end = 12;
+    size_t const num = 25;
+
+    auto reference = [&](utest_scalar time) {
+        typename Simulator::RunArgs args;
+        args.rtol = 1e-14;
+        args.time_rtol = 1e-15;
+        args.add_stop_condition(time);
+        Simulator sim{0, particle_set};
+        sim.run(args);
+        return sim.particles();
+    };
+
+    std::vector<System> outputs;
+    typename Simulator::RunArgs args;
+    args.rtol = 1e-14;
+    args.add_stop_condition(end);
+    args.add_dense_operation(end / (num + 1), end - end / (num + 1), num,
+                             [&](auto &ptc, auto) { outputs.push_back(ptc); });
+    Simulator sim{0, particle_set};
+    sim.run(args);
+
+    REQUIRE(outputs.size() == num);
+    for (size_t i = 0; i < num; ++i) {
+        auto const &out = outputs[i];
+        REQUIRE(out.time() == Approx(args.dense_times()[i]).epsilon(1e-14));
+        auto ref = reference(out.time());
+        for (size_t j = 0; j < particle_set.size(); ++j) {
+            REQUIRE(norm(out.pos(j) - ref.pos(j)) < 1e-11);
+            REQUIRE(norm(out.vel(j) - ref.vel(j)) < 1e-11);
+        }
+    }
+
+    // the dense operations only read the interpolated copies, the run itself ends as without them
+    auto const &last = sim.particles();
+    REQUIRE(last.time() == Approx(end).epsilon(1e-14));
+    auto ref = reference(end);
+    for (size_t j = 0; j < particle_set.size(); ++j) {
+        REQUIRE(norm(last.pos(j) - ref.pos(j)) < 1e-11);
+        REQUIRE(norm(last.vel(j) - ref.vel(j)) < 1e-11);
+    }
+}
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/interaction/alpha-disk.hpp"
+#include "../../src/interaction/central-field.hpp"
+#include "../../src/interaction/magneto-disk.hpp"
+#include "../../src/particles/tide-particles.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::TideParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+    using Vector = typename Type::Vector;
+
+    // drag against a rigidly rotating medium, stronger for larger satellites.
+    struct LinearDrag : public hub::force::CentralField<LinearDrag> {
+        template <typename Vec, typename Scalar>
+        static Vec central_force(hub::force::CentralSample<Vec, Scalar> const &s) {
+            Vec v_medium{-s.dr.y, s.dr.x, 0};
+            return -(s.m * s.radius) * (s.dv - v_medium) / (1 + norm2(s.dr));
+        }
+    };
+
+    // same drag with the rotation rate of the medium read from the context.
+    struct ContextDrag : public hub::force::CentralField<ContextDrag> {
+        struct Context {
+            double omega;
+        };
+
+        inline static size_t fetched{0};
+
+        static Context central_context() {
+            fetched++;
+            return Context{1.0};
+        }
+
+        template <typename Vec, typename Scalar>
+        static Vec central_force(hub::force::CentralSample<Vec, Scalar> const &s, Context const &ctx) {
+            Vec v_medium{-ctx.omega * s.dr.y, ctx.omega * s.dr.x, 0};
+            return -(s.m * s.radius) * (s.dv - v_medium) / (1 + norm2(s.dr));
+        }
+    };
+
+    Particles random_satellites(size_t n) {
+        Particles ptc;
+        ptc.emplace_back(Particle{1e8, 0.1, 0, 0, UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND,
+                                  UTEST_RAND});
+        for (size_t i = 1; i < n; ++i) {
+            auto a = 50 * (UTEST_RAND + 2);
+            ptc.emplace_back(Particle{UTEST_RAND + 1.1, 1e-3 * (UTEST_RAND + 1.1), 0, 0, a * UTEST_RAND, a * UTEST_RAND,
+                                      0.01 * a * UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND});
+        }
+        return ptc;
+    }
+
+    void check_momentum(Particles const &ptc, VectorArray const &acc) {
+        auto const &m = ptc.mass();
+        Vector total{0, 0, 0};
+        utest_scalar scale = 0;
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            total += m[i] * acc[i];
+            scale = std::max(scale, norm(m[i] * acc[i]));
+        }
+        REQUIRE(norm(total) <= 1e-12 * scale);
+    }
+}  // namespace
+
+double hub::force::AlphaDisk::Q{1};
+double hub::force::AlphaDisk::alpha{0.1};
+double hub::force::AlphaDisk::lambda{1};
+int hub::force::AlphaDisk::force{0};
+
+TEST_CASE("central field") {
+    for (size_t n : std::initializer_list<size_t>{1, 2, 17, 100}) {
+        auto ptc = random_satellites(n);
+        auto const &p = ptc.pos();
+        auto const &v = ptc.vel();
+        auto const &m = ptc.mass();
+        auto const &rad = ptc.radius();
+
+        SECTION("per-satellite model n=" + std::to_string(n)) {
+            VectorArray expected(n);
+            for (size_t i = 1; i < n; ++i) {
+                hub::force::CentralSample<Vector, utest_scalar> s{p[i] - p[0], v[i] - v[0], m[0], m[i], rad[i]};
+                auto f = LinearDrag::central_force(s);
+                expected[i] += f / m[i];
+                expected[0] -= f / m[0];
+            }
+
+            VectorArray acc(n);
+            LinearDrag::add_acc_to(ptc, acc);
+            for (size_t i = 0; i < n; ++i) {
+                auto scale = norm(expected[i]);
+                REQUIRE(acc[i].x == Approx(expected[i].x).margin(1e-12 * scale));
+                REQUIRE(acc[i].y == Approx(expected[i].y).margin(1e-12 * scale));
+                REQUIRE(acc[i].z == Approx(expected[i].z).margin(1e-12 * scale));
+            }
+            check_momentum(ptc, acc);
+        }
+
+        SECTION("context fetched once n=" + std::to_string(n)) {
+            VectorArray acc(n), expected(n);
+            ContextDrag::fetched = 0;
+            ContextDrag::add_acc_to(ptc, acc);
+            REQUIRE(ContextDrag::fetched == (n > 1 ? 1 : 0));
+            LinearDrag::add_acc_to(ptc, expected);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(norm(acc[i] - expected[i]) == 0);
+            }
+        }
+
+        SECTION("magneto disk back-reaction n=" + std::to_string(n)) {
+            VectorArray acc(n);
+            hub::force::MagnetoDisk::add_acc_to(ptc, acc);
+            check_momentum(ptc, acc);
+        }
+    }
+}
+
+TEST_CASE("alpha disk drag terms") {
+    using hub::force::AlphaDisk;
+    auto ptc = random_satellites(100);
+    auto const &p = ptc.pos();
+    auto const &v = ptc.vel();
+    auto const &m = ptc.mass();
+    auto const &rad = ptc.radius();
+
+    auto force_with = [&](int mode, size_t i) {
+        AlphaDisk::force = mode;
+        hub::force::CentralSample<Vector, utest_scalar> s{p[i] - p[0], v[i] - v[0], m[0], m[i], rad[i]};
+        return AlphaDisk::central_force(s, AlphaDisk::central_context());
+    };
+
+    for (size_t i = 1; i < ptc.number(); ++i) {
+        auto both = force_with(0, i);
+        auto df = force_with(1, i);
+        auto aeo = force_with(-1, i);
+        REQUIRE(norm(both - df - aeo) <= 1e-12 * norm(both));
+        REQUIRE(norm(force_with(-2, i) - aeo) == 0);
+
+        auto dv = v[i] - v[0] - AlphaDisk::disk_v(p[i] - p[0], m[0]);
+        auto [Omega, H] = AlphaDisk::local_Omega_H(p[i] - p[0], m[0]);
+        auto rho = AlphaDisk::disk_rho(p[i] - p[0], m[0], H);
+        auto f = 4 * hub::consts::pi * rad[i] * rad[i] * rho * norm2(dv);
+        REQUIRE(norm(aeo + f * dv / norm(dv)) <= 1e-12 * f);
+    }
+    AlphaDisk::force = 0;
+
+    VectorArray acc(ptc.number());
+    AlphaDisk::add_acc_to(ptc, acc);
+    check_momentum(ptc, acc);
+}
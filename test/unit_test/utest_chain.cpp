@@ -18,13 +18,15 @@ License
     with SpaceHub.
 \*---------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <iomanip>
+#include <limits>
+#include <numeric>
 
 #include "../../src/particle-system/chain.hpp"
 #include "../../src/type-class.hpp"
 #include "../catch.hpp"
 #include "utest.hpp"
-// TODO test update_chain()
 TEST_CASE("particle system chain xy") {
     using type_sys = hub::Types<utest_scalar>;
     using VectorArray = typename type_sys::VectorArray;
@@ -179,4 +181,170 @@ TEST_CASE("particle system chain yz") {
             REQUIRE(pos[i].z == APPROX(cartesian_pos[i].z));
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("chain index maintenance") {
+    using type_sys = hub::Types<utest_scalar>;
+    using VectorArray = typename type_sys::VectorArray;
+    using IdxArray = typename type_sys::IdxArray;
+    using Vector = typename type_sys::Vector;
+
+    auto chain_length = [](VectorArray const &pos, IdxArray const &idx) {
+        double len = 0;
+        for (size_t k = 0; k + 1 < idx.size(); ++k) {
+            len += norm(pos[idx[k + 1]] - pos[idx[k]]);
+        }
+        return len;
+    };
+
+    auto is_permutation = [](IdxArray idx, size_t n) {
+        std::sort(idx.begin(), idx.end());
+        IdxArray expected(n);
+        std::iota(expected.begin(), expected.end(), 0);
+        return idx == expected;
+    };
+
+    SECTION("rebuild matches the greedy construction") {
+        size_t const n = 60;
+        VectorArray pos;
+        for (size_t i = 0; i < n; ++i) {
+            pos.emplace_back(UTEST_RAND, UTEST_RAND, UTEST_RAND);
+        }
+
+        // brute force: start from the closest pair and add the particle nearest to either end
+        auto r = [&](size_t i, size_t j) { return norm2(pos[i] - pos[j]); };
+        size_t a = 0, b = 1;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i + 1; j < n; ++j)
+                if (r(i, j) < r(a, b)) a = i, b = j;
+        std::vector<size_t> expected{a, b};
+        std::vector<bool> used(n, false);
+        used[a] = used[b] = true;
+        while (expected.size() < n) {
+            size_t best = n;
+            bool at_head = true;
+            double best_r = -1;
+            for (size_t k = 0; k < n; ++k) {
+                if (used[k]) continue;
+                if (best_r < 0 || r(k, expected.front()) < best_r) {
+                    best = k, best_r = r(k, expected.front()), at_head = true;
+                }
+            }
+            for (size_t k = 0; k < n; ++k) {
+                if (used[k]) continue;
+                if (r(k, expected.back()) < best_r) {
+                    best = k, best_r = r(k, expected.back()), at_head = false;
+                }
+            }
+            used[best] = true;
+            if (at_head) {
+                expected.insert(expected.begin(), best);
+            } else {
+                expected.push_back(best);
+            }
+        }
+
+        IdxArray idx;
+        hub::Chain::calc_chain_index(pos, idx);
+        REQUIRE(std::equal(idx.begin(), idx.end(), expected.begin(), expected.end()));
+    }
+
+    SECTION("unchanged chain is kept") {
+        size_t const n = 40;
+        VectorArray pos;
+        for (size_t i = 0; i < n; ++i) {
+            pos.emplace_back(UTEST_RAND, UTEST_RAND, UTEST_RAND);
+        }
+        IdxArray idx;
+        hub::Chain::calc_chain_index(pos, idx);
+        double len = chain_length(pos, idx);
+        for (size_t k = 0; k < 100 && hub::Chain::update_chain_index(pos, idx); ++k) {
+            REQUIRE(is_permutation(idx, n));
+            REQUIRE(chain_length(pos, idx) < len);
+            len = chain_length(pos, idx);
+        }
+        IdxArray kept = idx;
+        REQUIRE_FALSE(hub::Chain::update_chain_index(pos, idx));
+        REQUIRE(kept == idx);
+    }
+
+    SECTION("local re-link") {
+        size_t const n = 20;
+        VectorArray pos;
+        for (size_t i = 0; i < n; ++i) {
+            pos.emplace_back(static_cast<double>(i) * (1 + 0.01 * static_cast<double>(i)), 0, 0);
+        }
+        IdxArray idx;
+        hub::Chain::calc_chain_index(pos, idx);
+        REQUIRE_FALSE(hub::Chain::update_chain_index(pos, idx));
+
+        // particle 15 comes close to particle 3
+        pos[15] = pos[3] + Vector(0, 0.1, 0);
+        VectorArray chain(n);
+        hub::Chain::calc_chain(pos, chain, idx);
+        IdxArray old_idx = idx;
+        double len = chain_length(pos, idx);
+
+        REQUIRE(hub::Chain::update_chain_index(pos, idx));
+        REQUIRE(is_permutation(idx, n));
+        REQUIRE(chain_length(pos, idx) < len);
+        auto at = [&](size_t i) { return std::find(idx.begin(), idx.end(), i) - idx.begin(); };
+        REQUIRE(std::abs(at(15) - at(3)) == 1);
+
+        hub::Chain::update_chain(chain, pos, old_idx, idx);
+        VectorArray expected(n);
+        hub::Chain::calc_chain(pos, expected, idx);
+        for (size_t i = 0; i < n; ++i) {
+            REQUIRE(chain[i].x == APPROX(expected[i].x));
+            REQUIRE(chain[i].y == APPROX(expected[i].y));
+            REQUIRE(chain[i].z == APPROX(expected[i].z));
+        }
+    }
+
+    SECTION("no close pair is left unchained") {
+        size_t const n = 30;
+        VectorArray pos;
+        for (size_t i = 0; i < n; ++i) {
+            pos.emplace_back(UTEST_RAND, UTEST_RAND, UTEST_RAND);
+        }
+        IdxArray idx(n);
+        std::iota(idx.begin(), idx.end(), 0);
+        for (size_t k = 0; k < 100 && hub::Chain::update_chain_index(pos, idx); ++k) {
+            REQUIRE(is_permutation(idx, n));
+        }
+        REQUIRE_FALSE(hub::Chain::update_chain_index(pos, idx));
+
+        // brute force: no non-chained pair is closer than every chain link at both of its ends
+        std::vector<size_t> rank(n);
+        std::vector<double> shorter(n, std::numeric_limits<double>::infinity());
+        for (size_t k = 0; k < n; ++k) {
+            rank[idx[k]] = k;
+        }
+        for (size_t k = 0; k + 1 < n; ++k) {
+            double link = norm(pos[idx[k + 1]] - pos[idx[k]]);
+            shorter[idx[k]] = std::min(shorter[idx[k]], link);
+            shorter[idx[k + 1]] = std::min(shorter[idx[k + 1]], link);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                if (rank[i] + 1 == rank[j] || rank[j] + 1 == rank[i]) continue;
+                double r = norm(pos[i] - pos[j]);
+                REQUIRE_FALSE((r < shorter[i] && r < shorter[j]));
+            }
+        }
+    }
+
+    SECTION("small systems are rebuilt") {
+        VectorArray pos;
+        pos.emplace_back(0, 0, 0);
+        pos.emplace_back(1, 0, 0);
+        pos.emplace_back(3, 0, 0);
+        IdxArray idx;
+        hub::Chain::calc_chain_index(pos, idx);
+        pos[2] = Vector(0.5, 0, 0);
+        REQUIRE(hub::Chain::update_chain_index(pos, idx));
+        IdxArray expected;
+        hub::Chain::calc_chain_index(pos, expected);
+        REQUIRE(expected == idx);
+    }
+}
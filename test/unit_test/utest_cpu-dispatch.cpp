@@ -0,0 +1,119 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/core-computation.hpp"
+#include "../../src/cpu-dispatch.hpp"
+#include "../../src/interaction/soa-kernel.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+    using ScalarArray = typename Type::ScalarArray;
+
+    /**
+     * Restores `cpu::max_isa` and `kernel::inv_sqrt_policy` on scope exit.
+     */
+    struct DispatchGuard {
+        hub::cpu::Isa isa{hub::cpu::max_isa};
+        hub::force::kernel::InvSqrt policy{hub::force::kernel::inv_sqrt_policy};
+
+        ~DispatchGuard() {
+            hub::cpu::max_isa = isa;
+            hub::force::kernel::inv_sqrt_policy = policy;
+        }
+    };
+
+    template <typename Kernel>
+    std::pair<VectorArray, double> eval_at(hub::cpu::Isa level, Particles const &ptc, Kernel &&kernel) {
+        hub::cpu::max_isa = level;
+        hub::force::kernel::SoAScratch<double> scratch;
+        scratch.gather(ptc.pos(), ptc.mass());
+        double pot = kernel(scratch);
+        VectorArray acc(ptc.number());
+        scratch.scatter_add_to(acc);
+        return {acc, pot};
+    }
+
+    template <typename Kernel>
+    void check_isa_levels(Particles const &ptc, Kernel &&kernel, double tol) {
+        using hub::cpu::Isa;
+        auto [base_acc, base_pot] = eval_at(Isa::SSE2, ptc, kernel);
+        for (auto level : {Isa::AVX2, Isa::AVX512}) {
+            auto [acc, pot] = eval_at(level, ptc, kernel);
+            REQUIRE(pot == Approx(base_pot).epsilon(tol));
+            for (size_t i = 0; i < ptc.number(); ++i) {
+                auto scale = norm(base_acc[i]);
+                REQUIRE(acc[i].x == Approx(base_acc[i].x).margin(tol * scale));
+                REQUIRE(acc[i].y == Approx(base_acc[i].y).margin(tol * scale));
+                REQUIRE(acc[i].z == Approx(base_acc[i].z).margin(tol * scale));
+            }
+        }
+    }
+}  // namespace
+
+TEST_CASE("cpu dispatch") {
+    using namespace hub;
+    DispatchGuard guard;
+
+    SECTION("selected level") {
+        REQUIRE(cpu::isa() <= cpu::detected_isa());
+        cpu::max_isa = cpu::Isa::SSE2;
+        REQUIRE(cpu::isa() == cpu::Isa::SSE2);
+        REQUIRE(std::string(cpu::isa_name(cpu::Isa::AVX512)) == "AVX-512");
+    }
+
+    auto ptc = utest_random_particles<Particle, Particles>(53);
+
+    SECTION("pair kernel") {
+        force::kernel::inv_sqrt_policy = force::kernel::InvSqrt::Exact;
+        check_isa_levels(
+            ptc, [](auto &s) { return force::kernel::newtonian_pair_acc<true>(s, 1); }, 1e-13);
+    }
+
+    SECTION("pair kernel with Newton-Raphson rsqrt") {
+        force::kernel::inv_sqrt_policy = force::kernel::InvSqrt::Newton;
+        check_isa_levels(
+            ptc, [](auto &s) { return force::kernel::newtonian_pair_acc<true>(s, 1); }, 1e-12);
+    }
+
+    SECTION("mixed precision kernel") {
+        check_isa_levels(
+            ptc, [](auto &s) { return force::kernel::newtonian_mixed_pair_acc<true>(s, 0.25, 1); }, 1e-5);
+    }
+
+    SECTION("element-wise arrays") {
+        for (size_t n : {size_t{7}, cpu::multiversion_threshold + 13}) {
+            ScalarArray a(n), b(n), sum(n), expected(n);
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = UTEST_RAND, b[i] = UTEST_RAND;
+                expected[i] = a[i] + b[i] * 0.3;
+            }
+            calc::array_advance(sum, a, b, 0.3);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(sum[i] == expected[i]);
+            }
+        }
+    }
+}
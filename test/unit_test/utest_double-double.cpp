@@ -0,0 +1,99 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/double-double.hpp"
+#include "../../src/spaceHub.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using hub::dd_real;
+
+    constexpr double dd_tol = 1e-30;
+
+    /**
+     * Relative difference of two double-double numbers, in double.
+     */
+    double rel_diff(dd_real const &a, dd_real const &b) {
+        auto scale = fabs(b);
+        return static_cast<double>(scale == 0 ? fabs(a - b) : fabs(a - b) / scale);
+    }
+
+    dd_real parse(char const *str) { return dd_real::from_string(str); }
+}  // namespace
+
+TEST_CASE("double-double") {
+    using namespace hub;
+
+    SECTION("error free transformations") {
+        dd_real a{1.0};
+        a += 1e-20;
+        REQUIRE(a.hi == 1.0);
+        REQUIRE(a.lo == 1e-20);
+        REQUIRE(static_cast<double>(a - 1.0) == 1e-20);
+
+        dd_real third = dd_real{1.0} / 3.0;
+        REQUIRE(rel_diff(third * 3.0, dd_real{1.0}) < dd_tol);
+        REQUIRE(rel_diff(third, parse("0.33333333333333333333333333333333333")) < dd_tol);
+    }
+
+    SECTION("elementary functions") {
+        REQUIRE(rel_diff(sqrt(dd_real{2.0}), parse("1.4142135623730950488016887242096981")) < dd_tol);
+        REQUIRE(rel_diff(exp(dd_real{1.0}), parse("2.7182818284590452353602874713526625")) < dd_tol);
+        REQUIRE(rel_diff(log(dd_real{10.0}), parse("2.3025850929940456840179914546843642")) < dd_tol);
+        REQUIRE(rel_diff(atan(dd_real{1.0}) * 4, parse("3.1415926535897932384626433832795029")) < dd_tol);
+        REQUIRE(rel_diff(sin(dd_real{1.0}), parse("0.84147098480789650665250232163029900")) < dd_tol);
+        REQUIRE(rel_diff(cos(dd_real{1.0}), parse("0.54030230586813971740093660744297661")) < dd_tol);
+        REQUIRE(rel_diff(pow(dd_real{2.0}, dd_real{0.5}), sqrt(dd_real{2.0})) < dd_tol);
+        REQUIRE(rel_diff(cbrt(dd_real{27.0}), dd_real{3.0}) < dd_tol);
+    }
+
+    SECTION("string round trip") {
+        for (size_t i = 0; i < 100; ++i) {
+            dd_real x = dd_real{UTEST_RAND} / 7.0 * std::pow(10.0, static_cast<int>(UTEST_RAND * 30));
+            REQUIRE(rel_diff(dd_real::from_string(x.to_string(34)), x) < dd_tol);
+        }
+    }
+
+    SECTION("numeric limits") {
+        REQUIRE(std::numeric_limits<dd_real>::digits == 106);
+        REQUIRE(math::epsilon_v<dd_real> < 1e-30);
+    }
+
+    SECTION("two body orbit") {
+        using Method = methods::AR_Chain_DD<>;
+        using Particle = typename methods::DefaultMethod<>::Particle;
+        using namespace unit;
+
+        Particle sun{1_Ms}, earth{1_Me};
+        auto orbit = orbit::Elliptic(sun.mass, earth.mass, 1_AU, 0.5, 0, 0, 0, 0);
+        orbit::move_particles(orbit, earth);
+        orbit::move_to_COM_frame(sun, earth);
+
+        Method::RunArgs args;
+        args.rtol = 1e-20;
+        args.atol = 0;
+        args.add_stop_condition(dd_real{1_year});
+
+        Method sim{0, std::vector{sun, earth}};
+        auto E0 = calc::calc_total_energy(sim.particles());
+        sim.run(args);
+        REQUIRE(fabs(static_cast<double>(calc::calc_energy_error(sim.particles(), E0))) < 1e-20);
+    }
+}
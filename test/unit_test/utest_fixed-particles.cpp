@@ -0,0 +1,125 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/interaction/post-newtonian.hpp"
+#include "../../src/particle-system/archain.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/chain-system.hpp"
+#include "../../src/particle-system/regu-system.hpp"
+#include "../../src/particles/fixed-particles.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Dynamic = hub::particles::PointParticles<Type>;
+    using Particle = typename Dynamic::Particle;
+    constexpr size_t N = 4;
+    using Fixed = hub::particles::FixedParticles<Type, N>;
+
+    template <typename ArrayA, typename ArrayB>
+    void check_vectors(ArrayA const &a, ArrayB const &b) {
+        REQUIRE(a.size() == b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            REQUIRE(a[i].x == Approx(b[i].x).epsilon(1e-13));
+            REQUIRE(a[i].y == Approx(b[i].y).epsilon(1e-13));
+            REQUIRE(a[i].z == Approx(b[i].z).epsilon(1e-13));
+        }
+    }
+
+    template <template <typename, typename> typename System, typename Interactions>
+    void check_against_dynamic(std::vector<Particle> const &particle_set) {
+        System<Fixed, Interactions> fixed(0, particle_set);
+        System<Dynamic, Interactions> dynamic(0, particle_set);
+
+        for (size_t step = 0; step < 20; ++step) {
+            fixed.pre_iter_process(), dynamic.pre_iter_process();
+            fixed.drift(5e-4), dynamic.drift(5e-4);
+            fixed.kick(1e-3), dynamic.kick(1e-3);
+            fixed.drift(5e-4), dynamic.drift(5e-4);
+            fixed.post_iter_process(), dynamic.post_iter_process();
+        }
+        check_vectors(fixed.pos(), dynamic.pos());
+        check_vectors(fixed.vel(), dynamic.vel());
+
+        std::vector<utest_scalar> y_fixed, y_dynamic;
+        fixed.write_to_scalar_array(y_fixed);
+        dynamic.write_to_scalar_array(y_dynamic);
+        REQUIRE(y_fixed.size() == y_dynamic.size());
+        for (size_t k = 0; k < y_fixed.size(); ++k) {
+            REQUIRE(y_fixed[k] == Approx(y_dynamic[k]).epsilon(1e-13));
+        }
+
+        for (auto &y : y_fixed) y *= 1.5;
+        fixed.read_from_scalar_array(y_fixed);
+        std::vector<utest_scalar> y_back;
+        fixed.write_to_scalar_array(y_back);
+        REQUIRE(y_back == y_fixed);
+    }
+
+    template <typename System>
+    using Simple = hub::system::SimpleSystem<System, hub::force::Interactions<hub::force::NewtonianGrav>>;
+}  // namespace
+
+TEST_CASE("fixed particles") {
+    using namespace hub;
+    using Newtonian = force::Interactions<force::NewtonianGrav>;
+    using PN = force::Interactions<force::NewtonianGrav, force::PN1>;
+
+    auto particle_set = utest_random_particles<Particle>(N, 1);
+
+    SECTION("fixed array") {
+        FixedArray<size_t, N> a;
+        STATIC_REQUIRE(a.size() == N);
+        STATIC_REQUIRE(static_size_v<decltype(a)> == N);
+        STATIC_REQUIRE(static_size_v<typename Dynamic::VectorArray> == 0);
+        a.clear();
+        for (size_t i = 0; i < N; ++i) a.emplace_back(N - i);
+        REQUIRE(a.front() == N);
+        REQUIRE(a.back() == 1);
+        auto b = a;
+        REQUIRE(a == b);
+        b[0] = 0;
+        REQUIRE(a != b);
+    }
+
+    SECTION("newtonian") {
+        Fixed fixed(0, particle_set);
+        Dynamic dynamic(0, particle_set);
+        typename Fixed::VectorArray acc_fixed;
+        typename Dynamic::VectorArray acc_dynamic(N);
+        utest_scalar pot_fixed{0}, pot_dynamic{0};
+        force::NewtonianGrav::add_acc_to(fixed, acc_fixed, pot_fixed);
+        force::NewtonianGrav::add_acc_to(dynamic, acc_dynamic, pot_dynamic);
+        check_vectors(acc_fixed, acc_dynamic);
+        REQUIRE(pot_fixed == Approx(pot_dynamic).epsilon(1e-14));
+    }
+
+    SECTION("simple system") { check_against_dynamic<system::SimpleSystem, PN>(particle_set); }
+
+    SECTION("chain system") { check_against_dynamic<system::ChainSystem, PN>(particle_set); }
+
+    SECTION("regularized system") {
+        check_against_dynamic<system::RegularizedSystem, Newtonian>(particle_set);
+    }
+
+    SECTION("ARchain system") { check_against_dynamic<system::ARchainSystem, PN>(particle_set); }
+}
@@ -0,0 +1,164 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../catch.hpp"
+#include "utest.hpp"
+#include "../../src/integrator/Gauss-Radau.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/IAS15.hpp"
+#include "../../src/ode-iterator/error-checker/max-ratio-error.hpp"
+#include "../../src/ode-iterator/step-controller/PID-controller.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particle-system/chain-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/simulator.hpp"
+
+namespace {
+    using namespace hub;
+    using Type = Types<utest_scalar>;
+    using Force = force::Interactions<force::NewtonianGrav>;
+    using Particles = particles::PointParticles<Type>;
+    using System = system::SimpleSystem<Particles, Force>;
+    using Particle = typename System::Particle;
+    template <template <typename> typename Integrator>
+    using IAS15Of = ode::IAS15<Integrator<Type>, ode::MaxRatioError<Type>, ode::PIDController<Type>>;
+    using IAS15 = IAS15Of<integrator::GaussRadau>;
+
+    /**
+     * Keplerian orbit of eccentricity 0.5 starting at the periapsis.
+     */
+    std::vector<Particle> kepler_orbit() {
+        return {Particle{1, 0, 0, 0, 0, 0, 0}, Particle{1e-3, 1, 0, 0, 0, sqrt(1.5 * 1.001), 0}};
+    }
+
+    /**
+     * Integrate the Keplerian orbit over one period and check that the relative orbit returns to its initial state.
+     */
+    template <typename Sys, template <typename> typename Integrator>
+    Sys integrate_one_period() {
+        using Simulator = hub::Simulator<Sys, IAS15Of<Integrator>>;
+        auto particle_set = kepler_orbit();
+        utest_scalar const period = 2 * consts::pi * sqrt(8 / 1.001);
+        typename Simulator::RunArgs args;
+        args.time_rtol = 1e-15;
+        args.add_stop_condition(period);
+        Simulator sim{0, particle_set};
+        sim.run(args);
+
+        auto const &sys = sim.particles();
+        REQUIRE(sys.time() == Approx(period).epsilon(1e-15));
+        REQUIRE(norm(sys.pos(1) - sys.pos(0) - particle_set[1].pos + particle_set[0].pos) < 1e-10);
+        REQUIRE(norm(sys.vel(1) - sys.vel(0) - particle_set[1].vel + particle_set[0].vel) < 1e-10);
+        return sys;
+    }
+
+    template <typename Sys>
+    void check_second_order() {
+        auto first = integrate_one_period<Sys, integrator::GaussRadau>();
+        auto second = integrate_one_period<Sys, integrator::GaussRadau2nd>();
+        for (size_t j = 0; j < first.number(); ++j) {
+            REQUIRE(norm(first.pos(j) - second.pos(j)) < 1e-10);
+            REQUIRE(norm(first.vel(j) - second.vel(j)) < 1e-10);
+        }
+    }
+}  // namespace
+
+TEST_CASE("Gauss-Radau second order form") {
+    SECTION("simple system") { check_second_order<System>(); }
+
+    SECTION("chain system") { check_second_order<system::ChainSystem<Particles, Force>>(); }
+
+    SECTION("table size") {
+        System sys(0, kepler_orbit());
+        integrator::GaussRadau2nd<Type> radau;
+        radau.integrate(sys, 1e-2);
+        REQUIRE(radau.b()[0].size() == 3 * sys.number());
+    }
+}
+
+TEST_CASE("IAS15 interpolation") {
+    auto particle_set = kepler_orbit();
+    System sys(0, particle_set);
+    System start = sys;
+    IAS15 iterator;
+    iterator.set_dense_output(true);
+    iterator.iterate(sys, 1e-2);
+
+    System out = sys;
+    iterator.interpolate(out, 0);
+    REQUIRE(out.time() == start.time());
+    for (size_t j = 0; j < particle_set.size(); ++j) {
+        REQUIRE(norm(out.pos(j) - start.pos(j)) == 0);
+        REQUIRE(norm(out.vel(j) - start.vel(j)) == 0);
+    }
+
+    iterator.interpolate(out, 1);
+    REQUIRE(out.time() == sys.time());
+    for (size_t j = 0; j < particle_set.size(); ++j) {
+        REQUIRE(norm(out.pos(j) - sys.pos(j)) == 0);
+        REQUIRE(norm(out.vel(j) - sys.vel(j)) == 0);
+    }
+
+    iterator.dense_output(out, 0.5 * (iterator.dense_begin_time() + iterator.dense_end_time()));
+    REQUIRE(out.time() == Approx(0.5 * sys.time()).epsilon(1e-15));
+}
+
+TEST_CASE("IAS15 dense output") {
+    using Simulator = hub::Simulator<System, IAS15>;
+    auto particle_set = kepler_orbit();
+    utest_scalar const end = 12;
+    size_t const num = 25;
+
+    auto reference = [&](utest_scalar time) {
+        typename Simulator::RunArgs args;
+        args.time_rtol = 1e-15;
+        args.add_stop_condition(time);
+        Simulator sim{0, particle_set};
+        sim.run(args);
+        return sim.particles();
+    };
+
+    std::vector<System> outputs;
+    typename Simulator::RunArgs args;
+    args.add_stop_condition(end);
+    args.add_dense_operation(end / (num + 1), end - end / (num + 1), num,
+                             [&](auto &ptc, auto) { outputs.push_back(ptc); });
+    Simulator sim{0, particle_set};
+    sim.run(args);
+
+    REQUIRE(outputs.size() == num);
+    for (size_t i = 0; i < num; ++i) {
+        auto const &out = outputs[i];
+        REQUIRE(out.time() == Approx(args.dense_times()[i]).epsilon(1e-14));
+        auto ref = reference(out.time());
+        for (size_t j = 0; j < particle_set.size(); ++j) {
+            REQUIRE(norm(out.pos(j) - ref.pos(j)) < 1e-8);
+            REQUIRE(norm(out.vel(j) - ref.vel(j)) < 1e-8);
+        }
+    }
+
+    // the last step is interpolated back to the end time instead of being shortened
+    auto const &last = sim.particles();
+    REQUIRE(last.time() == Approx(end).epsilon(1e-14));
+    auto ref = reference(end);
+    for (size_t j = 0; j < particle_set.size(); ++j) {
+        REQUIRE(norm(last.pos(j) - ref.pos(j)) < 1e-8);
+        REQUIRE(norm(last.vel(j) - ref.vel(j)) < 1e-8);
+    }
+}
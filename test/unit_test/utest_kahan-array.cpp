@@ -0,0 +1,149 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/core-computation.hpp"
+#include "../../src/kahan-array.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using KahanNum = hub::double_k;
+    using SoA = hub::KahanArray<double>;
+    using AoS = hub::SSO_vector<KahanNum>;
+    using Array = hub::SSO_vector<double>;
+
+    template <typename A>
+    A make_state(size_t n) {
+        A a(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = 1.0 + i;
+        }
+        return a;
+    }
+
+    void check_same(SoA const &soa, AoS const &aos) {
+        REQUIRE(soa.size() == aos.size());
+        for (size_t i = 0; i < soa.size(); ++i) {
+            REQUIRE(soa[i].real == aos[i].real);
+            REQUIRE(soa[i].err == aos[i].err);
+        }
+    }
+}  // namespace
+
+TEST_CASE("Kahan array") {
+    using namespace hub;
+
+    SECTION("state scalar array") {
+        static_assert(std::is_same_v<Types<double_k>::StateScalarArray, SoA>);
+        static_assert(std::is_same_v<Types<double>::StateScalarArray, SSO_vector<double>>);
+    }
+
+    SECTION("element proxy") {
+        SoA a(3);
+        a[0] = 1.0;
+        for (size_t i = 0; i < 1000; ++i) {
+            a[0] += 1e-17;
+        }
+        KahanNum k{1.0};
+        for (size_t i = 0; i < 1000; ++i) {
+            k += 1e-17;
+        }
+        REQUIRE(std::as_const(a)[0].real == k.real);
+        REQUIRE(std::as_const(a)[0].err == k.err);
+        REQUIRE(std::as_const(a)[0].err != 0);
+
+        a[1] = a[0];
+        REQUIRE(std::as_const(a)[1].err == std::as_const(a)[0].err);
+        a[2] = 2.0;
+        REQUIRE(std::as_const(a)[2].err == 0);
+        double d = a[0];
+        REQUIRE(d == k.real);
+    }
+
+    SECTION("container interface") {
+        SoA a;
+        a.reserve(4);
+        a.emplace_back(1.0);
+        a.emplace_back(KahanNum{2.0});
+        a.push_back(3.0);
+        REQUIRE(a.size() == 3);
+        REQUIRE(*(a.begin() + 1) == 2.0);
+        REQUIRE(a.end() - a.begin() == 3);
+
+        Array b(3);
+        std::copy(a.begin(), a.end(), b.begin());
+        REQUIRE(b[2] == 3.0);
+
+        auto it = a.begin() + 2;
+        *it += 1.0;
+        REQUIRE(std::as_const(a)[2].real == 4.0);
+
+        calc::array_set_zero(a);
+        REQUIRE(std::as_const(a)[0].real == 0);
+        a.clear();
+        REQUIRE(a.empty());
+    }
+
+    SECTION("array operations match the array of Kahan numbers") {
+        for (size_t n : {size_t{5}, cpu::multiversion_threshold + 7}) {
+            auto soa = make_state<SoA>(n);
+            auto aos = make_state<AoS>(n);
+            Array inc(n);
+            for (size_t i = 0; i < n; ++i) {
+                inc[i] = UTEST_RAND * 1e-9;
+            }
+
+            for (size_t k = 0; k < 100; ++k) {
+                calc::array_advance(soa, inc, 1e-7);
+                calc::array_advance(aos, inc, 1e-7);
+                calc::array_advance(soa, inc);
+                calc::array_advance(aos, inc);
+            }
+            check_same(soa, aos);
+
+            calc::array_scale(soa, inc, 0.5);
+            calc::array_scale(aos, inc, 0.5);
+            check_same(soa, aos);
+
+            calc::array_add(soa, inc, soa);
+            calc::array_add(aos, inc, aos);
+            check_same(soa, aos);
+
+            calc::array_advance(soa, aos, inc, 0.3);
+            calc::array_advance(aos, aos, inc, 0.3);
+            check_same(soa, aos);
+        }
+    }
+
+    SECTION("compensation helpers") {
+        auto soa = make_state<SoA>(4);
+        Array err(4), saved(4);
+        for (size_t i = 0; i < 4; ++i) {
+            err[i] = 1e-20 * (i + 1);
+        }
+        calc::array_load_err(soa, err);
+        calc::array_save_err(saved, soa);
+        for (size_t i = 0; i < 4; ++i) {
+            REQUIRE(saved[i] == err[i]);
+        }
+        calc::array_set_err_zero(soa);
+        REQUIRE(std::as_const(soa)[3].err == 0);
+    }
+}
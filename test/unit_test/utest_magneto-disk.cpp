@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <cmath>
+
+#include "../../src/interaction/magneto-disk.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Vector = typename hub::Types<double>::Vector;
+
+    // log-space interpolation of the raw tables, as the profile was evaluated before tabulation.
+    template <typename Array>
+    double raw_profile(double lgR, Array const &table) {
+        auto const &lgr = hub::force::_mag_disk_lgr_cgs;
+        lgR = std::clamp(lgR, lgr.front(), lgr.back());
+        size_t idx = std::upper_bound(lgr.begin(), lgr.end(), lgR) - lgr.begin();
+        idx = std::clamp(idx, size_t{1}, lgr.size() - 1) - 1;
+        double t = (lgR - lgr[idx]) / (lgr[idx + 1] - lgr[idx]);
+        return table[idx] + t * (table[idx + 1] - table[idx]);
+    }
+}  // namespace
+
+TEST_CASE("magneto disk profile") {
+    using hub::force::MagnetoDisk;
+    auto const &lgr = hub::force::_mag_disk_lgr_cgs;
+    double v_scale = 3.357318203286629e-07 * 1.2e7;
+
+    for (size_t k = 0; k < 2000; ++k) {
+        double lgR = lgr.front() - 0.5 + (lgr.back() - lgr.front() + 1) * (UTEST_RAND + 1) / 2;
+        double R = std::pow(10.0, lgR) * hub::unit::cm;
+        double phi = hub::consts::pi * UTEST_RAND;
+        Vector r{R * cos(phi), R * sin(phi), UTEST_RAND};
+
+        double rho = std::pow(10.0, raw_profile(lgR, hub::force::_mag_disk_lgrho_cgs)) / 5.893333333333333e-07;
+        double H = std::pow(10.0, raw_profile(lgR, hub::force::_mag_disk_lgH_cgs)) / 1.5e13;
+        double v = raw_profile(lgR, hub::force::_mag_disk_v_cgs) * 3.357318203286629e-07;
+
+        REQUIRE(MagnetoDisk::disk_rho(r) == Approx(rho).epsilon(1e-9));
+        REQUIRE(MagnetoDisk::disk_H(r) == Approx(H).epsilon(1e-9));
+
+        auto v_disk = MagnetoDisk::disk_v(r);
+        REQUIRE(v_disk.x == Approx(-v * sin(phi)).margin(1e-12 * v_scale));
+        REQUIRE(v_disk.y == Approx(v * cos(phi)).margin(1e-12 * v_scale));
+        REQUIRE(v_disk.z == 0);
+    }
+}
@@ -0,0 +1,368 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/interaction/interaction.hpp"
+#include "../../src/interaction/mixed-newtonian.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/interaction/post-newtonian.hpp"
+#include "../../src/particle-system/chain.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+    using IdxArray = typename Type::IdxArray;
+
+    struct ChainedParticles : public Particles {
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Particles);
+
+        explicit ChainedParticles(Particles const &ptc) : Particles(ptc) {
+            hub::Chain::calc_chain_index(this->pos(), idx_);
+            ch_pos_.resize(this->number());
+            hub::Chain::calc_chain(this->pos(), ch_pos_, idx_);
+            ch_vel_.resize(this->number());
+            hub::Chain::calc_chain(this->vel(), ch_vel_, idx_);
+        }
+
+        [[nodiscard]] VectorArray const &chain_pos() const { return ch_pos_; }
+
+        [[nodiscard]] VectorArray const &chain_vel() const { return ch_vel_; }
+
+        [[nodiscard]] IdxArray const &index() const { return idx_; }
+
+       private:
+        VectorArray ch_pos_;
+        VectorArray ch_vel_;
+        IdxArray idx_;
+    };
+
+    template <typename Base>
+    struct CompactParticles : public Base {
+        explicit CompactParticles(Base const &ptc) : Base(ptc) { pairs_.rebuild(*this); }
+
+        [[nodiscard]] hub::force::CompactPairs const &compact_pairs() const { return pairs_; }
+
+       private:
+        hub::force::CompactPairs pairs_;
+    };
+
+    template <typename Base>
+    struct RunParticles : public Base {
+        RunParticles(Base const &ptc, double rtol) : Base(ptc), rtol_{rtol} {}
+
+        [[nodiscard]] double force_rtol() const { return rtol_; }
+
+       private:
+        double rtol_;
+    };
+
+    void require_close(VectorArray const &acc, VectorArray const &expected) {
+        REQUIRE(acc.size() == expected.size());
+        for (size_t i = 0; i < acc.size(); ++i) {
+            auto scale = norm(expected[i]);
+            REQUIRE(acc[i].x == Approx(expected[i].x).margin(1e-12 * scale));
+            REQUIRE(acc[i].y == Approx(expected[i].y).margin(1e-12 * scale));
+            REQUIRE(acc[i].z == Approx(expected[i].z).margin(1e-12 * scale));
+        }
+    }
+
+    template <typename Ptc>
+    void check_fused_pairs(Ptc const &ptc) {
+        using namespace hub::force;
+        using Fused = Interactions<NewtonianGrav, PN1, PN2, PN2p5>;
+        size_t n = ptc.number();
+
+        VectorArray separate(n), fused(n);
+        PN1::add_acc_to(ptc, separate);
+        PN2::add_acc_to(ptc, separate);
+        PN2p5::add_acc_to(ptc, separate);
+        Fused::eval_extra_acc(ptc, fused);
+        require_close(fused, separate);
+
+        NewtonianGrav::add_acc_to(ptc, separate);
+        Fused::eval_acc(ptc, fused);
+        require_close(fused, separate);
+    }
+
+    VectorArray direct_acc(Particles const &ptc) {
+        size_t n = ptc.number();
+        VectorArray acc(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (i != j) {
+                    auto dr = ptc.pos(j) - ptc.pos(i);
+                    auto r = norm(dr);
+                    acc[i] += dr * (ptc.mass(j) / (r * r * r));
+                }
+            }
+        }
+        return acc;
+    }
+
+    double direct_pot(Particles const &ptc) {
+        double pot = 0;
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            for (size_t j = i + 1; j < ptc.number(); ++j) {
+                pot -= ptc.mass(i) * ptc.mass(j) / norm(ptc.pos(j) - ptc.pos(i));
+            }
+        }
+        return pot * hub::consts::G;
+    }
+
+    template <typename Ptc>
+    void check_against_direct(Ptc const &ptc) {
+        auto expected = direct_acc(ptc);
+        VectorArray acc(ptc.number());
+        hub::force::NewtonianGrav::add_acc_to(ptc, acc);
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            auto scale = norm(expected[i]);
+            REQUIRE(acc[i].x == Approx(expected[i].x).margin(1e-12 * scale));
+            REQUIRE(acc[i].y == Approx(expected[i].y).margin(1e-12 * scale));
+            REQUIRE(acc[i].z == Approx(expected[i].z).margin(1e-12 * scale));
+        }
+    }
+}  // namespace
+
+TEST_CASE("newtonian gravity") {
+    for (size_t n : std::initializer_list<size_t>{2, 3, 5, 8, 9, 13, 16, 17, 31, 64, 100, hub::force::kernel::parallel_threshold + 3}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n);
+
+        SECTION("pairwise n=" + std::to_string(n)) { check_against_direct(ptc); }
+
+        SECTION("chain n=" + std::to_string(n)) {
+            if (n > 2) {
+                check_against_direct(ChainedParticles{ptc});
+            }
+        }
+    }
+}
+
+TEST_CASE("newtonian potential") {
+    for (size_t n : std::initializer_list<size_t>{3, 5, 17, 100, hub::force::kernel::parallel_threshold + 3}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n);
+        auto expected = direct_pot(ptc);
+
+        SECTION("pairwise n=" + std::to_string(n)) {
+            REQUIRE(hub::calc::calc_potential_energy(ptc) == Approx(expected).epsilon(1e-12));
+        }
+
+        SECTION("chain n=" + std::to_string(n)) {
+            REQUIRE(hub::calc::calc_potential_energy(ChainedParticles{ptc}) == Approx(expected).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("newtonian parallel reduction") {
+    auto ptc = utest_random_particles<Particle, Particles>(hub::force::kernel::parallel_threshold * 2);
+
+    VectorArray acc1(ptc.number()), acc2(ptc.number());
+    hub::force::NewtonianGrav::add_acc_to(ptc, acc1);
+    hub::force::NewtonianGrav::add_acc_to(ptc, acc2);
+
+    for (size_t i = 0; i < ptc.number(); ++i) {
+        REQUIRE(acc1[i].x == acc2[i].x);
+        REQUIRE(acc1[i].y == acc2[i].y);
+        REQUIRE(acc1[i].z == acc2[i].z);
+    }
+    REQUIRE(hub::calc::calc_potential_energy(ptc) == hub::calc::calc_potential_energy(ptc));
+}
+
+TEST_CASE("fused pair interactions") {
+    for (size_t n : std::initializer_list<size_t>{2, 3, 5, 17}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n, 0.01 * hub::consts::C);
+
+        SECTION("pairwise n=" + std::to_string(n)) { check_fused_pairs(ptc); }
+
+        SECTION("chain n=" + std::to_string(n)) {
+            if (n > 2) {
+                check_fused_pairs(ChainedParticles{ptc});
+            }
+        }
+    }
+}
+
+TEST_CASE("newtonian potential by-product") {
+    using namespace hub::force;
+    for (size_t n : std::initializer_list<size_t>{3, 5, 17, 100, kernel::parallel_threshold + 3}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n);
+        auto expected = direct_pot(ptc);
+
+        auto check = [&](auto const &p) {
+            VectorArray acc(n), acc_with_pot(n);
+            utest_scalar pot = 0;
+            NewtonianGrav::add_acc_to(p, acc);
+            NewtonianGrav::add_acc_to(p, acc_with_pot, pot);
+            REQUIRE(pot == Approx(expected).epsilon(1e-12));
+            require_close(acc_with_pot, acc);
+
+            Interactions<NewtonianGrav, PN1>::eval_acc(p, acc, pot);
+            REQUIRE(pot == Approx(expected).epsilon(1e-12));
+        };
+
+        SECTION("pairwise n=" + std::to_string(n)) { check(ptc); }
+
+        SECTION("chain n=" + std::to_string(n)) { check(ChainedParticles{ptc}); }
+    }
+}
+
+TEST_CASE("compact post-newtonian pairs") {
+    using namespace hub::force;
+    size_t n = 6;
+    auto ptc = utest_random_particles<Particle, Particles>(n, 0.01 * hub::consts::C);
+    ptc.pos(1) = ptc.pos(0) + typename Type::Vector{1e-3, 0, 0};
+
+    auto m01 = ptc.mass(0) + ptc.mass(1);
+    CompactPairs::threshold = 0.5 * hub::consts::G * m01 / (1e-3 * hub::consts::C * hub::consts::C);
+
+    auto check = [&](auto const &p) {
+        CompactParticles<std::decay_t<decltype(p)>> compact{p};
+        REQUIRE(compact.compact_pairs().size() == 1);
+
+        VectorArray expected(n), acc(n);
+        for_each_pair<true>(p, [&](auto const &pair) {
+            if (pair.i + pair.j == 1) {
+                PN1::add_pair_acc(p, pair, expected);
+                PN2::add_pair_acc(p, pair, expected);
+            }
+        });
+        PN1::add_acc_to(compact, acc);
+        PN2::add_acc_to(compact, acc);
+        require_close(acc, expected);
+
+        NewtonianGrav::add_acc_to(p, expected);
+        Interactions<NewtonianGrav, PN1, PN2>::eval_acc(compact, acc);
+        require_close(acc, expected);
+    };
+
+    SECTION("pairwise") { check(ptc); }
+
+    SECTION("chain") { check(ChainedParticles{ptc}); }
+
+    CompactPairs::threshold = 0;
+}
+
+TEST_CASE("mixed precision newtonian") {
+    using namespace hub::force;
+    MixedNewtonianGrav::max_near_fraction = 1;
+    for (size_t n : std::initializer_list<size_t>{3, 100, kernel::parallel_threshold + 3}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n);
+        auto expected = direct_acc(ptc);
+        auto expected_pot = direct_pot(ptc);
+
+        double M = 0;
+        for (auto m : ptc.mass()) M += m;
+        auto acc_scale = hub::consts::G * M;
+
+        auto check = [&](auto const &p, double tol) {
+            VectorArray acc(n);
+            double pot = 0;
+            MixedNewtonianGrav::add_acc_to(p, acc, pot);
+            double max_err = 0;
+            for (size_t i = 0; i < n; ++i) {
+                max_err = std::max(max_err, norm(acc[i] - expected[i]));
+            }
+            REQUIRE(max_err <= std::max(tol, 1e-12) * acc_scale);
+            REQUIRE(pot == Approx(expected_pot).epsilon(std::max(tol, 1e-12)));
+            return max_err;
+        };
+
+        SECTION("no tolerance n=" + std::to_string(n)) {
+            VectorArray acc(n), double_acc(n);
+            MixedNewtonianGrav::add_acc_to(RunParticles{ptc, 0}, acc);
+            NewtonianGrav::add_acc_to(ptc, double_acc);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(acc[i].x == double_acc[i].x);
+                REQUIRE(acc[i].y == double_acc[i].y);
+                REQUIRE(acc[i].z == double_acc[i].z);
+            }
+        }
+
+        SECTION("tolerance n=" + std::to_string(n)) {
+            auto err = check(RunParticles{ptc, 1e-6}, 1e-6);
+            if (n > kernel::soa_threshold) {
+                REQUIRE(err > 1e-12 * acc_scale);
+            }
+            check(RunParticles{ChainedParticles{ptc}, 1e-6}, 1e-6);
+        }
+
+        SECTION("tight tolerance n=" + std::to_string(n)) {
+            check(RunParticles{ptc, 1e-14}, 1e-12);
+            check(RunParticles{ChainedParticles{ptc}, 1e-14}, 1e-12);
+        }
+
+        SECTION("tolerance per system n=" + std::to_string(n)) {
+            RunParticles loose{ptc, 1e-6}, tight{ptc, 1e-14};
+            REQUIRE(MixedNewtonianGrav::current_tolerance(loose) == 1e-6);
+            REQUIRE(MixedNewtonianGrav::current_tolerance(tight) == 1e-14);
+            REQUIRE(MixedNewtonianGrav::current_tolerance(ptc) == 0);
+            check(tight, 1e-12);
+        }
+
+        SECTION("tolerance override n=" + std::to_string(n)) {
+            MixedNewtonianGrav::tolerance = 1e-6;
+            check(RunParticles{ptc, 1e-14}, 1e-6);
+            MixedNewtonianGrav::tolerance = 0;
+        }
+    }
+    MixedNewtonianGrav::max_near_fraction = 1.0 / 32;
+}
+
+TEST_CASE("newton reciprocal square root") {
+    using namespace hub::force;
+
+    SECTION("scalar") {
+        for (size_t k = 0; k < RAND_TEST_NUM; ++k) {
+            double x = (UTEST_RAND + 1.1) * std::pow(10.0, 30 * UTEST_RAND);
+            REQUIRE(kernel::rsqrt_newton(x) == Approx(1 / std::sqrt(x)).epsilon(4 * UTEST_EPSILON));
+        }
+    }
+
+    for (size_t n : std::initializer_list<size_t>{3, 17, 100, kernel::parallel_threshold + 3}) {
+        auto ptc = utest_random_particles<Particle, Particles>(n, 0.01 * hub::consts::C);
+
+        auto check = [&](auto const &p) {
+            using Forces = Interactions<NewtonianGrav, PN1, PN2, PN2p5>;
+            VectorArray exact(n), newton(n), exact_pn(n), newton_pn(n);
+
+            kernel::inv_sqrt_policy = kernel::InvSqrt::Exact;
+            NewtonianGrav::add_acc_to(p, exact);
+            Forces::eval_extra_acc(p, exact_pn);
+            auto exact_pot = hub::calc::calc_potential_energy(p);
+
+            kernel::inv_sqrt_policy = kernel::InvSqrt::Newton;
+            NewtonianGrav::add_acc_to(p, newton);
+            Forces::eval_extra_acc(p, newton_pn);
+            auto newton_pot = hub::calc::calc_potential_energy(p);
+            kernel::inv_sqrt_policy = kernel::InvSqrt::Exact;
+
+            require_close(newton, exact);
+            require_close(newton_pn, exact_pn);
+            REQUIRE(newton_pot == Approx(exact_pot).epsilon(1e-13));
+        };
+
+        SECTION("pairwise n=" + std::to_string(n)) { check(ptc); }
+
+        SECTION("chain n=" + std::to_string(n)) { check(ChainedParticles{ptc}); }
+    }
+}
@@ -0,0 +1,247 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include <array>
+#include <cmath>
+#include <sstream>
+
+#include "../../src/integrator/Gauss-Radau.hpp"
+#include "../../src/interaction/newtonian.hpp"
+#include "../../src/ode-iterator/IAS15.hpp"
+#include "../../src/ode-iterator/error-checker/max-ratio-error.hpp"
+#include "../../src/ode-iterator/step-controller/PID-controller.hpp"
+#include "../../src/particle-system/base-system.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/particles/space-filling-curve.hpp"
+#include "../../src/simulator.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using Order = hub::particles::SpaceFillingOrder;
+    using hub::particles::SpaceFillingCurve;
+
+    /**
+     * Jittered 7x7x7 lattice, smooth enough to be integrated over many steps by the adaptive iterators.
+     */
+    std::vector<Particle> jittered_lattice() {
+        std::vector<Particle> particle_set;
+        for (size_t n = 0; n < 343; ++n) {
+            double x = n % 7 + 0.3 * std::sin(1.3 * n);
+            double y = n / 7 % 7 + 0.3 * std::sin(2.9 * n);
+            double z = n / 49 + 0.3 * std::sin(5.1 * n);
+            particle_set.emplace_back(Particle{1 + 0.5 * std::cos(n), x, y, z, 0.1 * std::sin(0.7 * n),
+                                               0.1 * std::cos(1.7 * n), 0.1 * std::sin(3.7 * n)});
+        }
+        return particle_set;
+    }
+}  // namespace
+
+TEST_CASE("space filling curve keys") {
+    SECTION("morton") {
+        REQUIRE(Order::morton_key(0, 0, 1) == 1);
+        REQUIRE(Order::morton_key(0, 1, 0) == 2);
+        REQUIRE(Order::morton_key(1, 0, 0) == 4);
+        REQUIRE(Order::morton_key(3, 0, 0) == 36);
+        REQUIRE(Order::morton_key(0x1fffff, 0x1fffff, 0x1fffff) == (uint64_t{1} << 63) - 1);
+    }
+
+    SECTION("hilbert walks neighbouring cells") {
+        constexpr uint32_t level = 3;
+        constexpr uint32_t side = 1u << level;
+        constexpr uint32_t shift = Order::bits - level;
+        std::vector<std::pair<uint64_t, std::array<uint32_t, 3>>> cells;
+        for (uint32_t x = 0; x < side; ++x)
+            for (uint32_t y = 0; y < side; ++y)
+                for (uint32_t z = 0; z < side; ++z)
+                    cells.push_back({Order::hilbert_key(x << shift, y << shift, z << shift), {x, y, z}});
+        std::sort(cells.begin(), cells.end());
+        for (size_t k = 1; k < cells.size(); ++k) {
+            REQUIRE(cells[k].first != cells[k - 1].first);
+            uint32_t dist = 0;
+            for (size_t d = 0; d < 3; ++d) {
+                auto a = cells[k].second[d], b = cells[k - 1].second[d];
+                dist += a > b ? a - b : b - a;
+            }
+            REQUIRE(dist == 1);
+        }
+    }
+}
+
+TEST_CASE("space filling curve reorder") {
+    auto particle_set = utest_random_particles<Particle>(300, 0.1);
+
+    SECTION("particle properties move with the id") {
+        Particles ptc(0, particle_set);
+        std::vector<size_t> order;
+        Order::sort(ptc.pos(), ptc.number(), SpaceFillingCurve::Hilbert, order);
+        ptc.reorder(order);
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            auto const &p = particle_set[ptc.idn(i)];
+            REQUIRE(ptc.mass(i) == p.mass);
+            REQUIRE(ptc.pos(i).x == p.pos.x);
+            REQUIRE(ptc.vel(i).z == p.vel.z);
+        }
+    }
+
+    SECTION("curve order of the step has its own layout key") {
+        using System = hub::system::SimpleSystem<Particles, hub::force::Interactions<hub::force::NewtonianGrav>>;
+        System sys(0, particle_set);
+        System copy{sys};
+        REQUIRE(copy.layout_key() != sys.layout_key());
+
+        Order::curve = SpaceFillingCurve::Hilbert;
+        Order::interval = 2;
+        auto const key = sys.layout_key();
+        sys.pre_iter_process();
+        auto const step_key = sys.layout_key();
+        REQUIRE(step_key != key);
+        REQUIRE(!sys.reorder_delta().empty());
+        sys.post_iter_process();
+        REQUIRE(sys.layout_key() == key);
+
+        sys.pre_iter_process();
+        REQUIRE(sys.layout_key() == step_key);
+        REQUIRE(sys.reorder_delta().empty());
+        sys.post_iter_process();
+
+        sys.pre_iter_process();
+        REQUIRE(sys.layout_key() != step_key);
+        REQUIRE(sys.layout_key() != key);
+        sys.post_iter_process();
+        REQUIRE(sys.layout_key() == key);
+        Order::curve = SpaceFillingCurve::None;
+        Order::interval = 64;
+    }
+
+    SECTION("reordered system evolves as the unordered one") {
+        using System = hub::system::SimpleSystem<Particles, hub::force::Interactions<hub::force::NewtonianGrav>>;
+        for (auto curve : {SpaceFillingCurve::Morton, SpaceFillingCurve::Hilbert}) {
+            System plain(0, particle_set);
+            System sorted(0, particle_set);
+            bool moved = false;
+            auto evolve = [&moved](System &sys) {
+                for (size_t step = 0; step < 10; ++step) {
+                    sys.pre_iter_process();
+                    for (size_t i = 0; i < sys.number(); ++i) {
+                        moved |= (sys.idn(i) != i);
+                    }
+                    sys.drift(5e-5);
+                    sys.kick(1e-4);
+                    sys.drift(5e-5);
+                    sys.post_iter_process();
+                }
+            };
+            Order::curve = SpaceFillingCurve::None;
+            evolve(plain);
+            REQUIRE(!moved);
+            Order::curve = curve;
+            Order::interval = 4;
+            evolve(sorted);
+            Order::curve = SpaceFillingCurve::None;
+            Order::interval = 64;
+
+            // The reordering changes the summation order of the pair forces, so the components agree to rounding
+            // relative to the largest position/velocity of the system, not to their own magnitude.
+            utest_scalar pos_scale = 0;
+            utest_scalar vel_scale = 0;
+            for (size_t i = 0; i < plain.number(); ++i) {
+                pos_scale = std::max(pos_scale, norm(plain.pos(i)));
+                vel_scale = std::max(vel_scale, norm(plain.vel(i)));
+            }
+            auto same = [](auto const &a, auto const &b, utest_scalar scale) {
+                auto approx = [&](utest_scalar x) { return Approx(x).epsilon(1e-12).margin(1e-12 * scale); };
+                return a.x == approx(b.x) && a.y == approx(b.y) && a.z == approx(b.z);
+            };
+
+            REQUIRE(moved);
+            for (size_t i = 0; i < sorted.number(); ++i) {
+                REQUIRE(sorted.idn(i) == i);
+                REQUIRE(same(sorted.pos(i), plain.pos(i), pos_scale));
+                REQUIRE(same(sorted.vel(i), plain.vel(i), vel_scale));
+            }
+
+            std::stringstream ss;
+            ss << sorted;
+            std::string line;
+            for (size_t id = 0; std::getline(ss, line); ++id) {
+                std::stringstream row(line);
+                std::string time, idn;
+                std::getline(row, time, ',');
+                std::getline(row, idn, ',');
+                REQUIRE(idn == std::to_string(id));
+            }
+        }
+    }
+}
+
+TEST_CASE("space filling curve reorder in a run") {
+    using System = hub::system::SimpleSystem<Particles, hub::force::Interactions<hub::force::NewtonianGrav>>;
+    using IAS15 = hub::ode::IAS15<hub::integrator::GaussRadau<Type>, hub::ode::MaxRatioError<Type>,
+                                  hub::ode::PIDController<Type>>;
+    using Simulator = hub::Simulator<System, IAS15>;
+    auto particle_set = jittered_lattice();
+
+    struct Run {
+        System sys;
+        size_t steps;
+        bool given_order;
+    };
+
+    auto run = [&](SpaceFillingCurve curve) {
+        Order::curve = curve;
+        Order::interval = 1;
+        size_t steps = 0;
+        bool given_order = true;
+        auto check_order = [&](auto const &ptc) {
+            for (size_t i = 0; i < ptc.number(); ++i) {
+                given_order &= (ptc.idn(i) == i && ptc.mass(i) == particle_set[i].mass);
+            }
+        };
+        typename Simulator::RunArgs args;
+        args.add_operation([&](auto &ptc, auto) { check_order(ptc), ++steps; });
+        args.add_stop_condition([&](auto &ptc, auto) {
+            check_order(ptc);
+            return false;
+        });
+        args.add_dense_operation(0.01, 0.14, 5, [&](auto &ptc, auto) { check_order(ptc); });
+        args.add_stop_condition(0.15);
+        Simulator sim{0, particle_set};
+        sim.run(args);
+        Order::curve = SpaceFillingCurve::None;
+        Order::interval = 64;
+        return Run{sim.particles(), steps, given_order};
+    };
+
+    auto plain = run(SpaceFillingCurve::None);
+    auto sorted = run(SpaceFillingCurve::Hilbert);
+    CAPTURE(plain.steps, sorted.steps);
+
+    SECTION("the prediction of IAS15 follows the particles") { REQUIRE(sorted.steps == plain.steps); }
+
+    SECTION("callbacks see the given order") {
+        REQUIRE(sorted.given_order);
+        for (size_t i = 0; i < sorted.sys.number(); ++i) {
+            REQUIRE(norm(sorted.sys.pos(i) - plain.sys.pos(i)) < 1e-10 * norm(plain.sys.pos(i)));
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/interaction/tidal.hpp"
+#include "../../src/particle-system/chain.hpp"
+#include "../../src/particles/tide-particles.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::TideParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+    using IdxArray = typename Type::IdxArray;
+
+    struct ChainedParticles : public Particles {
+        SPACEHUB_USING_TYPE_SYSTEM_OF(Particles);
+
+        explicit ChainedParticles(Particles const &ptc) : Particles(ptc) {
+            hub::Chain::calc_chain_index(this->pos(), idx_);
+            ch_pos_.resize(this->number());
+            hub::Chain::calc_chain(this->pos(), ch_pos_, idx_);
+            ch_vel_.resize(this->number());
+            hub::Chain::calc_chain(this->vel(), ch_vel_, idx_);
+        }
+
+        [[nodiscard]] VectorArray const &chain_pos() const { return ch_pos_; }
+
+        [[nodiscard]] VectorArray const &chain_vel() const { return ch_vel_; }
+
+        [[nodiscard]] IdxArray const &index() const { return idx_; }
+
+       private:
+        VectorArray ch_pos_;
+        VectorArray ch_vel_;
+        IdxArray idx_;
+    };
+
+    Particles random_tide_particles(size_t n, size_t active) {
+        Particles ptc;
+        for (size_t i = 0; i < n; ++i) {
+            auto k = i < active ? 0.1 : 0.0;
+            ptc.emplace_back(Particle{UTEST_RAND + 1.1, 0.01, k, 0.1 * (UTEST_RAND + 1.1), UTEST_RAND, UTEST_RAND,
+                                      UTEST_RAND, UTEST_RAND, UTEST_RAND, UTEST_RAND});
+        }
+        return ptc;
+    }
+
+    VectorArray direct_tidal_acc(Particles const &ptc) {
+        size_t n = ptc.number();
+        auto const &m = ptc.mass();
+        auto const &k = ptc.tide_apsidal_const();
+        auto const &tau = ptc.tide_lag_time();
+        auto const &rad = ptc.radius();
+
+        VectorArray acc(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (i != j && k[i] != 0) {
+                    auto dr = ptc.pos(j) - ptc.pos(i);
+                    auto dv = ptc.vel(j) - ptc.vel(i);
+                    auto r = norm(dr);
+                    auto coef = 3 * hub::consts::G * k[i] * pow(rad[i], 5) * m[j] * m[j] *
+                                (1 + 3 * tau[i] * dot(dv, dr) / (r * r)) / pow(r, 8);
+                    acc[i] += coef / m[i] * dr;
+                    acc[j] -= coef / m[j] * dr;
+                }
+            }
+        }
+        return acc;
+    }
+
+    template <typename Ptc>
+    void check_against_direct(Ptc const &ptc, VectorArray const &expected) {
+        VectorArray acc(ptc.number());
+        hub::force::Tidal::add_acc_to(ptc, acc);
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            auto scale = norm(expected[i]);
+            REQUIRE(acc[i].x == Approx(expected[i].x).margin(1e-12 * scale));
+            REQUIRE(acc[i].y == Approx(expected[i].y).margin(1e-12 * scale));
+            REQUIRE(acc[i].z == Approx(expected[i].z).margin(1e-12 * scale));
+        }
+    }
+}  // namespace
+
+TEST_CASE("tidal force") {
+    for (size_t active : std::initializer_list<size_t>{0, 1, 2, 7}) {
+        auto ptc = random_tide_particles(7, active);
+        auto expected = direct_tidal_acc(ptc);
+
+        SECTION("pairwise active=" + std::to_string(active)) { check_against_direct(ptc, expected); }
+
+        SECTION("chain active=" + std::to_string(active)) { check_against_direct(ChainedParticles{ptc}, expected); }
+    }
+}
@@ -0,0 +1,224 @@
+/*---------------------------------------------------------------------------*\
+        .-''''-.         |
+       /        \        |
+      /_        _\       |  SpaceHub: The Open Source N-body Toolkit
+     // \  <>  / \\      |
+     |\__\    /__/|      |  Website:  https://yihanwangastro.github.io/SpaceHub/
+      \    ||    /       |
+        \  __  /         |  Copyright (C) 2019 Yihan Wang
+         '.__.'          |
+---------------------------------------------------------------------
+License
+    This file is part of SpaceHub.
+    SpaceHub is free software: you can redistribute it and/or modify it under
+    the terms of the GPL-3.0 License. SpaceHub is distributed in the hope that it
+    will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+    of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GPL-3.0 License
+    for more details. You should have received a copy of the GPL-3.0 License along
+    with SpaceHub.
+\*---------------------------------------------------------------------------*/
+#include "../../src/interaction/fmm-grav.hpp"
+#include "../../src/interaction/tree-grav.hpp"
+#include "../../src/particles/point-particles.hpp"
+#include "../../src/type-class.hpp"
+#include "../catch.hpp"
+#include "utest.hpp"
+
+namespace {
+    using Type = hub::Types<utest_scalar>;
+    using Particles = hub::particles::PointParticles<Type>;
+    using Particle = typename Particles::Particle;
+    using VectorArray = typename Type::VectorArray;
+
+    struct RunParticles : public Particles {
+        RunParticles(Particles const &ptc, double rtol) : Particles(ptc), rtol_{rtol} {}
+
+        [[nodiscard]] double force_rtol() const { return rtol_; }
+
+       private:
+        double rtol_;
+    };
+
+    VectorArray direct_acc(Particles const &ptc) {
+        size_t n = ptc.number();
+        VectorArray acc(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                if (i != j) {
+                    auto dr = ptc.pos(j) - ptc.pos(i);
+                    auto r = norm(dr);
+                    acc[i] += dr * (ptc.mass(j) / (r * r * r));
+                }
+            }
+        }
+        return acc;
+    }
+
+    double mean_rel_err(VectorArray const &acc, VectorArray const &expected) {
+        double err = 0;
+        for (size_t i = 0; i < acc.size(); ++i) {
+            err += norm(acc[i] - expected[i]) / norm(expected[i]);
+        }
+        return err / acc.size();
+    }
+}  // namespace
+
+TEST_CASE("octree") {
+    auto ptc = utest_random_particles<Particle, Particles>(500);
+    hub::octree::Octree<double> tree;
+    tree.build(ptc.pos(), ptc.mass());
+
+    SECTION("moments") {
+        auto const &root = tree.nodes()[0];
+        double M = 0;
+        hub::Vec3<double> com{0, 0, 0};
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            M += ptc.mass(i);
+            com += ptc.pos(i) * ptc.mass(i);
+        }
+        com /= M;
+        REQUIRE(root.mass == Approx(M));
+        REQUIRE(root.com.x == Approx(com.x).margin(1e-12));
+        REQUIRE(root.com.y == Approx(com.y).margin(1e-12));
+        REQUIRE(root.com.z == Approx(com.z).margin(1e-12));
+        REQUIRE(root.quad[0] + root.quad[3] + root.quad[5] == Approx(0).margin(1e-10));
+    }
+
+    SECTION("every particle in one leaf") {
+        std::vector<size_t> count(ptc.number(), 0);
+        for (auto const &node : tree.nodes()) {
+            if (node.leaf) {
+                for (size_t k = node.begin; k < node.end; ++k) count[tree.order()[k]]++;
+            }
+        }
+        for (auto c : count) REQUIRE(c == 1);
+    }
+
+    SECTION("zero opening angle is direct summation") {
+        auto expected = direct_acc(ptc);
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            auto a = tree.acc(i, ptc.pos(), ptc.mass(), 0.0);
+            REQUIRE(norm(a - expected[i]) == Approx(0).margin(1e-12 * norm(expected[i])));
+        }
+    }
+}
+
+TEST_CASE("tree gravity") {
+    auto ptc = utest_random_particles<Particle, Particles>(hub::force::kernel::parallel_threshold + 100);
+    auto expected = direct_acc(ptc);
+
+    SECTION("opening angle") {
+        VectorArray acc_wide(ptc.number()), acc_narrow(ptc.number());
+
+        hub::force::TreeGrav::opening_angle = 0.6;
+        hub::force::TreeGrav::add_acc_to(ptc, acc_wide);
+
+        hub::force::TreeGrav::opening_angle = 0.3;
+        hub::force::TreeGrav::add_acc_to(ptc, acc_narrow);
+
+        REQUIRE(mean_rel_err(acc_narrow, expected) < 2e-3);
+        REQUIRE(mean_rel_err(acc_narrow, expected) < mean_rel_err(acc_wide, expected));
+    }
+
+    SECTION("refit after drift") {
+        hub::force::TreeGrav::opening_angle = 0.5;
+        VectorArray acc(ptc.number());
+        hub::force::TreeGrav::add_acc_to(ptc, acc);
+
+        for (size_t i = 0; i < ptc.number(); ++i) {
+            ptc.pos(i) += hub::Vec3<double>{UTEST_RAND, UTEST_RAND, UTEST_RAND} * 0.05;
+        }
+        expected = direct_acc(ptc);
+
+        acc = VectorArray(ptc.number());
+        hub::force::TreeGrav::add_acc_to(ptc, acc);
+        REQUIRE(mean_rel_err(acc, expected) < 1e-2);
+
+        hub::force::TreeGrav::opening_angle = 0;
+        acc = VectorArray(ptc.number());
+        hub::force::TreeGrav::add_acc_to(ptc, acc);
+        REQUIRE(mean_rel_err(acc, expected) < 1e-12);
+    }
+    hub::force::TreeGrav::opening_angle = 0.5;
+}
+
+TEST_CASE("fmm expansion") {
+    hub::force::fmm::Expansion expansion{4};
+    REQUIRE(expansion.size() == 35);
+
+    hub::Vec3<double> r{0.3, -0.7, 1.1};
+    std::vector<double> b(expansion.size());
+    expansion.derivatives(r, b.data());
+
+    double R = norm(r);
+    auto const &n = expansion.indices();
+    for (size_t t = 0; t < expansion.size(); ++t) {
+        auto [a, bb, c] = n[t];
+        if (a + bb + c == 0) {
+            REQUIRE(b[t] == Approx(1 / R));
+        } else if (a == 1 && bb + c == 0) {
+            REQUIRE(b[t] == Approx(-r.x / (R * R * R)));
+        } else if (a == 2 && bb + c == 0) {
+            REQUIRE(b[t] == Approx((3 * r.x * r.x / (R * R) - 1) / (2 * R * R * R)));
+        } else if (a == 1 && bb == 1 && c == 0) {
+            REQUIRE(b[t] == Approx(3 * r.x * r.y / (R * R * R * R * R)));
+        }
+    }
+}
+
+TEST_CASE("fmm gravity") {
+    auto ptc = utest_random_particles<Particle, Particles>(3000);
+    auto expected = direct_acc(ptc);
+
+    auto fmm_err = [&](size_t order, double theta) {
+        hub::force::FMMGrav::order = order;
+        hub::force::FMMGrav::opening_angle = theta;
+        VectorArray acc(ptc.number());
+        hub::force::FMMGrav::add_acc_to(ptc, acc);
+        return mean_rel_err(acc, expected);
+    };
+
+    SECTION("accuracy") { REQUIRE(fmm_err(6, 0.7) < 1e-3); }
+
+    SECTION("expansion order") {
+        REQUIRE(fmm_err(8, 0.5) < fmm_err(4, 0.5));
+        REQUIRE(fmm_err(4, 0.5) < fmm_err(2, 0.5));
+    }
+
+    SECTION("small N is direct summation") {
+        auto small = utest_random_particles<Particle, Particles>(hub::force::fmm::Evaluator<double>::leaf_capacity);
+        VectorArray acc(small.number());
+        hub::force::FMMGrav::add_acc_to(small, acc);
+        REQUIRE(mean_rel_err(acc, direct_acc(small)) < 1e-12);
+    }
+
+    SECTION("order from tolerance") {
+        hub::force::FMMGrav::opening_angle = 0.5;
+        REQUIRE(hub::force::FMMGrav::current_order(1e-3) == 9);
+        REQUIRE(hub::force::FMMGrav::current_order(1e-6) == hub::force::fmm::Expansion::max_order);
+        REQUIRE(hub::force::FMMGrav::current_order(0) == hub::force::FMMGrav::order);
+    }
+
+    SECTION("order from the tolerance of the run") {
+        auto ptc = utest_random_particles<Particle, Particles>(3);
+        RunParticles loose{ptc, 1e-3}, tight{ptc, 1e-6};
+        REQUIRE(hub::force::FMMGrav::current_tolerance(loose) == 1e-3);
+        REQUIRE(hub::force::FMMGrav::current_tolerance(tight) == 1e-6);
+        REQUIRE(hub::force::FMMGrav::current_tolerance(ptc) == 0);
+        hub::force::FMMGrav::tolerance = 1e-2;
+        REQUIRE(hub::force::FMMGrav::current_tolerance(loose) == 1e-2);
+        REQUIRE(hub::force::FMMGrav::current_tolerance(ptc) == 1e-2);
+        hub::force::FMMGrav::tolerance = 0;
+    }
+
+    SECTION("same accuracy below and above the parallel threshold") {
+        auto serial = utest_random_particles<Particle, Particles>(hub::force::kernel::parallel_threshold - 1);
+        VectorArray acc(serial.number());
+        hub::force::FMMGrav::order = 8;
+        hub::force::FMMGrav::opening_angle = 0.5;
+        hub::force::FMMGrav::add_acc_to(serial, acc);
+        REQUIRE(fmm_err(8, 0.5) < 10 * mean_rel_err(acc, direct_acc(serial)));
+    }
+    hub::force::FMMGrav::order = 6;
+    hub::force::FMMGrav::opening_angle = 0.7;
+}